@@ -10,15 +10,24 @@ namespace acoustics {
 AcousticsBuilder::AcousticsBuilder(bhc::bhcParams<true> &params,
                                    BathymetryConfig &bathConfig,
                                    SSPConfig &sspConfig,
-                                   AgentsConfig &agentsConfig, int numBeams,
-                                   double beamSpreadDeg, int maxBeams)
+                                   AgentsConfig &agentsConfig,
+                                   const BeamFanConfig &beams)
     : params_(params),
       bathymetryConfig_(std::move(bathConfig)),
       sspConfig_(std::move(sspConfig)),
       agentsConfig_(std::move(agentsConfig)),
-      numBeams_(numBeams),
-      maxBeams_(maxBeams > 0 ? maxBeams : numBeams),
-      beamSpreadRad_(beamSpreadDeg * kDegree2Radians){};
+      numBeams_(beams.numBeams),
+      maxBeams_{beams.maxBeams.elevation > 0 ? beams.maxBeams.elevation
+                                             : beams.numBeams.elevation,
+                beams.maxBeams.bearing > 0 ? beams.maxBeams.bearing
+                                           : beams.numBeams.bearing},
+      elevationSpreadRad_(beams.elevationSpreadDeg * kDegree2Radians),
+      bearingSpreadRad_(beams.bearingSpreadDeg * kDegree2Radians) {
+  // Angle arrays are allocated at maxBeams_ and filled at numBeams_
+  CHECK(numBeams_.elevation <= maxBeams_.elevation &&
+            numBeams_.bearing <= maxBeams_.bearing,
+        "Initial beam counts must not exceed their caps");
+};
 
 AgentsConfig &AcousticsBuilder::getAgentsConfig() { return agentsConfig_; };
 const SSPConfig &AcousticsBuilder::getSSPConfig() const { return sspConfig_; };
@@ -171,44 +180,28 @@ void AcousticsBuilder::checkReceiverInBox(const Eigen::Vector3d &sourcePos,
   }
 }
 
-void AcousticsBuilder::constructBeam(double bearingAngle) {
+void AcousticsBuilder::ensureBeamArrays() {
   params_.Angles->alpha.inDegrees = false;
   params_.Angles->beta.inDegrees = false;
-  Eigen::Vector3d delta = agentsConfig_.receiver - agentsConfig_.source;
-  double elevationAngle = utils::computeElevationAngle(delta);
   // On first call, allocate for maxBeams_ so iterative beam
   // refinement can increase numBeams_ without reallocating mid-simulation.
   if (!beamBuilt_) {
-    bhc::extsetup_raybearings(params_, maxBeams_);
-    bhc::extsetup_rayelevations(params_, maxBeams_);
+    bhc::extsetup_raybearings(params_, maxBeams_.bearing);
+    bhc::extsetup_rayelevations(params_, maxBeams_.elevation);
     beamBuilt_ = true;
   }
-  // Set the active beam count (may be less than allocated)
-  params_.Angles->beta.n = numBeams_;
-  params_.Angles->alpha.n = numBeams_;
-  utils::unsafeSetupVector(params_.Angles->beta.angles,
-                           bearingAngle - beamSpreadRad_,
-                           bearingAngle + beamSpreadRad_, numBeams_);
-  utils::unsafeSetupVector(params_.Angles->alpha.angles,
-                           elevationAngle - beamSpreadRad_,
-                           elevationAngle + beamSpreadRad_, numBeams_);
+}
 
+void AcousticsBuilder::applyBeamBox(const utils::BeamBoxParams &beamBox) {
   auto beam = params_.Beam;
-  constexpr double boxScale = 1.50;
   beam->rangeInKm = false;
   double kmScaler = bathymetryConfig_.isKm ? 1000.0 : 1.0;
-
-  auto beamBox = utils::computeBeamBox(delta, boxScale, kBeamStepSizeRatio);
   beam->deltas = beamBox.stepSize;
   CHECK(
       (beamBox.boxX > 0.0) || (beamBox.boxY > 0.0),
       fmt::format("Beam Box Size needs to be positive in bellhop box. Size is "
                   "deltaX: {}, deltaY: {}",
                   beamBox.boxX, beamBox.boxY));
-
-  // Beam box is centered around source coord sys. Reference bellhop docs
-  checkReceiverInBox(agentsConfig_.source, agentsConfig_.receiver, beamBox.boxX,
-                     beamBox.boxY);
   beam->Box.x = beamBox.boxX;
   beam->Box.y = beamBox.boxY;
   SPDLOG_TRACE("Beam box set to: x: {}, y: {}", beamBox.boxX, beamBox.boxY);
@@ -219,12 +212,250 @@ void AcousticsBuilder::constructBeam(double bearingAngle) {
   beam->Box.z = max * kmScaler + 10;
 }
 
-void AcousticsBuilder::rebuildBeam(int newNumBeams) {
+void AcousticsBuilder::constructBeam(double bearingAngle, BeamSubset subset) {
+  Eigen::Vector3d delta = agentsConfig_.receiver - agentsConfig_.source;
+  double elevationAngle = utils::computeElevationAngle(delta);
+  ensureBeamArrays();
+
+  // {offset, stride} into the level's linspace for each axis
+  int elevationOffset = 0;
+  int elevationStride = 1;
+  int bearingOffset = 0;
+  int bearingStride = 1;
+  switch (subset) {
+  case BeamSubset::kAll:
+    break;
+  case BeamSubset::kNewElevations:
+    elevationOffset = 1;
+    elevationStride = 2;
+    break;
+  case BeamSubset::kNewBearings:
+    elevationStride = 2;
+    bearingOffset = 1;
+    bearingStride = 2;
+    break;
+  case BeamSubset::kNewBearingsOnly:
+    bearingOffset = 1;
+    bearingStride = 2;
+    break;
+  }
+  // Strided axes must be a nested level (odd, at least 3)
+  auto isNestedLevel = [](int n, int stride) {
+    return stride == 1 || (n >= 3 && n % 2 == 1);
+  };
+  CHECK(isNestedLevel(numBeams_.elevation, elevationStride) &&
+            isNestedLevel(numBeams_.bearing, bearingStride),
+        fmt::format("Nested beam subsets need odd levels of at least 3 "
+                    "beams, got {} x {}",
+                    numBeams_.elevation, numBeams_.bearing));
+
+  // Set the active beam count (may be less than allocated)
+  params_.Angles->beta.n = utils::unsafeSetupStridedVector(
+      params_.Angles->beta.angles, bearingAngle - bearingSpreadRad_,
+      bearingAngle + bearingSpreadRad_, numBeams_.bearing, bearingOffset,
+      bearingStride);
+  params_.Angles->alpha.n = utils::unsafeSetupStridedVector(
+      params_.Angles->alpha.angles, elevationAngle - elevationSpreadRad_,
+      elevationAngle + elevationSpreadRad_, numBeams_.elevation,
+      elevationOffset, elevationStride);
+
+  auto beamBox =
+      utils::computeBeamBox(delta, kBeamBoxScale, kBeamStepSizeRatio);
+  // Beam box is centered around source coord sys. Reference bellhop docs
+  checkReceiverInBox(agentsConfig_.source, agentsConfig_.receiver, beamBox.boxX,
+                     beamBox.boxY);
+  applyBeamBox(beamBox);
+}
+
+AcousticsBuilder::FanAngles AcousticsBuilder::fanAngles(
+    const Eigen::Vector3d &source,
+    const std::vector<Eigen::Vector3d> &receivers) const {
+  CHECK(!receivers.empty(), "Fan beam requires at least one receiver");
+  // Bearings sorted so the largest circular gap can be found; the fan covers
+  // everything outside that gap.
+  std::vector<double> bearings;
+  bearings.reserve(receivers.size());
+  double minElevation = std::numeric_limits<double>::max();
+  double maxElevation = std::numeric_limits<double>::lowest();
+  for (const auto &receiver : receivers) {
+    Eigen::Vector3d delta = receiver - source;
+    bearings.push_back(std::atan2(delta(1), delta(0)));
+    double elevation = utils::computeElevationAngle(delta);
+    minElevation = std::min(minElevation, elevation);
+    maxElevation = std::max(maxElevation, elevation);
+  }
+  std::sort(bearings.begin(), bearings.end());
+  double largestGap = bearings.front() + 2.0 * M_PI - bearings.back();
+  double arcStart = bearings.front();
+  for (size_t i = 1; i < bearings.size(); ++i) {
+    double gap = bearings[i] - bearings[i - 1];
+    if (gap > largestGap) {
+      largestGap = gap;
+      arcStart = bearings[i];
+    }
+  }
+  FanAngles fan{};
+  fan.bearingLow = arcStart - bearingSpreadRad_;
+  fan.bearingSpan = 2.0 * M_PI - largestGap + 2.0 * bearingSpreadRad_;
+  if (fan.bearingSpan >= 2.0 * M_PI) {
+    fan.bearingSpan = 2.0 * M_PI;
+  }
+  fan.elevationLow =
+      std::max(minElevation - elevationSpreadRad_, -kMaxFanElevationRad);
+  fan.elevationHigh =
+      std::min(maxElevation + elevationSpreadRad_, kMaxFanElevationRad);
+
+  // Keep the angular density of a single-receiver fan of numBeams_. Callers
+  // keep targets within fanTargetSpanRad(), so this never needs clamping.
+  auto beamsFor = [](double span, int numBeams, int maxBeams,
+                     double spreadRad) {
+    double perRad = static_cast<double>(numBeams) / (2.0 * spreadRad);
+    // Tolerance absorbs rounding at exactly the widest allowed span
+    int n = static_cast<int>(std::ceil(span * perRad - 1e-9));
+    CHECK(n <= maxBeams,
+          fmt::format("Fan targets need {} beams on an axis, more than the "
+                      "{} allocated; keep them within fanTargetSpanRad()",
+                      n, maxBeams));
+    return std::max(n, numBeams);
+  };
+  fan.beams.bearing = beamsFor(fan.bearingSpan, numBeams_.bearing,
+                               maxBeams_.bearing, bearingSpreadRad_);
+  fan.beams.elevation =
+      beamsFor(fan.elevationHigh - fan.elevationLow, numBeams_.elevation,
+               maxBeams_.elevation, elevationSpreadRad_);
+  return fan;
+}
+
+BeamCounts AcousticsBuilder::fanBeamCounts(
+    const Eigen::Vector3d &source,
+    const std::vector<Eigen::Vector3d> &receivers) const {
+  return fanAngles(source, receivers).beams;
+}
+
+void AcousticsBuilder::constructFanBeam() {
+  CHECK(!fanReceivers_.empty(), "Fan beam requires at least one receiver");
+  ensureBeamArrays();
+  const Eigen::Vector3d &source = agentsConfig_.source;
+
+  utils::BeamBoxParams beamBox{0.0, 0.0, std::numeric_limits<double>::max()};
+  for (const auto &receiver : fanReceivers_) {
+    // Box must reach the farthest receiver, step size is set by the nearest
+    auto receiverBox = utils::computeBeamBox(receiver - source, kBeamBoxScale,
+                                             kBeamStepSizeRatio);
+    beamBox.boxX = std::max(beamBox.boxX, receiverBox.boxX);
+    beamBox.boxY = std::max(beamBox.boxY, receiverBox.boxY);
+    beamBox.stepSize = std::min(beamBox.stepSize, receiverBox.stepSize);
+  }
+
+  const auto fan = fanAngles(source, fanReceivers_);
+  params_.Angles->beta.n = fan.beams.bearing;
+  params_.Angles->alpha.n = fan.beams.elevation;
+  utils::unsafeSetupVector(params_.Angles->beta.angles, fan.bearingLow,
+                           fan.bearingLow + fan.bearingSpan, fan.beams.bearing);
+  utils::unsafeSetupVector(params_.Angles->alpha.angles, fan.elevationLow,
+                           fan.elevationHigh, fan.beams.elevation);
+  SPDLOG_TRACE("Fan beam over {} receivers: {} bearings x {} elevations",
+               fanReceivers_.size(), fan.beams.bearing, fan.beams.elevation);
+
+  for (const auto &receiver : fanReceivers_) {
+    checkReceiverInBox(source, receiver, beamBox.boxX, beamBox.boxY);
+  }
+  applyBeamBox(beamBox);
+}
+
+BellhopMemoryEstimate
+AcousticsBuilder::estimateMemory(const SSPConfig &ssp,
+                                 const BathymetryConfig &bathymetry,
+                                 const BeamFanConfig &beams,
+                                 const BellhopMemoryDemand &demand) {
+  BellhopMemoryEstimate estimate{};
+
+  // Hexahedral SSP: sound speed and its depth derivative at every node, plus
+  // the three axes. Boundaries: one full point per bathymetry node and per
+  // flat altimetry corner.
+  const auto &sspGrid = ssp.Grid;
+  const size_t sspNodes = sspGrid.nx() * sspGrid.ny() * sspGrid.nz();
+  const size_t sspAxes = sspGrid.nx() + sspGrid.ny() + sspGrid.nz();
+  const size_t boundaryPoints =
+      bathymetry.Grid.nx() * bathymetry.Grid.ny() +
+      static_cast<size_t>(kNumAltimetryPts) * kNumAltimetryPts;
+  estimate.environmentBytes = (2 * sspNodes + sspAxes) * sizeof(bhc::real) +
+                              boundaryPoints * sizeof(bhc::BdryPtFull<true>);
+
+  const int maxElevation = beams.maxBeams.elevation > 0
+                               ? beams.maxBeams.elevation
+                               : beams.numBeams.elevation;
+  const int maxBearing = beams.maxBeams.bearing > 0 ? beams.maxBeams.bearing
+                                                    : beams.numBeams.bearing;
+  estimate.beamBytes =
+      static_cast<size_t>(maxElevation + maxBearing) * sizeof(bhc::real);
+
+  // Worst case for a fan-out: every target on its own range, depth and
+  // bearing, see updateSourceAndReceivers()
+  const size_t targets = std::max<size_t>(demand.maxTargets, 1);
+  estimate.receivers = targets * targets * targets;
+  estimate.receiverBytes = 3 * estimate.receivers * sizeof(bhc::real);
+
+  estimate.arrivalsPerReceiver =
+      std::max<size_t>(demand.arrivalsPerReceiver, 1);
+  estimate.arrivalBytes =
+      estimate.receivers * (estimate.arrivalsPerReceiver *
+                                sizeof(bhc::Arrival) +
+                            sizeof(int32_t)) +
+      kNumSources * sizeof(int32_t);
+  return estimate;
+}
+
+double AcousticsBuilder::fanTargetSpanRad(int numBeams, int maxBeams,
+                                          double spreadRad) {
+  CHECK(numBeams > 0 && maxBeams >= numBeams && spreadRad > 0.0,
+        "Fan span needs positive beams, max >= initial, and a positive spread");
+  // The fan covers the targets plus one spread either side at numBeams per
+  // 2 * spread, and may use at most maxBeams
+  return 2.0 * spreadRad *
+         (static_cast<double>(maxBeams) / static_cast<double>(numBeams) - 1.0);
+}
+
+void AcousticsBuilder::rebuildBeam(const BeamCounts &newNumBeams,
+                                   BeamSubset subset) {
+  CHECK(newNumBeams.elevation <= maxBeams_.elevation &&
+            newNumBeams.bearing <= maxBeams_.bearing,
+        "Beam counts exceed the pre-allocated maximum");
   numBeams_ = newNumBeams;
+  if (!fanReceivers_.empty()) {
+    CHECK(subset == BeamSubset::kAll,
+          "Multi-receiver fans can only be rebuilt whole");
+    constructFanBeam();
+    return;
+  }
   auto delta = agentsConfig_.receiver(Eigen::seq(0, 1)) -
                agentsConfig_.source(Eigen::seq(0, 1));
   double bearingAngle = std::atan2(delta(1), delta(0));
-  constructBeam(bearingAngle);
+  constructBeam(bearingAngle, subset);
+}
+
+void AcousticsBuilder::zoomBeam(double halfWidthRad) {
+  CHECK(fanReceivers_.empty(), "Only single-receiver fans can be zoomed");
+  CHECK(halfWidthRad > 0.0, "Zoomed fan needs a positive half-width");
+  ensureBeamArrays();
+  Eigen::Vector3d delta = agentsConfig_.receiver - agentsConfig_.source;
+  double elevationRad = utils::computeElevationAngle(delta);
+  double bearingRad = std::atan2(delta(1), delta(0));
+  // Keep the fan off the vertical, where bearings collapse
+  double elevationLow = std::max(elevationRad - halfWidthRad,
+                                 -kMaxFanElevationRad);
+  double elevationHigh = std::min(elevationRad + halfWidthRad,
+                                  kMaxFanElevationRad);
+  params_.Angles->alpha.n = numBeams_.elevation;
+  params_.Angles->beta.n = numBeams_.bearing;
+  utils::unsafeSetupVector(params_.Angles->alpha.angles, elevationLow,
+                           elevationHigh, numBeams_.elevation);
+  utils::unsafeSetupVector(params_.Angles->beta.angles,
+                           bearingRad - halfWidthRad, bearingRad + halfWidthRad,
+                           numBeams_.bearing);
+  SPDLOG_TRACE("Zoomed fan: elevation [{:.3f}, {:.3f}] rad, bearing {:.3f} "
+               "+/- {:.4f} rad",
+               elevationLow, elevationHigh, bearingRad, halfWidthRad);
 }
 
 std::pair<double, bool>
@@ -240,48 +471,61 @@ AcousticsBuilder::isWithinBathymetry(const Eigen::Vector3d &position) const {
   return {bathymetryHeight, false};
 }
 
-BoundaryCheck AcousticsBuilder::updateAgents() {
-  if (!agentsBuilt_) {
-    throw std::runtime_error(
-        "Cannot update agents: Agents have not been built yet.");
+void AcousticsBuilder::resizeReceivers(int32_t nRanges, int32_t nDepths,
+                                       int32_t nBearings) {
+  // Arrays only grow, like the beam arrays, so alternating between single
+  // links and multi-receiver runs reuses one allocation per axis
+  if (nRanges > receiverCapacity_[0]) {
+    SPDLOG_DEBUG("Reallocating receiver ranges: {} -> {}",
+                 receiverCapacity_[0], nRanges);
+    bhc::extsetup_rcvrranges(params_, nRanges);
+    receiverCapacity_[0] = nRanges;
   }
-  bool isReceiverCountIdentical = params_.Pos->NRr == kNumRecievers;
-  if (!isReceiverCountIdentical) {
-    SPDLOG_DEBUG("Reallocating receiver arrays for updated agents.\n");
-    bhc::extsetup_rcvrranges(params_, kNumRecievers);
-    bhc::extsetup_rcvrbearings(params_, kNumRecievers);
-    bhc::extsetup_rcvrdepths(params_, kNumRecievers);
-    params_.Pos->NRr = kNumRecievers;
-    params_.Pos->NRz = kNumRecievers;
-    params_.Pos->Ntheta = kNumRecievers;
+  if (nDepths > receiverCapacity_[1]) {
+    SPDLOG_DEBUG("Reallocating receiver depths: {} -> {}",
+                 receiverCapacity_[1], nDepths);
+    bhc::extsetup_rcvrdepths(params_, nDepths);
+    receiverCapacity_[1] = nDepths;
   }
+  if (nBearings > receiverCapacity_[2]) {
+    SPDLOG_DEBUG("Reallocating receiver bearings: {} -> {}",
+                 receiverCapacity_[2], nBearings);
+    bhc::extsetup_rcvrbearings(params_, nBearings);
+    receiverCapacity_[2] = nBearings;
+  }
+  params_.Pos->NRr = nRanges;
+  params_.Pos->NRz = nDepths;
+  params_.Pos->Ntheta = nBearings;
+}
 
+BoundaryCheck
+AcousticsBuilder::checkAgentBounds(const Eigen::Vector3d &source,
+                                   const Eigen::Vector3d &receiver) const {
   bool isSourceInBounds =
-      utils::positionInBounds(agentsConfig_.source, minCoords_, maxCoords_);
+      utils::positionInBounds(source, minCoords_, maxCoords_);
   bool isReceiverInBounds =
-      utils::positionInBounds(agentsConfig_.receiver, minCoords_, maxCoords_);
+      utils::positionInBounds(receiver, minCoords_, maxCoords_);
 
   if (!isSourceInBounds || !isReceiverInBounds) {
     auto msg = fmt::format(
         "Source or Receiver position is out of bounds of the simulation box. "
         "Source: ({}) , Receiver: ({}) , Min Box: ({}) , Max Box: ({})",
-        agentsConfig_.source.transpose(), agentsConfig_.receiver.transpose(),
-        minCoords_.transpose(), maxCoords_.transpose());
+        source.transpose(), receiver.transpose(), minCoords_.transpose(),
+        maxCoords_.transpose());
     SPDLOG_WARN(msg);
     return BoundaryCheck::kEitherOrOutOfBounds;
   }
-  auto [bathymetryHeight, isReceiverWithinBath] =
-      isWithinBathymetry(agentsConfig_.receiver);
+  auto [bathymetryHeight, isReceiverWithinBath] = isWithinBathymetry(receiver);
   if (!isReceiverWithinBath) {
     auto msg =
         fmt::format("Current receiver position is below the bathymetry "
                     "and therefore should be marked as dead. Receiver z-height "
                     "is {:4f}, while bathymetry interpolated value is {:4f}",
-                    agentsConfig_.receiver.z(), bathymetryHeight);
+                    receiver.z(), bathymetryHeight);
     SPDLOG_WARN(msg);
     return BoundaryCheck::kReceiverOutofBounds;
   }
-  auto result = isWithinBathymetry(agentsConfig_.source);
+  auto result = isWithinBathymetry(source);
   bool isSourceWithinBath = result.second;
   bathymetryHeight = result.first;
   if (!isSourceWithinBath) {
@@ -289,10 +533,31 @@ BoundaryCheck AcousticsBuilder::updateAgents() {
         fmt::format("Current source position is below the bathymetry "
                     "and therefore should be marked as dead. Source z-height "
                     "is {:4f}, while bathymetry interpolated value is {:4f}",
-                    agentsConfig_.source.z(), bathymetryHeight);
+                    source.z(), bathymetryHeight);
     SPDLOG_WARN(msg);
     return BoundaryCheck::kSourceOutofBounds;
   }
+  return BoundaryCheck::kInBounds;
+}
+
+BoundaryCheck AcousticsBuilder::updateAgents() {
+  if (!agentsBuilt_) {
+    throw std::runtime_error(
+        "Cannot update agents: Agents have not been built yet.");
+  }
+  auto boundary =
+      checkAgentBounds(agentsConfig_.source, agentsConfig_.receiver);
+  if (boundary != BoundaryCheck::kInBounds) {
+    return boundary;
+  }
+
+  // Leave any multi-receiver layout from updateSourceAndReceivers()
+  resizeReceivers(kNumRecievers, kNumRecievers, kNumRecievers);
+  params_.Beam->RunType[0] = kRunTypeArrivals;
+  params_.Beam->RunType[4] = kReceiverGridIrregular;
+  params_.Pos->NRz_per_range = kNumRecievers;
+  fanReceivers_.clear();
+  receiverIndices_.assign(1, ReceiverIndex{});
 
   // no smart checking, everything is overwritten
   params_.Pos->RrInKm = false;
@@ -322,6 +587,7 @@ void AcousticsBuilder::buildAgents() {
   bhc::extsetup_rcvrranges(params_, static_cast<int32_t>(nReceivers));
   bhc::extsetup_rcvrbearings(params_, static_cast<int32_t>(nReceivers));
   bhc::extsetup_rcvrdepths(params_, static_cast<int32_t>(nReceivers));
+  receiverCapacity_.fill(static_cast<int32_t>(nReceivers));
   agentsBuilt_ = true;
   // Assigning receiver ranges for update check to prevent reallocation
   params_.Pos->RrInKm = false;
@@ -368,6 +634,115 @@ void AcousticsBuilder::build() {
   buildAgents();
 };
 
+EnvironmentSnapshot AcousticsBuilder::snapshot() const {
+  if (!bathymetryBuilt_ || !agentsBuilt_) {
+    throw std::runtime_error(
+        "Cannot snapshot environment: Simulation has not been built yet.");
+  }
+  EnvironmentSnapshot snap{
+      BathymetryConfig{bathymetryConfig_.Grid.clone(),
+                       bathymetryConfig_.interpolation,
+                       bathymetryConfig_.isKm},
+      SSPConfig{sspConfig_.Grid.clone(), sspConfig_.isKm},
+      AgentsConfig{agentsConfig_.source, agentsConfig_.receiver},
+  };
+  snap.beams = BeamFanConfig{numBeams_, maxBeams_, getElevationSpreadDeg(),
+                             getBearingSpreadDeg()};
+  snap.minCoords = minCoords_;
+  snap.maxCoords = maxCoords_;
+
+  std::copy_n(params_.Beam->RunType, snap.runType.size(),
+              snap.runType.begin());
+  std::copy_n(params_.Title, snap.title.size(), snap.title.begin());
+
+  const auto &bot = params_.bdinfo->bot;
+  snap.bathymetryNPts = bot.NPts;
+  std::copy_n(bot.type, snap.bathymetryType.size(),
+              snap.bathymetryType.begin());
+  snap.bathymetryInKm = bot.rangeInKm;
+  snap.bathymetryPts.assign(bot.bd, bot.bd + bathymetryConfig_.Grid.size());
+
+  const auto &top = params_.bdinfo->top;
+  snap.altimetryNPts = top.NPts;
+  snap.altimetryInKm = top.rangeInKm;
+  snap.altimetryPts.assign(top.bd,
+                           top.bd + kNumAltimetryPts * kNumAltimetryPts);
+
+  const auto &ssp = *params_.ssp;
+  snap.sspNx = ssp.Nx;
+  snap.sspNy = ssp.Ny;
+  snap.sspNz = ssp.Nz;
+  snap.sspInKm = ssp.rangeInKm;
+  snap.sspX.assign(ssp.Seg.x, ssp.Seg.x + ssp.Nx);
+  snap.sspY.assign(ssp.Seg.y, ssp.Seg.y + ssp.Ny);
+  snap.sspZ.assign(ssp.Seg.z, ssp.Seg.z + ssp.Nz);
+  snap.sspC.assign(ssp.cMat, ssp.cMat + sspConfig_.Grid.size());
+
+  snap.topDepth = params_.Bdry->Top.hs.Depth;
+  snap.bottomDepth = params_.Bdry->Bot.hs.Depth;
+  return snap;
+}
+
+std::unique_ptr<AcousticsBuilder>
+AcousticsBuilder::fromSnapshot(bhc::bhcParams<true> &params,
+                               const EnvironmentSnapshot &snapshot) {
+  BathymetryConfig bathConfig{snapshot.bathymetry.Grid.clone(),
+                              snapshot.bathymetry.interpolation,
+                              snapshot.bathymetry.isKm};
+  SSPConfig sspConfig{snapshot.ssp.Grid.clone(), snapshot.ssp.isKm};
+  AgentsConfig agentsConfig{snapshot.agents.source, snapshot.agents.receiver};
+  auto builder = std::make_unique<AcousticsBuilder>(
+      params, bathConfig, sspConfig, agentsConfig, snapshot.beams);
+  builder->buildFromSnapshot(snapshot);
+  return builder;
+}
+
+void AcousticsBuilder::buildFromSnapshot(const EnvironmentSnapshot &snapshot) {
+  std::copy(snapshot.runType.begin(), snapshot.runType.end(),
+            params_.Beam->RunType);
+  std::copy(snapshot.title.begin(), snapshot.title.end(), params_.Title);
+
+  bhc::extsetup_bathymetry(params_, snapshot.bathymetryNPts, kNumProvince);
+  auto &bot = params_.bdinfo->bot;
+  bot.dirty = true;
+  bot.rangeInKm = snapshot.bathymetryInKm;
+  bot.NPts = snapshot.bathymetryNPts;
+  std::copy(snapshot.bathymetryType.begin(), snapshot.bathymetryType.end(),
+            bot.type);
+  std::copy(snapshot.bathymetryPts.begin(), snapshot.bathymetryPts.end(),
+            bot.bd);
+  bathymetryBuilt_ = true;
+
+  bhc::extsetup_altimetry(params_, snapshot.altimetryNPts);
+  auto &top = params_.bdinfo->top;
+  top.dirty = true;
+  top.rangeInKm = snapshot.altimetryInKm;
+  top.NPts = snapshot.altimetryNPts;
+  std::copy(snapshot.altimetryPts.begin(), snapshot.altimetryPts.end(),
+            top.bd);
+
+  bhc::extsetup_ssp_hexahedral(params_, snapshot.sspNx, snapshot.sspNy,
+                               snapshot.sspNz);
+  auto &ssp = *params_.ssp;
+  ssp.dirty = true;
+  ssp.Nx = snapshot.sspNx;
+  ssp.Ny = snapshot.sspNy;
+  ssp.Nz = snapshot.sspNz;
+  ssp.NPts = snapshot.sspNz;
+  ssp.rangeInKm = snapshot.sspInKm;
+  std::copy(snapshot.sspX.begin(), snapshot.sspX.end(), ssp.Seg.x);
+  std::copy(snapshot.sspY.begin(), snapshot.sspY.end(), ssp.Seg.y);
+  std::copy(snapshot.sspZ.begin(), snapshot.sspZ.end(), ssp.Seg.z);
+  std::copy(snapshot.sspZ.begin(), snapshot.sspZ.end(), ssp.z);
+  std::copy(snapshot.sspC.begin(), snapshot.sspC.end(), ssp.cMat);
+
+  params_.Bdry->Top.hs.Depth = snapshot.topDepth;
+  params_.Bdry->Bot.hs.Depth = snapshot.bottomDepth;
+  minCoords_ = snapshot.minCoords;
+  maxCoords_ = snapshot.maxCoords;
+  buildAgents();
+}
+
 void AcousticsBuilder::flatAltimetery3D(bhc::BdryInfoTopBot<true> &boundary,
                                         const BathymetryConfig &bathConfig) {
   boundary.dirty = true;
@@ -435,4 +810,176 @@ BoundaryCheck AcousticsBuilder::updateSource(double x, double y, double z) {
   return updateAgents();
 }
 
+BoundaryCheck
+AcousticsBuilder::updateSourceAndReceiver(const Eigen::Vector3d &source,
+                                          const Eigen::Vector3d &receiver) {
+  agentsConfig_.source = source;
+  agentsConfig_.receiver = receiver;
+  return updateAgents();
+}
+
+BoundaryCheck AcousticsBuilder::updateSourceAndReceivers(
+    const Eigen::Vector3d &source,
+    const std::vector<Eigen::Vector3d> &receivers) {
+  CHECK(!receivers.empty(), "At least one receiver is required");
+  if (receivers.size() == 1) {
+    return updateSourceAndReceiver(source, receivers.front());
+  }
+  if (!agentsBuilt_) {
+    throw std::runtime_error(
+        "Cannot update agents: Agents have not been built yet.");
+  }
+  for (const auto &receiver : receivers) {
+    auto boundary = checkAgentBounds(source, receiver);
+    if (boundary != BoundaryCheck::kInBounds) {
+      return boundary;
+    }
+  }
+  agentsConfig_.source = source;
+  agentsConfig_.receiver = receivers.front();
+
+  // Bellhop needs monotonic receiver axes, so each axis holds the sorted
+  // unique values and every receiver is mapped back to its grid cell.
+  std::vector<double> ranges;
+  std::vector<float> depths;
+  std::vector<double> bearings;
+  ranges.reserve(receivers.size());
+  depths.reserve(receivers.size());
+  bearings.reserve(receivers.size());
+  for (const auto &receiver : receivers) {
+    Eigen::Vector2d delta = receiver.head(2) - source.head(2);
+    ranges.push_back(delta.norm());
+    depths.push_back(utils::safeDoubleToFloat(receiver(2)));
+    bearings.push_back(std::atan2(delta(1), delta(0)) * kRadians2Degree);
+  }
+  auto sortedUnique = [](auto values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+  };
+  auto rangeAxis = sortedUnique(ranges);
+  auto depthAxis = sortedUnique(depths);
+  auto bearingAxis = sortedUnique(bearings);
+  auto indexOf = [](const auto &axis, auto value) {
+    auto it = std::lower_bound(axis.begin(), axis.end(), value);
+    return static_cast<int32_t>(std::distance(axis.begin(), it));
+  };
+  receiverIndices_.resize(receivers.size());
+  for (size_t i = 0; i < receivers.size(); ++i) {
+    receiverIndices_[i].itheta = indexOf(bearingAxis, bearings[i]);
+    receiverIndices_[i].iz = indexOf(depthAxis, depths[i]);
+    receiverIndices_[i].ir = indexOf(rangeAxis, ranges[i]);
+  }
+
+  resizeReceivers(static_cast<int32_t>(rangeAxis.size()),
+                  static_cast<int32_t>(depthAxis.size()),
+                  static_cast<int32_t>(bearingAxis.size()));
+  params_.Beam->RunType[0] = kRunTypeArrivals;
+  params_.Beam->RunType[4] = kReceiverGridRectilinear;
+  params_.Pos->NRz_per_range = params_.Pos->NRz;
+  params_.Pos->RrInKm = false;
+  params_.Pos->Sx[0] = source(0);
+  params_.Pos->Sy[0] = source(1);
+  params_.Pos->Sz[0] = utils::safeDoubleToFloat(source(2));
+  std::copy(rangeAxis.begin(), rangeAxis.end(), params_.Pos->Rr);
+  std::copy(depthAxis.begin(), depthAxis.end(), params_.Pos->Rz);
+  std::copy(bearingAxis.begin(), bearingAxis.end(), params_.Pos->theta);
+
+  fanReceivers_ = receivers;
+  constructFanBeam();
+  return BoundaryCheck::kInBounds;
+}
+
+void AcousticsBuilder::constructAllAroundBeam(double maxRangeM) {
+  // All-around fan at the allocated ceiling, so no receiver falls between
+  // rays more than it would at full refinement
+  ensureBeamArrays();
+  params_.Angles->beta.n = maxBeams_.bearing;
+  params_.Angles->alpha.n = maxBeams_.elevation;
+  utils::unsafeSetupVector(params_.Angles->beta.angles, -M_PI, M_PI,
+                           maxBeams_.bearing);
+  utils::unsafeSetupVector(params_.Angles->alpha.angles, -kMaxFanElevationRad,
+                           kMaxFanElevationRad, maxBeams_.elevation);
+  const double boxSize = kBeamBoxScale * maxRangeM;
+  applyBeamBox(utils::BeamBoxParams{boxSize, boxSize,
+                                    maxRangeM * kBeamStepSizeRatio});
+}
+
+BoundaryCheck
+AcousticsBuilder::updateSourceForRayFan(const Eigen::Vector3d &source,
+                                        double maxRangeM) {
+  CHECK(maxRangeM > 0.0, "Ray fan range must be positive");
+  if (!agentsBuilt_) {
+    throw std::runtime_error(
+        "Cannot update agents: Agents have not been built yet.");
+  }
+  auto boundary = checkAgentBounds(source, source);
+  if (boundary != BoundaryCheck::kInBounds) {
+    return boundary;
+  }
+  agentsConfig_.source = source;
+  params_.Pos->Sx[0] = source(0);
+  params_.Pos->Sy[0] = source(1);
+  params_.Pos->Sz[0] = utils::safeDoubleToFloat(source(2));
+  params_.Beam->RunType[0] = kRunTypeRays;
+  constructAllAroundBeam(maxRangeM);
+  return BoundaryCheck::kInBounds;
+}
+
+BoundaryCheck AcousticsBuilder::updateSourceAndReceiverGrid(
+    const Eigen::Vector3d &source, const std::vector<double> &ranges,
+    const std::vector<double> &depths, const std::vector<double> &bearingsDeg) {
+  CHECK(!ranges.empty() && !depths.empty() && !bearingsDeg.empty(),
+        "Receiver grid needs at least one value per axis");
+  CHECK(utils::isMonotonicallyIncreasing(ranges) &&
+            utils::isMonotonicallyIncreasing(depths) &&
+            utils::isMonotonicallyIncreasing(bearingsDeg),
+        "Receiver grid axes must be increasing");
+  if (!agentsBuilt_) {
+    throw std::runtime_error(
+        "Cannot update agents: Agents have not been built yet.");
+  }
+  // Cells outside the domain simply get no arrivals
+  auto boundary = checkAgentBounds(source, source);
+  if (boundary != BoundaryCheck::kInBounds) {
+    return boundary;
+  }
+  agentsConfig_.source = source;
+  agentsConfig_.receiver = source + Eigen::Vector3d{ranges.back(), 0.0, 0.0};
+
+  const auto nRanges = static_cast<int32_t>(ranges.size());
+  const auto nDepths = static_cast<int32_t>(depths.size());
+  const auto nBearings = static_cast<int32_t>(bearingsDeg.size());
+  receiverIndices_.clear();
+  receiverIndices_.reserve(ranges.size() * depths.size() * bearingsDeg.size());
+  for (int32_t itheta = 0; itheta < nBearings; ++itheta) {
+    for (int32_t iz = 0; iz < nDepths; ++iz) {
+      for (int32_t ir = 0; ir < nRanges; ++ir) {
+        receiverIndices_.push_back(ReceiverIndex{itheta, iz, ir});
+      }
+    }
+  }
+
+  resizeReceivers(nRanges, nDepths, nBearings);
+  params_.Beam->RunType[4] = kReceiverGridRectilinear;
+  params_.Pos->NRz_per_range = nDepths;
+  params_.Pos->RrInKm = false;
+  params_.Pos->Sx[0] = source(0);
+  params_.Pos->Sy[0] = source(1);
+  params_.Pos->Sz[0] = utils::safeDoubleToFloat(source(2));
+  std::copy(ranges.begin(), ranges.end(), params_.Pos->Rr);
+  std::transform(depths.begin(), depths.end(), params_.Pos->Rz,
+                 [](double z) { return utils::safeDoubleToFloat(z); });
+  std::copy(bearingsDeg.begin(), bearingsDeg.end(), params_.Pos->theta);
+  params_.Beam->RunType[0] = kRunTypeArrivals;
+  fanReceivers_.clear();
+
+  constructAllAroundBeam(ranges.back());
+  SPDLOG_DEBUG("Receiver grid: {} ranges x {} depths x {} bearings, {} x {} "
+               "rays",
+               nRanges, nDepths, nBearings, maxBeams_.bearing,
+               maxBeams_.elevation);
+  return BoundaryCheck::kInBounds;
+}
+
 } // namespace acoustics
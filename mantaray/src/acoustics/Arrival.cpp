@@ -28,12 +28,18 @@ inline size_t GetFieldAddr(int32_t isx, int32_t isy, int32_t isz,
 
 Arrival::Arrival(bhc::bhcParams<true> &in_params,
                  bhc::bhcOutputs<true, true> &outputs)
-    : inputs(in_params), outputs(outputs) {
-  if (!outputs.arrinfo) {
+    : Arrival(in_params.Pos, outputs.arrinfo) {}
+
+Arrival::Arrival(bhc::bhcParams<false> &in_params,
+                 bhc::bhcOutputs<false, false> &outputs)
+    : Arrival(in_params.Pos, outputs.arrinfo) {}
+
+Arrival::Arrival(const bhc::Position *pos, bhc::ArrInfo *info)
+    : positions(pos), arrInfo(info) {
+  if (!arrInfo) {
     throw std::invalid_argument("Arrival received null pointer to ArrInfo");
   }
-  this->arrInfo = outputs.arrinfo;
-  if (!inputs.Pos) {
+  if (!positions) {
     throw std::invalid_argument(
         "Arrival.extractEarliestArrivals received null pointer to Position");
   }
@@ -48,7 +54,7 @@ Arrival::Arrival(bhc::bhcParams<true> &in_params,
         "Arrival.extractEarliestArrivals received null pointer to Arr");
   }
   // guarding for more than one source, don't support this
-  if (inputs.Pos->NSx > 1 || inputs.Pos->NSy > 1 || inputs.Pos->NSz > 1) {
+  if (positions->NSx > 1 || positions->NSy > 1 || positions->NSz > 1) {
     throw std::invalid_argument(
         "Arrival.extractEarliestArrivals only supports single source");
   }
@@ -66,8 +72,20 @@ std::string Arrival::printReceiverInfo(const bhc::Position *Pos, int32_t ir,
   return output;
 }
 
+size_t Arrival::getReceiverCount() const {
+  return static_cast<size_t>(positions->NRr) * positions->NRz_per_range *
+         positions->Ntheta;
+}
+
+int32_t Arrival::getPeakArrivalCount() const {
+  const size_t receivers = getReceiverCount();
+  return receivers == 0
+             ? 0
+             : *std::max_element(arrInfo->NArr, arrInfo->NArr + receivers);
+}
+
 size_t Arrival::getIdx(size_t ir, size_t iz, size_t itheta) const {
-  return (ir * inputs.Pos->NRz_per_range + iz) * inputs.Pos->Ntheta + itheta;
+  return (ir * positions->NRz_per_range + iz) * positions->Ntheta + itheta;
 }
 
 /*
@@ -94,79 +112,74 @@ size_t Arrival::getIdx(size_t ir, size_t iz, size_t itheta) const {
  * Memory layout uses a flattened 1D array where MaxNArr is the maximum
  * arrivals per location.
  */
-ArrivalPair Arrival::getFastestArrivals() {
-  const bhc::Position *Pos = inputs.Pos;
+std::vector<ArrivalPair>
+Arrival::getFastestArrivals(const std::vector<ReceiverIndex> &receivers) const {
+  const bhc::Position *Pos = positions;
 
-  CHECK(Pos->NRz_per_range == 1,
-        "Z values should be singular per range. A potential issue is that "
-        "regular grids ('I') were not used in the Runtype[4]");
+  std::vector<ArrivalPair> results;
+  results.reserve(receivers.size());
 
-  float minDirectDelay = std::numeric_limits<float>::max();
-  float minAnyDelay = std::numeric_limits<float>::max();
-  bool hasDirectArrival = false;
-  bool hasAnyArrival = false;
-  int multipathCount = 0;
+  // Constructor guarantees a single source, so every receiver lives at
+  // isx = isy = isz = 0.
+  for (const auto &receiver : receivers) {
+    CHECK(receiver.itheta < Pos->Ntheta && receiver.iz < Pos->NRz_per_range &&
+              receiver.ir < Pos->NRr,
+          "Receiver index lies outside the Bellhop receiver grid");
+    size_t base = GetFieldAddr(0, 0, 0, receiver.itheta, receiver.iz,
+                               receiver.ir, Pos);
+    int32_t narr = arrInfo->NArr[base];
 
-  for (int32_t isz = 0; isz < Pos->NSz; ++isz) {
-    for (int32_t isx = 0; isx < Pos->NSx; ++isx) {
-      for (int32_t isy = 0; isy < Pos->NSy; ++isy) {
-        for (int32_t itheta = 0; itheta < Pos->Ntheta; ++itheta) {
-          for (int32_t iz = 0; iz < Pos->NRz_per_range; ++iz) {
-            for (int32_t ir = 0; ir < Pos->NRr; ++ir) {
-              size_t base = GetFieldAddr(isx, isy, isz, itheta, iz, ir, Pos);
-              int32_t narr = arrInfo->NArr[base];
+    float minDirectDelay = std::numeric_limits<float>::max();
+    float minAnyDelay = std::numeric_limits<float>::max();
+    bool hasDirectArrival = false;
+    bool hasAnyArrival = false;
+    int multipathCount = 0;
 
-              for (size_t iArr = 0; iArr < static_cast<size_t>(narr); ++iArr) {
-                const size_t arrayIdx = base * arrInfo->MaxNArr + iArr;
-                const bhc::Arrival *arr = &arrInfo->Arr[arrayIdx];
-                auto delay = arr->delay.real();
-                if (delay < 0) {
-                  SPDLOG_DEBUG("Found {} arrivals for {}", narr,
-                               printReceiverInfo(Pos, ir, iz, itheta));
-                  throw std::runtime_error(
-                      "Negative delay encountered in arrival data");
-                }
+    for (size_t iArr = 0; iArr < static_cast<size_t>(narr); ++iArr) {
+      const size_t arrayIdx = base * arrInfo->MaxNArr + iArr;
+      const bhc::Arrival *arr = &arrInfo->Arr[arrayIdx];
+      auto delay = arr->delay.real();
+      if (delay < 0) {
+        SPDLOG_DEBUG("Found {} arrivals for {}", narr,
+                     printReceiverInfo(Pos, receiver.ir, receiver.iz,
+                                       receiver.itheta));
+        throw std::runtime_error("Negative delay encountered in arrival data");
+      }
 
-                // Track fastest arrival regardless of path type
-                if (delay < minAnyDelay) {
-                  minAnyDelay = delay;
-                  hasAnyArrival = true;
-                }
+      // Track fastest arrival regardless of path type
+      if (delay < minAnyDelay) {
+        minAnyDelay = delay;
+        hasAnyArrival = true;
+      }
 
-                // Track fastest direct-path (zero bounce) arrival
-                if (arr->NTopBnc > 0 || arr->NBotBnc > 0) {
-                  ++multipathCount;
-                  SPDLOG_TRACE("Multipath arrival: delay={:.6f}s, "
-                               "topBnc={}, botBnc={}",
-                               delay, arr->NTopBnc, arr->NBotBnc);
-                } else {
-                  // Track fastest direct-path (zero bounce) arrival
-                  if (delay < minDirectDelay) {
-                    minDirectDelay = delay;
-                    hasDirectArrival = true;
-                  }
-                }
-              }
-            }
-          }
-        }
+      if (arr->NTopBnc > 0 || arr->NBotBnc > 0) {
+        ++multipathCount;
+        SPDLOG_TRACE("Multipath arrival: delay={:.6f}s, "
+                     "topBnc={}, botBnc={}",
+                     delay, arr->NTopBnc, arr->NBotBnc);
+      } else if (delay < minDirectDelay) {
+        // Track fastest direct-path (zero bounce) arrival
+        minDirectDelay = delay;
+        hasDirectArrival = true;
       }
     }
-  }
 
-  if (!hasDirectArrival && multipathCount > 0) {
-    SPDLOG_WARN("No direct-path arrival found, {} multipath arrivals present",
-                multipathCount);
+    if (!hasDirectArrival && multipathCount > 0) {
+      SPDLOG_WARN("No direct-path arrival found, {} multipath arrivals present",
+                  multipathCount);
+    }
+
+    ArrivalPair result;
+    result.directPath = hasDirectArrival ? minDirectDelay : kNoArrival;
+    result.anyPath = hasAnyArrival ? minAnyDelay : kNoArrival;
+    results.push_back(result);
   }
 
-  ArrivalPair result;
-  result.directPath = hasDirectArrival ? minDirectDelay : kNoArrival;
-  result.anyPath = hasAnyArrival ? minAnyDelay : kNoArrival;
-  return result;
+  return results;
 }
 
 float Arrival::getLargestAmpArrival() {
-  const bhc::Position *Pos = inputs.Pos;
+  const bhc::Position *Pos = positions;
 
   float arrivalDelay = -1;
 
@@ -217,7 +230,7 @@ float Arrival::getLargestAmpArrival() {
   return arrivalDelay;
 }
 void Arrival::getAllArrivals(ArrivalInfoDebug &arrivalInfo) {
-  const bhc::Position *Pos = inputs.Pos;
+  const bhc::Position *Pos = positions;
 
   CHECK(Pos->NRz_per_range == 1,
         "Z values should be singular per range. A potential issue is that "
@@ -0,0 +1,14 @@
+#include "acoustics/pch.h"
+
+#include "acoustics/BellhopMemory.h"
+
+namespace acoustics {
+
+size_t BellhopMemoryEstimate::totalBytes() const {
+  const size_t allocated =
+      environmentBytes + beamBytes + receiverBytes + arrivalBytes;
+  return allocated + allocated * kBellhopMemoryMarginPct / 100 +
+         kBellhopOverheadBytes;
+}
+
+} // namespace acoustics
@@ -22,6 +22,8 @@ Grid2D::Grid2D(std::vector<double> x, std::vector<double> y,
   validateInitialization();
 }
 
+Grid2D Grid2D::clone() const { return Grid2D(xCoords, yCoords, data); }
+
 void Grid2D::clear() {
   xCoords.clear();
   yCoords.clear();
@@ -176,6 +178,10 @@ Grid3D::Grid3D(std::vector<double> x, std::vector<double> y,
   validateInitialization();
 }
 
+Grid3D Grid3D::clone() const {
+  return Grid3D(xCoords, yCoords, zCoords, data);
+}
+
 void Grid3D::clear() {
   xCoords.clear();
   yCoords.clear();
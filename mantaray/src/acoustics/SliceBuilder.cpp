@@ -0,0 +1,140 @@
+#include "acoustics/pch.h"
+
+#include "acoustics/SliceBuilder.h"
+
+#include "acoustics/AcousticsBuilder.h"
+
+namespace acoustics {
+
+SliceBuilder::SliceBuilder(bhc::bhcParams<false> &params, int numBeams,
+                           double elevationSpreadRad)
+    : params_(params), numBeams_(numBeams),
+      elevationSpreadRad_(elevationSpreadRad) {
+  CHECK(numBeams >= 1, "Slice fan needs at least one beam");
+}
+
+void SliceBuilder::update(const BearingSlice &slice, double sourceDepthM,
+                          double rangeM, double receiverDepthM) {
+  CHECK(slice.rangesM.size() >= 2 && slice.depthsM.size() >= 2,
+        "Bearing slice needs at least two ranges and two depths");
+  CHECK(slice.speeds.size() == slice.rangesM.size() * slice.depthsM.size() &&
+            slice.bottomDepthsM.size() == slice.rangesM.size(),
+        "Bearing slice sizes do not match its axes");
+  CHECK(slice.rangesM.back() >= rangeM,
+        "Bearing slice must reach the receiver");
+  buildSSP(slice);
+  buildBoundaries(slice);
+  buildAgents(sourceDepthM, rangeM, receiverDepthM);
+  buildBeam(sourceDepthM, rangeM, receiverDepthM, slice);
+}
+
+void SliceBuilder::buildSSP(const BearingSlice &slice) {
+  const auto nz = static_cast<int32_t>(slice.depthsM.size());
+  const auto nr = static_cast<int32_t>(slice.rangesM.size());
+  if (nz != sspDepths_ || nr != sspRanges_) {
+    bhc::extsetup_ssp_quad(params_, nz, nr);
+    sspDepths_ = nz;
+    sspRanges_ = nr;
+  }
+  params_.ssp->dirty = true;
+  params_.ssp->NPts = nz;
+  params_.ssp->Nr = nr;
+  params_.ssp->rangeInKm = false;
+  for (int32_t ir = 0; ir < nr; ++ir) {
+    params_.ssp->Seg.r[ir] = slice.rangesM[ir];
+  }
+  for (int32_t iz = 0; iz < nz; ++iz) {
+    params_.ssp->z[iz] = slice.depthsM[iz];
+    for (int32_t ir = 0; ir < nr; ++ir) {
+      const size_t idx = static_cast<size_t>(iz) * nr + ir;
+      params_.ssp->cMat[idx] = slice.speeds[idx];
+      CHECK((slice.speeds[idx] >= 1400.0) && (slice.speeds[idx] <= 1600.0),
+            "Unrealistic sound speed profile input into slice.");
+    }
+  }
+  params_.Bdry->Top.hs.Depth = slice.depthsM.front();
+  params_.Bdry->Bot.hs.Depth = slice.depthsM.back();
+}
+
+void SliceBuilder::buildBoundaries(const BearingSlice &slice) {
+  const auto n = static_cast<int32_t>(slice.rangesM.size());
+  if (n != bathymetryPts_) {
+    bhc::extsetup_bathymetry(params_, n, kNumProvince);
+    bathymetryPts_ = n;
+  }
+  auto &bottom = params_.bdinfo->bot;
+  bottom.dirty = true;
+  bottom.rangeInKm = false;
+  bottom.NPts = n;
+  bottom.type[0] = kBathymetryInterpLinearShort[0];
+  bottom.type[1] = kBathymetryInterpLinearShort[1];
+  for (int32_t i = 0; i < n; ++i) {
+    const double depth = slice.bottomDepthsM[i];
+    CHECK(depth >= 0.0, "Bathymetry depth values must be non-negative.");
+    bottom.bd[i].x.x = slice.rangesM[i];
+    bottom.bd[i].x.y = depth;
+    // PROVINCE IS 1 INDEXED
+    bottom.bd[i].Province = 1;
+  }
+
+  if (!altimetryBuilt_) {
+    bhc::extsetup_altimetry(params_, kNumAltimetryPts);
+    altimetryBuilt_ = true;
+  }
+  auto &top = params_.bdinfo->top;
+  top.dirty = true;
+  top.rangeInKm = false;
+  top.NPts = kNumAltimetryPts;
+  top.bd[0].x.x = slice.rangesM.front();
+  top.bd[0].x.y = 0.0;
+  top.bd[1].x.x = slice.rangesM.back();
+  top.bd[1].x.y = 0.0;
+}
+
+void SliceBuilder::buildAgents(double sourceDepthM, double rangeM,
+                               double receiverDepthM) {
+  if (!agentsBuilt_) {
+    bhc::extsetup_sz(params_, kNumSources);
+    bhc::extsetup_rcvrranges(params_, kNumRecievers);
+    bhc::extsetup_rcvrdepths(params_, kNumRecievers);
+    params_.Pos->NRr = kNumRecievers;
+    params_.Pos->NRz = kNumRecievers;
+    agentsBuilt_ = true;
+  }
+  params_.Beam->RunType[0] = kRunTypeArrivals;
+  params_.Beam->RunType[4] = kReceiverGridIrregular;
+  params_.Pos->NRz_per_range = kNumRecievers;
+  params_.Pos->RrInKm = false;
+  params_.Pos->Sz[0] = utils::safeDoubleToFloat(sourceDepthM);
+  params_.Pos->Rr[0] = rangeM;
+  params_.Pos->Rz[0] = utils::safeDoubleToFloat(receiverDepthM);
+}
+
+void SliceBuilder::buildBeam(double sourceDepthM, double rangeM,
+                             double receiverDepthM,
+                             const BearingSlice &slice) {
+  params_.Angles->alpha.inDegrees = false;
+  if (!beamBuilt_) {
+    bhc::extsetup_rayelevations(params_, numBeams_);
+    beamBuilt_ = true;
+  }
+  const Eigen::Vector3d delta{rangeM, 0.0, receiverDepthM - sourceDepthM};
+  const double elevation = utils::computeElevationAngle(delta);
+  params_.Angles->alpha.n = numBeams_;
+  utils::unsafeSetupVector(
+      params_.Angles->alpha.angles,
+      std::max(elevation - elevationSpreadRad_, -kMaxFanElevationRad),
+      std::min(elevation + elevationSpreadRad_, kMaxFanElevationRad),
+      numBeams_);
+
+  auto beam = params_.Beam;
+  beam->rangeInKm = false;
+  beam->deltas = std::max(delta.norm(), 1.0) * kBeamStepSizeRatio;
+  // Box stops rays at the end of the slice; depth leaves room to rebound
+  beam->Box.x = slice.rangesM.back();
+  beam->Box.y = *std::max_element(slice.bottomDepthsM.begin(),
+                                  slice.bottomDepthsM.end()) +
+                10.0;
+}
+
+} // namespace acoustics
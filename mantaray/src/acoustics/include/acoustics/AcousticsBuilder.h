@@ -2,6 +2,9 @@
  *  @brief See details of @ref AcousticsBuilder
  */
 #pragma once
+#include "acoustics/Arrival.h"
+#include "acoustics/BellhopMemory.h"
+#include "acoustics/EnvironmentSnapshot.h"
 #include "acoustics/SimulationConfig.h"
 #include "acoustics/helpers.h"
 #include "fmt_eigen.h"
@@ -9,6 +12,8 @@
 #include <algorithm>
 #include <array>
 #include <bhc/bhc.hpp>
+#include <memory>
+#include <vector>
 
 /** @namespace acoustics
  * @brief Acoustic simulation, Bellhop integration, and sound speed profiling
@@ -32,6 +37,25 @@ enum class BoundaryCheck {
   kInBounds
 };
 
+/**
+ * @brief Which rays of a beam level a Bellhop run traces
+ *
+ * @details A nested level of M = 2N - 1 beams per axis contains level N as its
+ * even-indexed angles. kNewElevations and kNewBearings together cover exactly
+ * the rays level M adds over level N, as two rectangular alpha x beta grids.
+ * When only one axis grew, kNewElevations or kNewBearingsOnly alone does.
+ */
+enum class BeamSubset {
+  // Every elevation x every bearing
+  kAll,
+  // Odd-indexed elevations x every bearing
+  kNewElevations,
+  // Even-indexed elevations x odd-indexed bearings
+  kNewBearings,
+  // Every elevation x odd-indexed bearings (elevation level unchanged)
+  kNewBearingsOnly
+};
+
 /* TODO: Need to implement validation checks
  * - [*] Beam box is within bounds of sim
  *  - This ends up not working due to symmetrical requirements of the beam box
@@ -85,18 +109,40 @@ public:
    * @param bathConfig
    * @param sspConfig
    * @param agentsConfig
+   * @param beams Per-axis beam counts, refinement caps and spreads
    */
   explicit AcousticsBuilder(bhc::bhcParams<true> &params,
                             BathymetryConfig &bathConfig, SSPConfig &sspConfig,
                             AgentsConfig &agentsConfig,
-                            int numBeams = kNumBeams,
-                            double beamSpreadDeg = 20.0, int maxBeams = 0);
+                            const BeamFanConfig &beams = BeamFanConfig{});
 
   /**
    * @brief Creates bathymetry, altimetry, SSP, and agent configurations in
    * Bellhop.
    */
   void build();
+
+  /**
+   * @brief Captures the built environment for fast cloning
+   * @details Copies Bellhop's boundary and SSP buffers as-is along with deep
+   * copies of the configs, beam settings, and current agent positions.
+   * @throw std::runtime_error if build() has not been called
+   */
+  [[nodiscard]] EnvironmentSnapshot snapshot() const;
+
+  /**
+   * @brief Stamps a snapshot into a freshly set up Bellhop context
+   * @details Bulk-copies the snapshot's buffers instead of running build(),
+   * skipping the SSP range checks and grid enclosure validation the source
+   * builder already passed. The context is ready to run on return.
+   * @param params Params of the (already set up) context to build into
+   * @param snapshot Environment captured by snapshot()
+   * @return Builder bound to params
+   */
+  [[nodiscard]] static std::unique_ptr<AcousticsBuilder>
+  fromSnapshot(bhc::bhcParams<true> &params,
+               const EnvironmentSnapshot &snapshot);
+
   static void quadraticBathymetry3D(const std::vector<double> &gridX,
                                     const std::vector<double> &gridY,
                                     std::vector<double> &data, double depth);
@@ -129,6 +175,119 @@ public:
    */
   [[nodiscard]] BoundaryCheck updateReceiver(const Eigen::Vector3d &position);
 
+  /** @brief Updates source and receiver together (MUST USE SAME UNITS AS
+   * CONFIG)
+   *
+   * @details Unlike calling updateSource() then updateReceiver(), neither
+   * endpoint is validated against a stale partner position.
+   */
+  [[nodiscard]] BoundaryCheck
+  updateSourceAndReceiver(const Eigen::Vector3d &source,
+                          const Eigen::Vector3d &receiver);
+
+  /** @brief Places every position as a receiver of one source so a single
+   * Bellhop run serves all of them (MUST USE SAME UNITS AS CONFIG)
+   *
+   * @details Bellhop's irregular receiver layout requires monotonic ranges and
+   * depths, which arbitrary targets cannot satisfy together. The receivers are
+   * therefore laid out on a rectilinear (RunType[4] = 'R') grid built from the
+   * unique ranges, depths, and bearings of the targets; getReceiverIndices()
+   * maps each target back to its grid cell, so n targets can cost up to n^3
+   * cells. Keep groups small. The beam fan is widened to cover every target
+   * at the same angular density as a single-receiver fan, so the targets'
+   * bearings and elevations must each span at most fanTargetSpanRad().
+   *
+   * The next single-receiver update restores irregular mode.
+   *
+   * @return kInBounds, or the first boundary failure encountered
+   */
+  [[nodiscard]] BoundaryCheck
+  updateSourceAndReceivers(const Eigen::Vector3d &source,
+                           const std::vector<Eigen::Vector3d> &receivers);
+
+  /** @brief Places a regular polar receiver grid around one source and aims
+   * an all-around fan at it (MUST USE SAME UNITS AS CONFIG)
+   *
+   * @details Uses Bellhop's rectilinear (RunType[4] = 'R') layout directly:
+   * every range x depth x bearing combination is a receiver. The fan covers
+   * all bearings and elevations up to kMaxFanElevationRad at getMaxBeams()
+   * rays per axis, with a beam box reaching the farthest range.
+   * getReceiverIndices() lists every cell, bearing-major then depth then
+   * range. Intended for one-off precomputation (see sim::TravelTimeAtlas);
+   * the next single-receiver update restores irregular mode.
+   *
+   * @param source Source position
+   * @param ranges Horizontal ranges from the source, strictly increasing
+   * @param depths Receiver depths, strictly increasing
+   * @param bearingsDeg Bearings in degrees, strictly increasing
+   * @return kInBounds, or the source's boundary failure
+   */
+  [[nodiscard]] BoundaryCheck
+  updateSourceAndReceiverGrid(const Eigen::Vector3d &source,
+                              const std::vector<double> &ranges,
+                              const std::vector<double> &depths,
+                              const std::vector<double> &bearingsDeg);
+
+  /** @brief Switches to ray mode and aims an all-around fan from a source
+   * (MUST USE SAME UNITS AS CONFIG)
+   *
+   * @details Sets RunType[0] to ray output so bhc::run() fills
+   * bhcOutputs::rayinfo instead of arrivals; receivers are left untouched
+   * since ray mode ignores them. The fan matches
+   * updateSourceAndReceiverGrid(). Any other update restores arrival mode.
+   *
+   * @param source Source position
+   * @param maxRangeM Horizontal range the beam box must reach
+   * @return kInBounds, or the source's boundary failure
+   */
+  [[nodiscard]] BoundaryCheck
+  updateSourceForRayFan(const Eigen::Vector3d &source, double maxRangeM);
+
+  /**
+   * @brief Widest spread of target angles on one axis that a multi-receiver
+   * fan covers at single-receiver density.
+   * @details A fan spans the targets plus spreadRad either side. At numBeams
+   * per 2 * spreadRad it may use at most maxBeams rays.
+   * @param numBeams Beams of a single-receiver fan on the axis
+   * @param maxBeams Beams allocated on the axis
+   * @param spreadRad Half-cone angle on the axis (radians)
+   */
+  static double fanTargetSpanRad(int numBeams, int maxBeams, double spreadRad);
+
+  /**
+   * @brief Memory budget a 3D context needs for an environment and beam fan.
+   *
+   * @details Bellhop tracks its allocations against bhcInit::maxMemory, and
+   * in arrivals mode gives every receiver an equal share of whatever is left
+   * as arrival slots (MaxNArr). A hand-tuned budget is therefore either too
+   * small for dense fans or hands the surplus to slots nobody uses. The
+   * budget is built up from the grids, the fan at its maximum beam counts,
+   * and a fixed number of arrival slots per receiver. A run over n targets
+   * lays out up to n^3 receivers (see updateSourceAndReceivers()). Sizes
+   * come from Bellhop's own structs, so they follow its build options.
+   *
+   * @param beams Beam fan; maxBeams axes <= 0 use their initial counts
+   * @param demand Largest run the context has to hold
+   */
+  static BellhopMemoryEstimate
+  estimateMemory(const SSPConfig &ssp, const BathymetryConfig &bathymetry,
+                 const BeamFanConfig &beams, const BellhopMemoryDemand &demand);
+
+  /**
+   * @brief Beam counts updateSourceAndReceivers() would load for these
+   *        endpoints, without touching Bellhop state.
+   * @details Lets a caller price a fan-out run before tracing it.
+   */
+  [[nodiscard]] BeamCounts
+  fanBeamCounts(const Eigen::Vector3d &source,
+                const std::vector<Eigen::Vector3d> &receivers) const;
+
+  /// @brief Grid location of each receiver placed by the last update, in the
+  ///        order the positions were given.
+  const std::vector<ReceiverIndex> &getReceiverIndices() const {
+    return receiverIndices_;
+  }
+
   /** @brief Validates that bathymetry is completely enclosed by ssp grid.
    *
    * @param bathGrid
@@ -137,19 +296,48 @@ public:
   void validateSPPandBathymetryBox(const Grid2D &bathGrid,
                                    const Grid3D &sspGrid) const;
 
-  /// @brief Rebuild beam fan with a new beam count using current geometry.
+  /// @brief Rebuild beam fan with new per-axis beam counts using current
+  ///        geometry.
   /// @details Reallocates ray arrays if needed and recomputes angles from
   ///          the current source/receiver positions stored in agentsConfig_.
-  void rebuildBeam(int newNumBeams);
+  ///          Counts must not exceed getMaxBeams(). A subset other than kAll
+  ///          loads only that part of the level (single-receiver fans with
+  ///          odd counts on both axes only).
+  void rebuildBeam(const BeamCounts &newNumBeams,
+                   BeamSubset subset = BeamSubset::kAll);
+
+  /**
+   * @brief Replaces the single-receiver fan with a narrow one around the
+   * straight line from source to receiver.
+   * @details Same centre as the normal fan, which is where the direct ray
+   * leaves the source when refraction is weak. Keeps the current beam counts
+   * and beam box, so the angular density on each axis grows by its
+   * spread / halfWidth. Restore the normal fan with rebuildBeam().
+   * @param halfWidthRad Half-width of the fan on both axes (radians)
+   */
+  void zoomBeam(double halfWidthRad);
 
   /// @brief Returns the current active beam count per axis.
-  int getNumBeams() const { return numBeams_; }
+  BeamCounts getNumBeams() const { return numBeams_; }
+
+  /// @brief Returns the maximum beam counts that were pre-allocated.
+  BeamCounts getMaxBeams() const { return maxBeams_; }
+
+  /// @brief Returns the elevation half-cone angle in degrees.
+  double getElevationSpreadDeg() const {
+    return elevationSpreadRad_ * kRadians2Degree;
+  }
 
-  /// @brief Returns the maximum beam count that was pre-allocated.
-  int getMaxBeams() const { return maxBeams_; }
+  /// @brief Returns the bearing half-cone angle in degrees.
+  double getBearingSpreadDeg() const {
+    return bearingSpreadRad_ * kRadians2Degree;
+  }
 
   AgentsConfig &getAgentsConfig();
   const SSPConfig &getSSPConfig() const;
+  const BathymetryConfig &getBathymetryConfig() const {
+    return bathymetryConfig_;
+  }
 
 private:
   bhc::bhcParams<true> &params_;
@@ -169,10 +357,16 @@ private:
   // double minBoxWidth_{-1.0};
   bool bathymetryBuilt_{false};
   bool agentsBuilt_{false};
-  int numBeams_;
-  int maxBeams_{0};
-  double beamSpreadRad_;
+  BeamCounts numBeams_;
+  BeamCounts maxBeams_;
+  double elevationSpreadRad_;
+  double bearingSpreadRad_;
   bool beamBuilt_{false};
+  // Receivers of the current multi-receiver run (empty in single mode)
+  std::vector<Eigen::Vector3d> fanReceivers_{};
+  std::vector<ReceiverIndex> receiverIndices_{ReceiverIndex{}};
+  // Allocated receiver ranges, depths and bearings (active counts may be less)
+  std::array<int32_t, 3> receiverCapacity_{0, 0, 0};
 
   /** @brief Constructs bathymetry based on bathymetry config
    *  @details Assumes a 1 province of all points.
@@ -186,6 +380,11 @@ private:
   void autogenerateAltimetry();
   void buildSSP();
 
+  /** @brief Fills Bellhop from a snapshot in place of the build steps.
+   *  @details Only allocation and bulk copies; no validation.
+   */
+  void buildFromSnapshot(const EnvironmentSnapshot &snapshot);
+
   /** @brief Updates source and receiver positions in Bellhop based on input
    * parameters
    * @throw std::runtime_error if agents have not been built yet
@@ -218,8 +417,52 @@ private:
    * updated by calling this function again with the new bearing angle.
    * @param bearingAngle The angle in radians between source and receiver in
    * x-y plane.
+   * @param subset Part of the numBeams_ level to load, see BeamSubset
+   */
+  void constructBeam(double bearingAngle,
+                     BeamSubset subset = BeamSubset::kAll);
+
+  /**
+   * @brief Constructs a beam fan spanning every receiver in fanReceivers_
+   *
+   * @details Covers the smallest bearing arc and elevation band containing
+   * all receivers, padded by the beam spread. Beam counts scale with the
+   * covered angle so the angular density matches constructBeam(); see
+   * fanAngles().
+   */
+  void constructFanBeam();
+
+  /// @brief Angular extent and beam counts of a fan over some receivers.
+  struct FanAngles {
+    double bearingLow{0.0};
+    double bearingSpan{0.0};
+    double elevationLow{0.0};
+    double elevationHigh{0.0};
+    BeamCounts beams{0, 0};
+  };
+
+  /// @brief Fan constructFanBeam() aims from source over receivers.
+  FanAngles fanAngles(const Eigen::Vector3d &source,
+                      const std::vector<Eigen::Vector3d> &receivers) const;
+
+  /// @brief Allocates ray angle arrays for maxBeams_ on first use.
+  void ensureBeamArrays();
+
+  /// @brief Writes beam box extents and step size into Bellhop.
+  void applyBeamBox(const utils::BeamBoxParams &beamBox);
+
+  /// @brief Fans getMaxBeams() rays over every bearing and elevations up to
+  ///        kMaxFanElevationRad, with a beam box reaching maxRangeM.
+  void constructAllAroundBeam(double maxRangeM);
+
+  /// @brief Sets receiver array sizes, reallocating only on size change.
+  void resizeReceivers(int32_t nRanges, int32_t nDepths, int32_t nBearings);
+
+  /** @brief Checks a source/receiver pair against the simulation box and
+   * bathymetry without touching Bellhop state.
    */
-  void constructBeam(double bearingAngle);
+  BoundaryCheck checkAgentBounds(const Eigen::Vector3d &source,
+                                 const Eigen::Vector3d &receiver) const;
 
   /**
    *  @brief Checks if position is not underneath the bathymetry using
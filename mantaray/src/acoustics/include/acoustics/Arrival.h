@@ -6,6 +6,7 @@
 #pragma once
 #include "acoustics/helpers.h"
 #include "mantaray/utils/checkAssert.h"
+#include <algorithm>
 #include <bhc/bhc.hpp>
 #include <bhc/structs.hpp>
 #include <fstream>
@@ -20,6 +21,38 @@ struct ArrivalPair {
   float directPath{kNoArrival}; ///< Fastest zero-bounce arrival (seconds)
   float anyPath{
       kNoArrival}; ///< Fastest arrival regardless of bounces (seconds)
+
+  /**
+   * @brief Folds in another run's arrivals for the same receiver.
+   * @details Used when one beam level is traced as several disjoint ray
+   * subsets; the result equals a single run over their union.
+   */
+  void merge(const ArrivalPair &other) {
+    directPath = faster(directPath, other.directPath);
+    anyPath = faster(anyPath, other.anyPath);
+  }
+
+private:
+  static float faster(float a, float b) {
+    if (a < 0.0f) {
+      return b;
+    }
+    if (b < 0.0f) {
+      return a;
+    }
+    return std::min(a, b);
+  }
+};
+
+/**
+ * @brief Location of one logical receiver inside Bellhop's receiver grid.
+ * @details Single-link runs use the default {0, 0, 0}. Multi-receiver runs
+ * place every target on a rectilinear grid and record where each one landed.
+ */
+struct ReceiverIndex {
+  int32_t itheta{0}; ///< Bearing index (Ntheta)
+  int32_t iz{0};     ///< Depth index (NRz_per_range)
+  int32_t ir{0};     ///< Range index (NRr)
 };
 
 /**
@@ -41,30 +74,37 @@ struct ArrivalInfoDebug {
 /** @brief Class that extracts arrival information from bellhop output format
  * @details Checks to ensure that appropriate fields exist in bellhop output
  * to prevent segmentation faults through dereferencing of null pointers etc.
+ * 3D and 2D runs share the arrival layout, so either can be read; a 2D run
+ * is a single-bearing grid.
  */
 class Arrival {
 public:
   Arrival(bhc::bhcParams<true> &in_params,
           bhc::bhcOutputs<true, true> &outputs);
-  /**
-   * @brief Find the fastest arrival time for each reciever position.
-   * @details Iterates through all source and receiver positions, checking the
-   * arrival. Utilize getIdx to map 3D receiver indices to flattened vector
-   * index.
-   *
-   * @param directPathOnly When true, only consider arrivals with zero
-   *        surface and bottom bounces (direct path). Returns kNoArrival
-   *        if no direct path exists.
-   * @return Earliest arrival delay in seconds, or kNoArrival (-1) if none
-   */
+  Arrival(bhc::bhcParams<false> &in_params,
+          bhc::bhcOutputs<false, false> &outputs);
   /**
    * @brief Single-pass extraction of both direct-path and any-path fastest
-   * arrivals.
-   * @details Iterates through all arrivals once, tracking the minimum delay
-   * for zero-bounce (direct) and all arrivals (any) simultaneously.
-   * @return ArrivalPair with direct-path and any-path TOF
+   * arrivals for each requested receiver.
+   * @details Iterates through the arrivals of every receiver once, tracking the
+   * minimum delay for zero-bounce (direct) and all arrivals (any)
+   * simultaneously.
+   * @param receivers Grid locations to extract, defaults to the single
+   *        receiver of a one-link run
+   * @return One ArrivalPair per entry of receivers, in the same order
    */
-  ArrivalPair getFastestArrivals();
+  std::vector<ArrivalPair>
+  getFastestArrivals(const std::vector<ReceiverIndex> &receivers = {
+                         ReceiverIndex{}}) const;
+
+  /// @brief Receivers in the run (ranges x depths x bearings).
+  size_t getReceiverCount() const;
+
+  /// @brief Most arrivals stored at any one receiver.
+  int32_t getPeakArrivalCount() const;
+
+  /// @brief Arrival slots Bellhop allocated per receiver (MaxNArr).
+  int32_t getArrivalCapacity() const { return arrInfo->MaxNArr; }
 
   /**
    * @brief Returns largest amplitude arrival (not the shortest flight time)
@@ -73,8 +113,9 @@ public:
   void getAllArrivals(ArrivalInfoDebug &arrivalInfo);
 
 private:
-  const bhc::bhcParams<true> &inputs;
-  bhc::bhcOutputs<true, true> &outputs;
+  Arrival(const bhc::Position *pos, bhc::ArrInfo *info);
+
+  const bhc::Position *positions;
   bhc::ArrInfo *arrInfo;
 
   /**
@@ -0,0 +1,53 @@
+/** @file BellhopMemory.h
+ *  @brief Sizing of a Bellhop context's memory budget (bhcInit::maxMemory)
+ */
+#pragma once
+#include "acoustics/SimulationConfig.h"
+
+#include <cstddef>
+
+namespace acoustics {
+
+/// Arrival slots per receiver when none are configured. Bellhop keeps the
+/// strongest arrivals once a receiver's slots fill, and only the earliest
+/// direct and any-path arrivals are used, so this does not grow with rays.
+constexpr size_t kDefaultArrivalsPerReceiver = 100;
+
+/**
+ * @brief Largest run a context has to hold.
+ */
+struct BellhopMemoryDemand {
+  /// Targets in the largest run; see AcousticsBuilder::estimateMemory()
+  size_t maxTargets{1};
+  /// Arrival slots per receiver (Bellhop's MaxNArr)
+  size_t arrivalsPerReceiver{kDefaultArrivalsPerReceiver};
+};
+
+/**
+ * @brief Bytes a context needs, by what Bellhop allocates them for.
+ */
+struct BellhopMemoryEstimate {
+  /// SSP and boundary grids
+  size_t environmentBytes{0};
+  /// Launch angle arrays at the maximum beam counts
+  size_t beamBytes{0};
+  /// Receiver coordinate arrays
+  size_t receiverBytes{0};
+  /// Arrival storage and per-receiver counts
+  size_t arrivalBytes{0};
+  /// Receivers in the largest run
+  size_t receivers{0};
+  /// Arrival slots per receiver (Bellhop's MaxNArr) the budget leaves room for
+  size_t arrivalsPerReceiver{0};
+
+  /// @brief Budget to pass as bhcInit::maxMemory, margin and overhead
+  ///        included.
+  [[nodiscard]] size_t totalBytes() const;
+};
+
+/// Fixed Bellhop allocations not covered by the estimate (bytes)
+constexpr size_t kBellhopOverheadBytes = size_t{4} << 20;
+/// Headroom on the estimated allocations, in percent
+constexpr size_t kBellhopMemoryMarginPct = 25;
+
+} // namespace acoustics
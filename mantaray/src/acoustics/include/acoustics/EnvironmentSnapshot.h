@@ -0,0 +1,66 @@
+/** @file EnvironmentSnapshot.h
+ *  @brief See details of @ref EnvironmentSnapshot
+ */
+#pragma once
+#include "acoustics/SimulationConfig.h"
+#include "acoustics/acousticsConstants.h"
+#include <Eigen/Dense>
+#include <array>
+#include <bhc/bhc.hpp>
+#include <vector>
+
+namespace acoustics {
+
+/**
+ * @brief Bellhop-ready copy of a fully built acoustic environment
+ *
+ * @details Captured by AcousticsBuilder::snapshot() after build(). The Bellhop
+ * side holds the boundary and SSP buffers exactly as Bellhop stores them
+ * (storage order, units, province assignment), so a new context can be filled
+ * by bulk copies with no per-element conversion or validation. The builder
+ * side holds the configs and beam settings a builder needs to keep running.
+ *
+ * One snapshot can stamp out any number of contexts via
+ * AcousticsBuilder::fromSnapshot(). It is move-only because the grids are.
+ */
+struct EnvironmentSnapshot {
+  // --- Builder side ---
+  BathymetryConfig bathymetry;
+  SSPConfig ssp;
+  AgentsConfig agents;
+  BeamFanConfig beams{};
+  Eigen::Vector3d minCoords{};
+  Eigen::Vector3d maxCoords{};
+
+  // --- Bellhop side ---
+  /// Beam RunType and title set on the source context by the caller
+  std::array<char, 7> runType{};
+  std::array<char, kMaxTitle> title{};
+
+  /// Bathymetry points in Bellhop order (nx * ny)
+  bhc::IORI2<true> bathymetryNPts{};
+  std::array<char, kBathymetryBuffSize> bathymetryType{};
+  bool bathymetryInKm{false};
+  std::vector<bhc::BdryPtFull<true>> bathymetryPts{};
+
+  /// Altimetry points in Bellhop order
+  bhc::IORI2<true> altimetryNPts{};
+  bool altimetryInKm{false};
+  std::vector<bhc::BdryPtFull<true>> altimetryPts{};
+
+  /// Hexahedral SSP, depths already scaled to meters
+  int32_t sspNx{0};
+  int32_t sspNy{0};
+  int32_t sspNz{0};
+  bool sspInKm{false};
+  std::vector<double> sspX{};
+  std::vector<double> sspY{};
+  std::vector<double> sspZ{};
+  std::vector<double> sspC{};
+
+  /// Half-space depths synced with the SSP range
+  double topDepth{0.0};
+  double bottomDepth{0.0};
+};
+
+} // namespace acoustics
@@ -56,6 +56,9 @@ public:
   Grid2D(std::vector<double> x, std::vector<double> y,
          std::vector<double> initData);
 
+  /** @brief Explicit deep copy, since implicit copies are disabled */
+  Grid2D clone() const;
+
   void clear();
 
   size_t nx() const;
@@ -124,6 +127,9 @@ public:
   Grid3D(std::vector<double> x, std::vector<double> y, std::vector<double> z,
          std::vector<double> initData);
 
+  /** @brief Explicit deep copy, since implicit copies are disabled */
+  Grid3D clone() const;
+
   void clear();
 
   size_t nx() const;
@@ -29,6 +29,19 @@ struct SSPConfig {
   bool isKm{false};
 };
 
+/**
+ * @brief Range-dependent vertical slice of the environment along one bearing
+ * @details Ranges run outward from the source, all values in meters.
+ * speeds is depth-major (speeds[iz * rangesM.size() + ir]), the order of
+ * Bellhop's quad SSP. bottomDepthsM holds the seafloor depth at each range.
+ */
+struct BearingSlice {
+  std::vector<double> rangesM;
+  std::vector<double> depthsM;
+  std::vector<double> speeds;
+  std::vector<double> bottomDepthsM;
+};
+
 /**
  * @brief Source and Receiver configuration
  * @details Must be supplied in meters. This struct is legacy from when multiple
@@ -41,4 +54,41 @@ struct AgentsConfig {
   Eigen::Vector3d receiver;
 };
 
+/**
+ * @brief Ray counts of a beam fan, one per launch axis
+ * @details Elevation is Bellhop's alpha (declination), bearing is beta
+ * (azimuth). A fan traces elevation x bearing rays.
+ */
+struct BeamCounts {
+  int elevation{kNumBeams};
+  int bearing{kNumBeams};
+
+  bool operator==(const BeamCounts &other) const {
+    return elevation == other.elevation && bearing == other.bearing;
+  }
+  bool operator!=(const BeamCounts &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Beam fan resolution and width, set independently per axis
+ * @details Horizontal refraction is usually weak, so the bearing axis can be
+ * narrower and sparser than the elevation axis.
+ */
+struct BeamFanConfig {
+  // Initial ray counts
+  BeamCounts numBeams{};
+  // Refinement caps and allocation size; an axis <= 0 uses its initial count
+  BeamCounts maxBeams{0, 0};
+  // Half-cone angles in degrees
+  double elevationSpreadDeg{20.0};
+  double bearingSpreadDeg{20.0};
+
+  /// @brief Same count, cap and spread on both axes.
+  static BeamFanConfig isotropic(int numBeams, double spreadDeg,
+                                 int maxBeams = 0) {
+    return BeamFanConfig{BeamCounts{numBeams, numBeams},
+                         BeamCounts{maxBeams, maxBeams}, spreadDeg, spreadDeg};
+  }
+};
+
 }; // namespace acoustics
\ No newline at end of file
@@ -0,0 +1,63 @@
+/** @file SliceBuilder.h
+ *  @brief See details of @ref SliceBuilder
+ */
+#pragma once
+#include "acoustics/SimulationConfig.h"
+#include "acoustics/helpers.h"
+#include "mantaray/utils/checkAssert.h"
+#include <bhc/bhc.hpp>
+
+namespace acoustics {
+
+/**
+ * @brief Loads a BearingSlice and one source-receiver pair into a 2D Bellhop
+ * context
+ *
+ * @details The 2D counterpart of AcousticsBuilder for Nx2D runs. The slice
+ * becomes a quad (range-dependent) SSP, a piecewise-linear bathymetry and a
+ * flat altimetry. The source sits at range 0 and the receiver at its
+ * horizontal distance. The elevation fan is the 3D fan's elevation axis:
+ * `numBeams` rays over ±spread around the receiver's elevation.
+ *
+ * Arrays are reallocated only when a slice's size changes, so repeated
+ * links with similar slices reuse the context's buffers.
+ */
+class SliceBuilder {
+public:
+  /**
+   * @param params 2D Bellhop params this builder writes into
+   * @param numBeams Elevation rays per run
+   * @param elevationSpreadRad Half-width of the elevation fan
+   */
+  SliceBuilder(bhc::bhcParams<false> &params, int numBeams,
+               double elevationSpreadRad);
+
+  /**
+   * @brief Replaces the environment and agents of the 2D run.
+   * @param slice Environment along the bearing; must reach past rangeM
+   * @param sourceDepthM Source depth at range 0
+   * @param rangeM Horizontal source-receiver distance
+   * @param receiverDepthM Receiver depth
+   */
+  void update(const BearingSlice &slice, double sourceDepthM, double rangeM,
+              double receiverDepthM);
+
+private:
+  void buildSSP(const BearingSlice &slice);
+  void buildBoundaries(const BearingSlice &slice);
+  void buildAgents(double sourceDepthM, double rangeM, double receiverDepthM);
+  void buildBeam(double sourceDepthM, double rangeM, double receiverDepthM,
+                 const BearingSlice &slice);
+
+  bhc::bhcParams<false> &params_;
+  int numBeams_;
+  double elevationSpreadRad_;
+  int32_t sspDepths_{0};
+  int32_t sspRanges_{0};
+  int32_t bathymetryPts_{0};
+  bool altimetryBuilt_{false};
+  bool agentsBuilt_{false};
+  bool beamBuilt_{false};
+};
+
+} // namespace acoustics
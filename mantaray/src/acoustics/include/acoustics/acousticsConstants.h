@@ -15,8 +15,16 @@ constexpr char kBathymetryInterpLinearShort[] = "LS";
 constexpr char kBathymetryCurveInterpShort[] = "CS";
 // Code only supports 1 source
 constexpr int kNumSources = 1;
-// Code only supports 1 receiver
+// Receivers per axis in single-receiver mode
 constexpr int kNumRecievers = 1;
+// RunType[4] receiver layout: ranges and depths paired one-to-one
+constexpr char kReceiverGridIrregular = 'I';
+// RunType[4] receiver layout: full ranges x depths x bearings grid
+constexpr char kReceiverGridRectilinear = 'R';
+// RunType[0]: arrival (TOF) output, the normal mode
+constexpr char kRunTypeArrivals = 'A';
+// RunType[0]: ray path output, kept in memory for RayBundle
+constexpr char kRunTypeRays = 'R';
 // Total number of beams requested from Bellhop
 constexpr int kNumBeams = 80;
 // Conversion constant
@@ -25,8 +33,12 @@ constexpr double kDegree2Radians = M_PI / 180.0;
 constexpr double kRadians2Degree = 1.0 / kDegree2Radians;
 // Cone angle that will be swept by bellhop beam
 constexpr double kBeamSpreadRadians = 20.0 * kDegree2Radians;
+// Elevation limit for multi-receiver fans, keeps rays off the vertical
+constexpr double kMaxFanElevationRad = 89.0 * kDegree2Radians;
 // Ratio of distance between source and receiver each ray will ds step by
 constexpr double kBeamStepSizeRatio = 1.0 / 150.0;
+// Beam box extent as a multiple of the source-receiver offset
+constexpr double kBeamBoxScale = 1.50;
 
 enum class BathyInterpolationType {
   kLinear,
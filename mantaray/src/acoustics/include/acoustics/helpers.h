@@ -67,6 +67,33 @@ template <typename T> void unsafeSetupVector(T *arr, T low, T high, int size) {
   }
 }
 
+/**
+ * @brief Setup array with every stride-th point of a linspace
+ * @details Point i gets exactly the value unsafeSetupVector(arr, low, high,
+ * size) would write at index i, so a nested level of size 2N - 1 reproduces
+ * level N bit-for-bit at its even indices.
+ * @param arr Pointer to array to populate
+ * @param low Lower bound value
+ * @param high Upper bound value
+ * @param size Number of points in the full linspace
+ * @param offset Index of the first point to take
+ * @param stride Step between taken points
+ * @return Number of elements written
+ *
+ * @note No bounds checking is performed. Caller must ensure arr has sufficient
+ * space.
+ */
+template <typename T>
+int unsafeSetupStridedVector(T *arr, T low, T high, int size, int offset,
+                             int stride) {
+  int count = 0;
+  for (int i = offset; i < size; i += stride) {
+    arr[count++] = low + static_cast<double>(i) /
+                             static_cast<double>(size - 1) * (high - low);
+  }
+  return count;
+}
+
 /** @brief Helper to setup vectors from ranges. Operates on copying output
  * buffer size
  */
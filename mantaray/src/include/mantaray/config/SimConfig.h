@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "acoustics/BellhopMemory.h"
 #include "acoustics/SimulationConfig.h"
 #include "mantaray/sim/AcousticPairwiseRangeSystem.h"
 #include "mantaray/sim/CurrentDriftRobot.h"
@@ -99,7 +100,11 @@ struct SimConfig {
   std::string outputDir;
   std::string envConfigFile;
   size_t rngSeed{10020};
+  // 0 sizes each context from its environment and beam fan
   size_t bellhopMemoryMib{80};
+  size_t bellhopArrivalsPerReceiver{acoustics::kDefaultArrivalsPerReceiver};
+  size_t workerThreads{1};
+  int bellhopThreads{-1};
 
   double endTimeHours{8.0};
   double physicsDt{0.1};
@@ -111,7 +116,44 @@ struct SimConfig {
   int numBeams{80};
   int maxBeams{180};
   double beamSpreadDeg{20.0};
+  // Bearing axis; <= 0 reuses the elevation value above. An unset cap is
+  // raised to num_bearing_beams when that exceeds max_beams.
+  int numBearingBeams{0};
+  int maxBearingBeams{0};
+  double bearingSpreadDeg{0.0};
   bool allowMultipath{false};
+  bool fanOutPerPinger{false};
+  size_t fanOutMaxTargets{4};
+  double tofCacheToleranceM{0.0};
+  std::string persistentTofCacheDir{};
+  size_t persistentTofCacheSlots{size_t{1} << 18};
+  bool beamWarmStart{false};
+  int failureBackoffMaxPings{0};
+  std::string beamRefinement{"doubling"};
+  double zoomWindowDeg{1.0};
+  double maxLinkRangeM{0.0};
+  double linkSkinM{0.0};
+  std::string linkSchedule{"all_pairs"};
+  size_t linkScheduleK{4};
+  bool asyncPipeline{false};
+  bool offlinePings{false};
+  bool landmarkAtlas{false};
+  sim::AtlasGridConfig atlas{};
+  bool landmarkRayBundle{false};
+  sim::RayBundleConfig rayBundle{};
+  bool straightRayFastPath{false};
+  sim::StraightRayConfig straightRay{};
+  bool imageSourceModel{false};
+  sim::ImageSourceConfig imageSource{};
+  bool nx2dSlices{false};
+  sim::Nx2DConfig nx2d{};
+  sim::FidelityConfig fidelity{};
+  bool keyframes{false};
+  sim::KeyframeConfig keyframe{};
+  sim::BudgetConfig budget{};
+  // Set by the --shard K/N command line flag, not the JSON file
+  size_t shardIndex{0};
+  size_t shardCount{1};
 
   sim::StandardSensorConfig sensors{};
 
@@ -127,6 +169,16 @@ inline void from_json(const json &j, SimConfig &c) {
   j.at("env_config_file").get_to(c.envConfigFile);
   c.rngSeed = j.value("rng_seed", c.rngSeed);
   c.bellhopMemoryMib = j.value("bellhop_memory_mib", c.bellhopMemoryMib);
+  c.bellhopArrivalsPerReceiver = j.value("bellhop_arrivals_per_receiver",
+                                         c.bellhopArrivalsPerReceiver);
+  if (c.bellhopArrivalsPerReceiver == 0) {
+    throw std::runtime_error("bellhop_arrivals_per_receiver must be positive");
+  }
+  c.workerThreads = j.value("worker_threads", c.workerThreads);
+  c.bellhopThreads = j.value("bellhop_threads", c.bellhopThreads);
+  if (c.workerThreads == 0) {
+    throw std::runtime_error("worker_threads must be at least 1");
+  }
 
   if (j.contains("timing")) {
     const auto &t = j.at("timing");
@@ -145,7 +197,172 @@ inline void from_json(const json &j, SimConfig &c) {
     c.numBeams = a.value("num_beams", c.numBeams);
     c.maxBeams = a.value("max_beams", c.maxBeams);
     c.beamSpreadDeg = a.value("beam_spread_deg", c.beamSpreadDeg);
+    c.numBearingBeams = a.value("num_bearing_beams", c.numBearingBeams);
+    c.maxBearingBeams = a.value("max_bearing_beams", c.maxBearingBeams);
+    c.bearingSpreadDeg = a.value("bearing_spread_deg", c.bearingSpreadDeg);
+    if (c.numBeams > c.maxBeams) {
+      throw std::runtime_error("num_beams must not exceed max_beams");
+    }
+    if (c.maxBearingBeams > 0 &&
+        (c.numBearingBeams > 0 ? c.numBearingBeams : c.numBeams) >
+            c.maxBearingBeams) {
+      throw std::runtime_error(
+          "num_bearing_beams must not exceed max_bearing_beams");
+    }
     c.allowMultipath = a.value("allow_multipath", c.allowMultipath);
+    c.fanOutPerPinger = a.value("fan_out_per_pinger", c.fanOutPerPinger);
+    c.fanOutMaxTargets = a.value("fan_out_max_targets", c.fanOutMaxTargets);
+    if (c.fanOutMaxTargets < 2) {
+      throw std::runtime_error("fan_out_max_targets must be at least 2");
+    }
+    c.tofCacheToleranceM =
+        a.value("tof_cache_tolerance_m", c.tofCacheToleranceM);
+    c.persistentTofCacheDir =
+        a.value("persistent_tof_cache_dir", c.persistentTofCacheDir);
+    c.persistentTofCacheSlots =
+        a.value("persistent_tof_cache_slots", c.persistentTofCacheSlots);
+    if (!c.persistentTofCacheDir.empty() &&
+        (c.tofCacheToleranceM <= 0.0 || c.persistentTofCacheSlots == 0)) {
+      throw std::runtime_error("persistent_tof_cache_dir requires "
+                               "tof_cache_tolerance_m > 0 and "
+                               "persistent_tof_cache_slots > 0");
+    }
+    c.beamWarmStart = a.value("beam_warm_start", c.beamWarmStart);
+    c.failureBackoffMaxPings =
+        a.value("failure_backoff_max_pings", c.failureBackoffMaxPings);
+    c.beamRefinement = a.value("beam_refinement", c.beamRefinement);
+    if (c.beamRefinement != "doubling" && c.beamRefinement != "nested" &&
+        c.beamRefinement != "zoom") {
+      throw std::runtime_error("Unknown beam_refinement: " + c.beamRefinement);
+    }
+    c.zoomWindowDeg = a.value("zoom_window_deg", c.zoomWindowDeg);
+    if (c.zoomWindowDeg <= 0.0) {
+      throw std::runtime_error("zoom_window_deg must be positive");
+    }
+    c.maxLinkRangeM = a.value("max_link_range_m", c.maxLinkRangeM);
+    c.linkSkinM = a.value("link_skin_m", c.linkSkinM);
+    if (c.linkSkinM < 0.0) {
+      throw std::runtime_error("link_skin_m must not be negative");
+    }
+    c.linkSchedule = a.value("link_schedule", c.linkSchedule);
+    if (c.linkSchedule != "all_pairs" && c.linkSchedule != "tdma" &&
+        c.linkSchedule != "random_k" && c.linkSchedule != "nearest_k") {
+      throw std::runtime_error("Unknown link_schedule: " + c.linkSchedule);
+    }
+    c.linkScheduleK = a.value("link_schedule_k", c.linkScheduleK);
+    if (c.linkScheduleK == 0) {
+      throw std::runtime_error("link_schedule_k must be at least 1");
+    }
+    c.asyncPipeline = a.value("async_pipeline", c.asyncPipeline);
+    if (c.asyncPipeline && c.workerThreads < 2) {
+      throw std::runtime_error("async_pipeline needs worker_threads >= 2");
+    }
+    c.offlinePings = a.value("offline_pings", c.offlinePings);
+    if (c.offlinePings && c.asyncPipeline) {
+      throw std::runtime_error(
+          "offline_pings and async_pipeline are mutually exclusive");
+    }
+    c.landmarkAtlas = a.value("landmark_atlas", c.landmarkAtlas);
+    c.atlas.maxRangeM = a.value("atlas_max_range_m", c.atlas.maxRangeM);
+    c.atlas.rangeStepM = a.value("atlas_range_step_m", c.atlas.rangeStepM);
+    c.atlas.depthStepM = a.value("atlas_depth_step_m", c.atlas.depthStepM);
+    c.atlas.bearingStepDeg =
+        a.value("atlas_bearing_step_deg", c.atlas.bearingStepDeg);
+    if (c.atlas.maxRangeM <= 0.0 || c.atlas.rangeStepM <= 0.0 ||
+        c.atlas.depthStepM <= 0.0 || c.atlas.bearingStepDeg <= 0.0) {
+      throw std::runtime_error("atlas_* extents and steps must be positive");
+    }
+    c.landmarkRayBundle = a.value("landmark_ray_bundle", c.landmarkRayBundle);
+    if (c.landmarkRayBundle && c.landmarkAtlas) {
+      throw std::runtime_error(
+          "landmark_ray_bundle and landmark_atlas are mutually exclusive");
+    }
+    c.rayBundle.maxRangeM =
+        a.value("ray_bundle_max_range_m", c.rayBundle.maxRangeM);
+    c.rayBundle.pointSpacingM =
+        a.value("ray_bundle_point_spacing_m", c.rayBundle.pointSpacingM);
+    c.rayBundle.maxMissM =
+        a.value("ray_bundle_max_miss_m", c.rayBundle.maxMissM);
+    if (c.rayBundle.maxRangeM <= 0.0 || c.rayBundle.pointSpacingM <= 0.0 ||
+        c.rayBundle.maxMissM <= 0.0) {
+      throw std::runtime_error("ray_bundle_* settings must be positive");
+    }
+    // Atlas grids, ray bundles and the ray-mode debug dumps are not covered
+    // by the automatic estimate
+    if ((c.landmarkAtlas || c.landmarkRayBundle ||
+         c.debugRangeErrorPct > 0.0) &&
+        c.bellhopMemoryMib == 0) {
+      throw std::runtime_error(
+          "landmark_atlas, landmark_ray_bundle and debug_range_error_pct need "
+          "an explicit bellhop_memory_mib");
+    }
+    c.straightRayFastPath =
+        a.value("straight_ray_fast_path", c.straightRayFastPath);
+    c.straightRay.stepM = a.value("straight_ray_step_m", c.straightRay.stepM);
+    c.straightRay.refractionCorrection = a.value(
+        "straight_ray_refraction_correction",
+        c.straightRay.refractionCorrection);
+    c.straightRay.maxErrorSec =
+        a.value("straight_ray_max_error_s", c.straightRay.maxErrorSec);
+    if (c.straightRay.stepM <= 0.0 || c.straightRay.maxErrorSec <= 0.0) {
+      throw std::runtime_error(
+          "straight_ray_step_m and straight_ray_max_error_s must be positive");
+    }
+    c.imageSourceModel = a.value("image_source_model", c.imageSourceModel);
+    if (c.imageSourceModel && !c.allowMultipath) {
+      throw std::runtime_error("image_source_model requires allow_multipath");
+    }
+    c.imageSource.maxSpeedSpreadMps = a.value(
+        "image_source_max_speed_spread_mps", c.imageSource.maxSpeedSpreadMps);
+    c.imageSource.maxBounces =
+        a.value("image_source_max_bounces", c.imageSource.maxBounces);
+    if (c.imageSource.maxSpeedSpreadMps < 0.0 ||
+        c.imageSource.maxBounces < 1) {
+      throw std::runtime_error("image_source_max_speed_spread_mps must be "
+                               "non-negative and image_source_max_bounces "
+                               "at least 1");
+    }
+    c.nx2dSlices = a.value("nx2d_slices", c.nx2dSlices);
+    c.nx2d.maxCrossGradient =
+        a.value("nx2d_max_cross_gradient", c.nx2d.maxCrossGradient);
+    c.nx2d.rangeStepM = a.value("nx2d_range_step_m", c.nx2d.rangeStepM);
+    c.nx2d.rangeExtent = a.value("nx2d_range_extent", c.nx2d.rangeExtent);
+    if (c.nx2d.maxCrossGradient < 0.0 || c.nx2d.rangeStepM <= 0.0 ||
+        c.nx2d.rangeExtent < 1.0) {
+      throw std::runtime_error("nx2d_max_cross_gradient must be non-negative, "
+                               "nx2d_range_step_m positive and "
+                               "nx2d_range_extent at least 1");
+    }
+    c.fidelity.rangeErrorBudgetM =
+        a.value("range_error_budget_m", c.fidelity.rangeErrorBudgetM);
+    c.fidelity.spotCheckInterval = a.value("fidelity_spot_check_interval",
+                                           c.fidelity.spotCheckInterval);
+    c.fidelity.calibrationWeight = a.value("fidelity_calibration_weight",
+                                           c.fidelity.calibrationWeight);
+    if (c.fidelity.calibrationWeight <= 0.0 ||
+        c.fidelity.calibrationWeight > 1.0) {
+      throw std::runtime_error(
+          "fidelity_calibration_weight must be in (0, 1]");
+    }
+    c.keyframes = a.value("keyframes", c.keyframes);
+    c.keyframe.maxIntervalSec =
+        a.value("keyframe_max_interval_s", c.keyframe.maxIntervalSec);
+    c.keyframe.maxResidualM =
+        a.value("keyframe_max_residual_m", c.keyframe.maxResidualM);
+    if (c.keyframe.maxIntervalSec < 0.0 || c.keyframe.maxResidualM < 0.0) {
+      throw std::runtime_error("keyframe_max_interval_s and "
+                               "keyframe_max_residual_m must be non-negative");
+    }
+    c.budget.pingSeconds = a.value("ping_budget_s", c.budget.pingSeconds);
+    c.budget.pingRays = a.value("ping_budget_rays", c.budget.pingRays);
+    c.budget.linkSeconds = a.value("link_budget_s", c.budget.linkSeconds);
+    c.budget.linkRays = a.value("link_budget_rays", c.budget.linkRays);
+    if (c.budget.pingSeconds < 0.0 || c.budget.pingRays < 0 ||
+        c.budget.linkSeconds < 0.0 || c.budget.linkRays < 0) {
+      throw std::runtime_error("ping_budget_s, ping_budget_rays, "
+                               "link_budget_s and link_budget_rays must be "
+                               "non-negative");
+    }
   }
 
   if (j.contains("sensors")) {
@@ -8,14 +8,32 @@
 #include "acoustics/Arrival.h"
 #include "acoustics/BellhopContext.h"
 #include "acoustics/helpers.h"
+#include "mantaray/sim/BellhopWorkerPool.h"
+#include "mantaray/sim/FidelityScheduler.h"
+#include "mantaray/sim/ImageSourceModel.h"
+#include "mantaray/sim/KeyframeTrack.h"
+#include "mantaray/sim/LinkSchedule.h"
+#include "mantaray/sim/MetricEnvironment.h"
+#include "mantaray/sim/PersistentTofCache.h"
+#include "mantaray/sim/PingBudget.h"
+#include "mantaray/sim/RayBundle.h"
+#include "mantaray/sim/StraightRayEstimator.h"
+#include "mantaray/sim/SpatialHash.h"
+#include "mantaray/sim/TofCache.h"
+#include "mantaray/sim/TofLadder.h"
+#include "mantaray/sim/TravelTimeAtlas.h"
 #include "mantaray/utils/Logger.h"
 #include "rb/RbWorld.h"
 
 #include "fmt/format.h"
 #include <cmath>
 #include <cstring>
+#include <future>
 #include <map>
+#include <optional>
+#include <random>
 #include <stdexcept>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -27,6 +45,16 @@ namespace sim {
 /** @brief Selects one-way or two-way time-of-flight scaling. */
 enum class GlobalTofMode { kOneWay, kTwoWay };
 
+/** @brief How acquireTof() grows the beam fan between refinement levels. */
+enum class BeamRefinement {
+  /// Retrace the whole fan at kBeamIterativeFactor times the beams
+  kDoubling,
+  /// Interleave new angles between the previous level's and trace only those
+  kNested,
+  /// Re-aim a narrow dense fan along the source-receiver line, then double
+  kZoom
+};
+
 /**
  * @brief Outcome of a single range measurement attempt.
  */
@@ -43,6 +71,14 @@ enum class RangeStatus {
   kNoArrival,
   /// Sound speed profile query returned invalid value
   kSspSampleFailed,
+  /// Link is backing off after repeated failures
+  kSkippedBackoff,
+  /// Endpoints are farther apart than the max link range
+  kSkippedOutOfRange,
+  /// The link schedule left this link out of the ping
+  kSkippedNotScheduled,
+  /// The ping or link compute budget ran out before a TOF was found
+  kBudgetExceeded,
 };
 
 /** @brief Sentinel value for invalid or unavailable distance/speed/TOF fields.
@@ -88,20 +124,147 @@ struct RangeMeasurement {
 
 /// @brief Diagnostic output from the iterative beam solver.
 struct TofConvergenceInfo {
-  /// Bellhop runs executed (1 = no retry)
+  /// Refinement levels tried (1 = no retry)
   int iterations{1};
-  /// Beam count at resolution (or last tried)
-  int finalBeams{0};
+  /// Bellhop runs executed for this link; a nested level takes two
+  int bellhopRuns{0};
+  /// Beam counts at resolution (or last tried); the widened fan for fan-out
+  acoustics::BeamCounts finalBeams{0, 0};
   /// True if TOF converged within tolerance
   bool converged{false};
   /// True if result came from reciprocal cache
   bool fromCache{false};
   /// True if accepted TOF was from multipath
   bool multipathUsed{false};
+  /// True if TOF came from a shared multi-receiver run of the pinger
+  bool fromFanOut{false};
+  /// True if TOF came from the cross-ping TofCache
+  bool fromSpatialCache{false};
+  /// True if TOF came from the target landmark's TravelTimeAtlas or RayBundle
+  bool fromPrecomputed{false};
+  /// True if TOF came from the StraightRayEstimator without a Bellhop run
+  bool fromStraightRay{false};
+  /// True if TOF came from the ImageSourceModel without a Bellhop run
+  bool fromImageSource{false};
+  /// True if TOF came from a 2D run on the link's bearing slice
+  bool fromSlice{false};
+  /// True if TOF was predicted from the link's KeyframeTrack
+  bool fromKeyframe{false};
+  /// True if the ping or link budget stopped the solve; with iterations 0
+  /// the link was never traced
+  bool budgetExceeded{false};
   /// |TOF_curr - TOF_prev| at final comparison
   float lastDelta{0.0f};
 };
 
+/**
+ * @brief Acceptance and sampling settings of the Nx2D slice tier.
+ */
+struct Nx2DConfig {
+  /// Largest cross-bearing sound-speed gradient (1/s) a slice may ignore
+  double maxCrossGradient{1.0e-3};
+  /// Range spacing of the slice and of the gradient samples (m)
+  double rangeStepM{50.0};
+  /// Slice extent as a multiple of the link's horizontal range
+  double rangeExtent{1.5};
+};
+
+/**
+ * @brief Construction options for AcousticPairwiseRangeSystem.
+ */
+struct RangeSystemConfig {
+  /// One-way or two-way TOF scaling
+  GlobalTofMode mode{GlobalTofMode::kOneWay};
+  /// Accept converged multipath TOF as fallback when no direct path is found
+  bool allowMultipath{false};
+  /// Store failed measurements too; by default only successes are logged
+  bool logAllMeasurements{false};
+  /// When > 0, dump ray trace env files for measurements with range error
+  /// exceeding this percentage; queued until writeDebugDumps()
+  double debugRangeErrorPct{0.0};
+  /// Directory for debug ray trace output files
+  std::string debugOutputDir{};
+  /// Trace all targets of a pinger in a single multi-receiver Bellhop run
+  /// before falling back to per-link refinement
+  bool fanOutPerPinger{false};
+  /// Most targets in one fan-out run; n targets can cost up to n^3 receivers
+  size_t fanOutMaxTargets{4};
+  /// Position tolerance (m) for reusing TOFs across pings; <= 0 disables.
+  /// See TofCache.
+  double tofCacheToleranceM{0.0};
+  /// Directory of a PersistentTofCache backing the TofCache across runs;
+  /// empty disables. Needs tofCacheToleranceM > 0.
+  std::string persistentTofCacheDir{};
+  /// Slots of a newly created persistent cache file
+  size_t persistentTofCacheSlots{size_t{1} << 18};
+  /// Start each link's refinement at the beam level it last succeeded at
+  bool beamWarmStart{false};
+  /// Cap on pings skipped by a repeatedly failing link; <= 0 disables backoff
+  int failureBackoffMaxPings{0};
+  /// Beam growth strategy between refinement levels
+  BeamRefinement beamRefinement{BeamRefinement::kDoubling};
+  /// Half-width (deg) of the first zoomed fan; each further zoom shrinks it
+  /// by kBeamIterativeFactor
+  double zoomWindowDeg{1.0};
+  /// Only pairs closer than this (m) are linked and pinged; <= 0 links all
+  double maxLinkRangeM{0.0};
+  /// Extra neighbour-list radius (m) covering motion between refreshes
+  double linkSkinM{0.0};
+  /// Subset of links fired on each ping
+  LinkSchedule schedule{LinkSchedule::kAllPairs};
+  /// Targets per pinger for kRandomK and kNearestK
+  size_t scheduleK{4};
+  /// Seed of the kRandomK draws, independent of the world's RNG
+  uint64_t scheduleSeed{0};
+  /// Trace pings on a background thread while the caller keeps simulating;
+  /// see AcousticPairwiseRangeSystem::updateAsync(). Needs >= 2 workers.
+  bool asyncPipeline{false};
+  /// Resolve robot-landmark links from atlases built by
+  /// buildLandmarkAtlases()
+  bool landmarkAtlas{false};
+  /// Atlas receiver grid, used when landmarkAtlas is set
+  AtlasGridConfig atlas{};
+  /// Resolve robot-landmark links from ray fans built by
+  /// buildLandmarkRayBundles()
+  bool landmarkRayBundle{false};
+  /// Ray fan extent and eigenray search, used when landmarkRayBundle is set
+  RayBundleConfig rayBundle{};
+  /// Try the StraightRayEstimator before Bellhop on every unresolved link
+  bool straightRayFastPath{false};
+  /// Straight-ray quadrature and error threshold, used when
+  /// straightRayFastPath is set
+  StraightRayConfig straightRay{};
+  /// With allowMultipath, try the ImageSourceModel before Bellhop
+  bool imageSourceModel{false};
+  /// Isovelocity tolerance and bounce limit, used when imageSourceModel is set
+  ImageSourceConfig imageSource{};
+  /// Trace links with weak cross-bearing gradients as 2D bearing slices.
+  /// Needs BellhopWorkerPool::enableSlices().
+  bool nx2dSlices{false};
+  /// Slice sampling and gradient threshold, used when nx2dSlices is set
+  Nx2DConfig nx2d{};
+  /// Range-error budget and spot checks deciding which enabled engine
+  /// resolves each link; see FidelityScheduler
+  FidelityConfig fidelity{};
+  /// Predict each link's TOF between keyframe solves; see KeyframeTrack
+  bool keyframes{false};
+  /// Time and residual bounds forcing a keyframe, used when keyframes is set
+  KeyframeConfig keyframe{};
+  /// Wall-clock and ray limits per ping and per link; see PingBudget
+  BudgetConfig budget{};
+};
+
+/**
+ * @brief Link-pings skipped because an endpoint had died, counted instead of
+ * logged as measurements.
+ */
+struct DeadLinkSkips {
+  /// Would have been logged as kSkippedPingerDead
+  size_t pingerDead{0};
+  /// Would have been logged as kSkippedTargetDead
+  size_t targetDead{0};
+};
+
 /**
  * @brief Directed link between two endpoints.
  *
@@ -141,21 +304,234 @@ struct RangeLink {
  * Convergence is required — two successive beam levels must agree within
  * combined absolute + relative tolerance:
  * @code
- *   |TOF_new - TOF_prev| < kTofConvergenceAtol + kTofConvergenceRtol *
- * |TOF_prev|
+ *   |TOF_new - TOF_prev| < TofLadder::kConvergenceAtol +
+ *                          TofLadder::kConvergenceRtol * |TOF_prev|
  * @endcode
  * Unconverged multipath results are rejected as kNoArrival.
  *
- * The beam count is scaled by kBeamIterativeFactor on each iteration and
- * clamped to `AcousticsBuilder::getMaxBeams()`. After the loop completes,
+ * The beam count of each axis (elevation and bearing) is scaled by
+ * kBeamIterativeFactor on each iteration and clamped to that axis's entry of
+ * `AcousticsBuilder::getMaxBeams()`, so the axes grow independently until
+ * both reach their caps. After the loop completes,
  * the beam count is restored to its original value for subsequent links.
  *
+ * With BeamRefinement::kNested, level N grows to 2N - 1 beams per axis so the
+ * old angles are a subset of the new ones. Only the added rays are traced
+ * (see acoustics::BeamSubset) and their arrivals are merged with those already
+ * found, which saves about a quarter of the rays per 3D level. An axis that
+ * has reached its cap adds no rays; one that would pass it is clamped and the
+ * level is traced whole.
+ *
+ * With BeamRefinement::kZoom, a level without a direct path is followed by a
+ * fan of the same beam count squeezed to ±`zoom_window_deg` around the
+ * straight source-receiver line (see AcousticsBuilder::zoomBeam()), shrinking
+ * by kBeamIterativeFactor for up to kMaxZoomLevels zooms. If none of them
+ * finds a direct path, the link continues up the full-fan ladder to
+ * `max_beams`. Zoomed levels only look for a direct path: a multipath TOF
+ * still needs two successive full-fan levels to agree (see TofLadder).
+ *
+ * @section pinger_fan_out Pinger Fan-Out
+ *
+ * With `fan_out_per_pinger` enabled, every live target of a pinger is placed
+ * as a receiver of one Bellhop run (see
+ * AcousticsBuilder::updateSourceAndReceivers()). Targets that get a direct
+ * path from the shared run are accepted; the rest go through the per-link
+ * iterative refinement above.
+ *
+ * Bellhop computes arrivals on the full range x depth x bearing product of
+ * the targets, so a pinger's targets are split into groups of at most
+ * `fan_out_max_targets`. Sorted by bearing, a group also closes once its
+ * bearings or elevations would spread wider than a fan at single-link
+ * density can cover within `max_beams`. Groups of one target are left to
+ * per-link refinement. Liveness and bounds checks always run first in
+ * link order, so robots are marked dead exactly as without fan-out.
+ *
+ * @section parallel_links Parallel Links
+ *
+ * Fan-out groups and per-link refinement are distributed over a
+ * BellhopWorkerPool. Each worker traces with its own context and builder
+ * replica and writes only its own links' results, which are then committed in
+ * link order, so the measurement log does not depend on thread timing.
+ *
+ * @section async_pipeline Asynchronous Pipeline
+ *
+ * updateAsync() plans a ping on the caller's thread and traces it on a
+ * background thread, so physics advances toward the next event meanwhile. At
+ * most one ping is in flight; the next ping, flush(), or a link-graph refresh
+ * in checkBounds() waits for it and commits it in ping order.
+ *
+ * @section landmark_atlas Landmark Atlases
+ *
+ * Landmarks never move, so buildLandmarkAtlases() traces each one once onto a
+ * dense polar receiver grid (see TravelTimeAtlas). Robot-landmark links are
+ * then resolved by interpolation, ahead of any Bellhop run; only positions
+ * where the atlas lacks a direct path (or, with `allow_multipath`, any path)
+ * fall through to the per-link solver.
+ *
+ * buildLandmarkRayBundles() is the grid-free alternative: each landmark's
+ * fan is traced once in Bellhop ray mode and kept as a RayBundle, and a
+ * robot's TOF is interpolated from the rays passing closest to it.
+ *
+ * @section straight_ray Straight-Ray Fast Path
+ *
+ * Short, steep or near-vertical direct paths are nearly straight. With
+ * `straight_ray_fast_path` set, every link still unresolved after the caches
+ * and landmark lookups is first estimated by StraightRayEstimator, which
+ * integrates slowness along the segment through the SSP grid. The estimate
+ * is accepted as the direct-path TOF when its error estimate is below
+ * `straight_ray_max_error_s`. Otherwise the link goes to Bellhop as usual.
+ *
+ * @section image_source Image-Source Multipath
+ *
+ * In shallow near-isovelocity water, bounced arrivals follow from mirroring
+ * the source in a flat surface and bottom. With `image_source_model` and
+ * `allow_multipath` both set, ImageSourceModel is tried after the straight-ray
+ * fast path. It returns the same ArrivalPair as a Bellhop run, and the usual
+ * rule picks from it: the direct path if the segment clears the seafloor,
+ * otherwise the fastest image path as multipath. Columns whose sound-speed
+ * spread exceeds `image_source_max_speed_spread_mps` go to Bellhop.
+ *
+ * @section nx2d_slices Nx2D Bearing Slices
+ *
+ * A 3D run fans rays over every bearing, but where the ocean barely changes
+ * across a link's bearing, the vertical plane through both endpoints holds
+ * the rays that matter. With `nx2d_slices` set, each link that reaches
+ * Bellhop first has the largest cross-bearing sound-speed gradient along its
+ * track measured. Below `nx2d_max_cross_gradient` the link is traced once in
+ * a per-worker 2D context on that plane: a range-dependent SSP and
+ * bathymetry sampled every `nx2d_range_step_m`, see SliceBuilder. The
+ * elevation fan is the 3D fan's, at its maximum beam count. Only a direct
+ * arrival is accepted, since one run cannot confirm a multipath TOF;
+ * otherwise the link falls back to the 3D refinement ladder.
+ *
+ * @section fidelity_scheduler Multi-Fidelity Scheduling
+ *
+ * With `range_error_budget_m` set, FidelityScheduler replaces the separate
+ * thresholds of the cheap engines with one range-error budget. Every engine
+ * turns its geometry into an error heuristic in meters:
+ * - lookups: the TofCache tolerance, or nothing for landmark lookups
+ * - straight ray: the estimator's error bound times the mean sound speed
+ * - image sources: TOF times half the accepted sound-speed spread
+ * - Nx2D: the chord lengthening from the cross-bearing gradient
+ *
+ * The engines are still tried cheapest first, and the first whose calibrated
+ * prediction is within budget resolves the link. Each ping, one link in
+ * `fidelity_spot_check_interval` is traced in 3D as well. The cheap TOF is
+ * held back, and the 3D result both goes out as the measurement and
+ * recalibrates the engine's heuristic scale. In rotation, a spot check also
+ * samples a cheap engine the scheduler rejected, so one outlier cannot lock
+ * an engine out for good. Engines stay opt-in: the
+ * scheduler only decides between those whose own flags are set.
+ *
+ * @section keyframes Keyframe Prediction
+ *
+ * When pings come much faster than the geometry changes, `keyframes` solves
+ * each link only at keyframes. In between, its TOF is predicted ahead of
+ * every other engine from the last two keyframe solves and the current
+ * endpoint distance, see KeyframeTrack. A keyframe is forced once
+ * `keyframe_max_interval_s` has passed or the residual exceeds
+ * `keyframe_max_residual_m`. A failed solve clears the link's track. Offline
+ * epochs are solved independently, so they never predict.
+ *
+ * @section link_schedules Link Schedules
+ *
+ * By default every link fires on every ping, so Bellhop load grows with the
+ * square of the team size. `link_schedule` fires a subset instead, chosen in
+ * planning among links whose endpoints are both alive:
+ * - `all_pairs`: every link (default)
+ * - `tdma`: one pinger per ping, in turn, with all of its links. Each ping is
+ *   then one TDMA slot of `ping_interval_min`. Every robot owns the slot of
+ *   its index for the whole run, so a frame is one slot per robot, and the
+ *   slot of a dead robot or one with no live links stays idle.
+ * - `random_k`: `link_schedule_k` targets per pinger, drawn afresh each ping
+ *   from an RNG seeded by `rng_seed`
+ * - `nearest_k`: each pinger's `link_schedule_k` nearest targets
+ *
+ * Links left out get status kSkippedNotScheduled. The reciprocal shortcut
+ * still applies when both directions of a robot pair are scheduled.
+ *
+ * @section compute_budget Compute Budget
+ *
+ * One pathological link can hold a ping for minutes while its ladder climbs
+ * to the maximum beam count. A BudgetConfig bounds the tracing of a ping
+ * (`ping_budget_s`, `ping_budget_rays`) and of each link (`link_budget_s`,
+ * `link_budget_rays`). With any limit set, links are traced cheapest first:
+ * planning scores each one by range, start beam count and recent failures,
+ * so short links likely to find a direct path at the first level go ahead
+ * of the rest; fan-out groups are ordered the same way. A ray limit is
+ * shared out before tracing starts: in that order, each fan-out group
+ * reserves its run, then each link its first level, then the remainder
+ * tops links up to their whole ladder. Each link then answers only to its
+ * own share, so the links traced and their results do not depend on the
+ * worker count. Wall-clock limits are shared live and are inherently
+ * timing dependent. Budgets are checked between Bellhop runs. A link whose own
+ * or whose ping's budget runs out mid-ladder stops there, and links not
+ * yet started when the ping's budget runs out are not traced at all. Both
+ * get status kBudgetExceeded. Either cut says nothing about the link, so
+ * its backoff, warm-start and keyframe state are kept and nothing is
+ * cached. Offline epochs each get their own ping budget.
+ *
+ * @section offline_pings Offline Epochs
+ *
+ * Ground truth never depends on acoustic results; only out-of-bounds deaths
+ * feed back, and planning decides those geometrically. recordPing() therefore
+ * plans each ping while physics runs and stores the endpoint positions, and
+ * solveRecorded() traces every recorded epoch as an independent job across
+ * the whole pool before committing them in time order. Epochs are solved
+ * cold: no TofCache, warm start, or backoff carries between them, so counts
+ * of Bellhop runs can differ from the online modes, though every direct-path
+ * TOF is the one a cold online ping would find.
+ *
+ * Physics is deterministic for a given config, so the epochs can also be split
+ * across processes: `mantaray_core config.json --shard K/N` re-runs physics,
+ * traces every Nth epoch starting at K, and writes a partial PFG file that
+ * `pfg_merge` combines with the other shards' (see pyfg::mergePfgShards()).
+ *
  * Configuration (via JSON `"acoustics"` block):
- * - `num_beams`: initial beam count per axis (default 80)
- * - `max_beams`: maximum beam count for iterative refinement (default 180)
- * - `beam_spread_deg`: half-cone angle in degrees (default 20.0)
+ * - `num_beams`: initial elevation beam count (default 80)
+ * - `max_beams`: maximum elevation beam count for iterative refinement
+ *   (default 180)
+ * - `beam_spread_deg`: elevation half-cone angle in degrees (default 20.0)
+ * - `num_bearing_beams`, `max_bearing_beams`, `bearing_spread_deg`: the same
+ *   for the bearing axis (default: the elevation values; an unset
+ *   `max_bearing_beams` is raised to `num_bearing_beams` if that is larger).
+ *   Initial counts may not exceed their caps.
  * - `allow_multipath`: accept converged multipath TOF as fallback (default
  *   false)
+ * - `fan_out_per_pinger`: batch each pinger's targets into one run (default
+ *   false)
+ * - `tof_cache_tolerance_m`: reuse TOFs across pings when both endpoints
+ *   moved less than this (default 0, disabled)
+ * - `persistent_tof_cache_dir`: also keep them in a memory-mapped file
+ *   shared by every run of the same environment (default empty, disabled)
+ * - `beam_warm_start`: start each link at its last successful beam level
+ *   (default false)
+ * - `failure_backoff_max_pings`: cap on exponential backoff for links that
+ *   keep failing (default 0, disabled)
+ * - `beam_refinement`: `"doubling"` (default), `"nested"` or `"zoom"`
+ * - `zoom_window_deg`: half-width of the first zoomed fan (default 1.0)
+ * - `max_link_range_m`: only link and ping pairs closer than this (default 0,
+ *   all pairs)
+ * - `link_skin_m`: neighbour-list margin for motion between bounds checks
+ *   (default 0)
+ * - `async_pipeline`: overlap tracing with physics via updateAsync()
+ *   (default false, needs `worker_threads >= 2`)
+ * - `offline_pings`: record every ping during physics and trace them all
+ *   afterwards via recordPing() / solveRecorded() (default false)
+ * - `landmark_atlas`: precompute per-landmark travel-time atlases (default
+ *   false); `atlas_max_range_m`, `atlas_range_step_m`, `atlas_depth_step_m`,
+ *   `atlas_bearing_step_deg` set its grid
+ * - `landmark_ray_bundle`: keep each landmark's traced ray fan in memory
+ *   instead (default false); `ray_bundle_max_range_m`,
+ *   `ray_bundle_point_spacing_m`, `ray_bundle_max_miss_m` tune it
+ * - `straight_ray_fast_path`: try the straight-ray estimate before Bellhop
+ *   (default false); `straight_ray_step_m`,
+ *   `straight_ray_refraction_correction`, `straight_ray_max_error_s` tune it
+ * - `image_source_model`: with `allow_multipath`, try the image-source model
+ *   before Bellhop (default false); `image_source_max_speed_spread_mps`,
+ *   `image_source_max_bounces` tune it
+ *
+ * Top-level keys `worker_threads` and `bellhop_threads` size the pool.
  *
  * @see AcousticsBuilder::rebuildBeam(), AcousticsBuilder::getMaxBeams()
  */
@@ -165,41 +541,35 @@ public:
   /// step.
   static constexpr double kBeamIterativeFactor{2.0};
 
-  /// @brief Absolute TOF convergence tolerance (seconds).
-  /// ~15cm range error at 1500 m/s.
-  static constexpr double kTofConvergenceAtol{1e-3};
-
-  /// @brief Relative TOF convergence tolerance.
-  static constexpr double kTofConvergenceRtol{1e-3};
+  /// @brief Zoomed fans tried per link before giving up.
+  static constexpr int kMaxZoomLevels{3};
 
   /**
    * @brief Constructs the range system.
    *
-   * @param builder Acoustics builder that manages source/receiver placement
-   * @param context Bellhop context for ray tracing
-   * @param mode One-way or two-way TOF scaling
-   * @param allowMultipath When true, accept converged multipath TOF as
-   *        fallback when no direct path is found
-   * @param logAllMeasurements When true, failed measurements are also stored;
-   *        when false (default), only successful measurements are logged
-   * @param debugRangeErrorPct When > 0, dump ray trace env files for
-   *        measurements with range error exceeding this percentage
-   * @param debugOutputDir Directory for debug ray trace output files
+   * @param pool Bellhop workers; worker 0 also handles bounds checks, SSP
+   *        sampling, and debug dumps
+   * @param config Ranging options, see RangeSystemConfig
    */
-  AcousticPairwiseRangeSystem(acoustics::AcousticsBuilder &builder,
-                              acoustics::BhContext<true, true> &context,
-                              GlobalTofMode mode, bool allowMultipath = false,
-                              bool logAllMeasurements = false,
-                              double debugRangeErrorPct = 0.0,
-                              std::string debugOutputDir = "");
+  AcousticPairwiseRangeSystem(BellhopWorkerPool &pool,
+                              RangeSystemConfig config);
 
   /**
-   * @brief Builds full pairwise links with each robot as pinger.
+   * @brief Builds pairwise links with each robot as pinger.
    *
    * @details Creates directed links for:
    * - robot -> every other robot
    * - robot -> every landmark
    *
+   * With `maxLinkRangeM > 0` only live robots are pingers, and only targets
+   * within `maxLinkRangeM + linkSkinM` are linked, found with a SpatialHash
+   * in O(N) rather than by checking every pair. Links that survive a rebuild
+   * keep their warm-start and backoff state.
+   *
+   * Deaths do not need a rebuild: markRobotDead() drops the robot's links
+   * from the active set itself. Call this again only for structural changes,
+   * such as added robots, or to refresh range-gated neighbour lists.
+   *
    * The robot is always assigned as the pinger so that the sound speed
    * profile (SSP) is sampled at the robot's position — the unknown being
    * estimated. For robot-landmark links this means the pinger is the robot
@@ -209,28 +579,71 @@ public:
    */
   void rebuildPairs(const rb::RbWorld &world);
 
+  /**
+   * @brief Traces a TravelTimeAtlas around every landmark, one landmark per
+   * pool job. Call once before pinging; landmarks out of bounds get none.
+   * Does nothing unless RangeSystemConfig::landmarkAtlas is set.
+   *
+   * @details Each run uses the allocated ceiling of beams over all bearings,
+   * and Bellhop stores arrivals for every cell, so large grids may need a
+   * bigger `bellhop_memory_mib`.
+   *
+   * @param world The simulation world containing landmarks
+   */
+  void buildLandmarkAtlases(const rb::RbWorld &world);
+
+  /**
+   * @brief Traces each landmark's all-around ray fan once in ray mode and
+   * keeps it as a RayBundle, one landmark per pool job.
+   *
+   * @details Does nothing unless RangeSystemConfig::landmarkRayBundle is set.
+   * Ray paths live in Bellhop's memory until copied, so long ranges or dense
+   * fans may need a bigger `bellhop_memory_mib`.
+   *
+   * @param world The simulation world containing landmarks
+   */
+  void buildLandmarkRayBundles(const rb::RbWorld &world);
+
   /**
    * @brief Lightweight boundary check that marks out-of-bounds robots as dead.
    *
    * @details Checks each alive robot's position against the acoustic domain
-   * boundaries without running Bellhop. Safe to call at physics-rate.
+   * boundaries without running Bellhop. Safe to call at physics-rate. With
+   * range gating enabled this also refreshes the neighbour lists via
+   * rebuildPairs(), so the skin must exceed how far two robots can close in
+   * one bounds-check interval.
    *
    * @param world The simulation world (robots may be modified)
    */
   void checkBounds(rb::RbWorld &world);
 
   /**
-   * @brief Dumps all necessary files to a text file to run with bellhop tool
-   * @details Can rerun these outputs with executable in
-   * src/tools/bhc_runner.cpp
+   * @brief Queues a debug ray trace of a measurement whose range error
+   * exceeds `debugRangeErrorPct`.
+   * @details Only the link geometry and beam counts are captured here; the
+   * trace itself runs in writeDebugDumps(), off the measurement path.
    * @param meas Populated measurement details
    * @param link Ranging link
    * @param simTimeSec Sim Time
-   * @param trueRange Actual range between rigid bodies (not bellhops)
+   * @param pingerPos Pinger position the measurement was taken at
+   * @param targetPos Target position the measurement was taken at
+   * @param beams Beam counts the measurement was solved at
+   */
+  void debugOutputRangeErrors(const RangeMeasurement &meas,
+                              const RangeLink &link, const std::string &tag,
+                              double simTimeSec,
+                              const Eigen::Vector3d &pingerPos,
+                              const Eigen::Vector3d &targetPos,
+                              const acoustics::BeamCounts &beams);
+
+  /**
+   * @brief Traces every queued debug dump in ray mode and writes its env
+   * file, one dump per pool job. Call once at the end of the run.
+   * @details Flushes any in-flight ping first. Each dump re-aims a worker's
+   * own builder and context, so the primary context never switches modes.
+   * The files can be rerun with src/tools/bhc_runner.cpp.
    */
-  void debugOutputRangeErrors(RangeMeasurement &meas, RangeLink &link,
-                              const std::string &tag, double simTimeSec,
-                              double trueRange);
+  void writeDebugDumps();
 
   /**
    * @brief Runs Bellhop on every active pair and appends measurements to the
@@ -242,6 +655,58 @@ public:
    */
   void update(double simTimeSec, rb::RbWorld &world);
 
+  /**
+   * @brief Starts a ping and returns while its Bellhop runs continue in the
+   * background.
+   *
+   * @details Planning runs here, on the caller's thread: liveness and bounds
+   * checks mark robots dead at this sim time, and endpoint positions are
+   * copied into the plan, so the world can keep advancing. Tracing then runs
+   * on pool workers 1..N-1, leaving worker 0 to checkBounds(). The previous
+   * ping is flushed first, so cache and warm-start state are exactly what
+   * update() would see and the log matches the synchronous one.
+   *
+   * @param simTimeSec Current simulation time in seconds
+   * @param world The simulation world (robots may be marked dead if out of
+   * bounds)
+   */
+  void updateAsync(double simTimeSec, rb::RbWorld &world);
+
+  /**
+   * @brief Waits for the in-flight ping, if any, and commits its measurements.
+   * @details Rethrows any exception raised while tracing. Call before reading
+   * getMeasurements() when using updateAsync().
+   */
+  void flush();
+
+  /// @brief Logs TofCache and PersistentTofCache totals; call at exit.
+  void logCacheStats() const;
+
+  /**
+   * @brief Plans a ping and stores it for solveRecorded() without tracing.
+   *
+   * @details Liveness and bounds checks run now, so robots are marked dead at
+   * this sim time exactly as update() would. See @ref offline_pings.
+   *
+   * @param simTimeSec Current simulation time in seconds
+   * @param world The simulation world (robots may be marked dead if out of
+   * bounds)
+   */
+  void recordPing(double simTimeSec, rb::RbWorld &world);
+
+  /**
+   * @brief Traces every recorded ping, one epoch per pool job, and appends
+   * their measurements in chronological order.
+   *
+   * @details With shardCount > 1 only epochs shardIndex, shardIndex +
+   * shardCount, ... are traced, so N processes running the same config split
+   * the epochs between them; the rest are discarded. See @ref offline_pings.
+   *
+   * @param shardIndex This process's shard, in [0, shardCount)
+   * @param shardCount Number of processes sharing the run
+   */
+  void solveRecorded(size_t shardIndex = 0, size_t shardCount = 1);
+
   /**
    * @brief Returns the flat chronological log of range measurements.
    * @return Const reference to the measurements vector
@@ -255,21 +720,325 @@ public:
    */
   [[nodiscard]] const std::vector<RangeLink> &getLinks() const noexcept;
 
+  /// @brief Number of links whose endpoints are both alive.
+  [[nodiscard]] size_t getActiveLinkCount() const noexcept {
+    return activeLinks_.size();
+  }
+
+  /// @brief Link-pings skipped for dead endpoints on pings after the death.
+  /// @details Links of a robot that dies during a ping's planning are still
+  ///          logged for the rest of that ping.
+  [[nodiscard]] const DeadLinkSkips &getDeadLinkSkips() const noexcept {
+    return deadSkips_;
+  }
+
 private:
+  /// @brief A cheap engine's TOF awaiting comparison with 3D.
+  struct SpotCheckSample {
+    TofEngine engine{TofEngine::kBellhop3D};
+    double heuristicM{0.0};
+    float tofRawSec{acoustics::kNoArrival};
+  };
+
+  /// @brief One link's work for the current ping, kept in link order.
+  struct PlannedLink {
+    /// Index into links_
+    size_t linkIdx{0};
+    /// Measurement record (holds the skip status of dropped links)
+    RangeMeasurement meas{};
+    /// Log tag for this measurement
+    std::string tag{};
+    /// False if the link was dropped during planning
+    bool active{false};
+    /// Endpoint positions at planning time
+    Eigen::Vector3d pingerPos{};
+    Eigen::Vector3d targetPos{};
+    /// Raw TOF once resolved (negative if no arrival)
+    float tofRawSec{acoustics::kNoArrival};
+    /// Solver diagnostics once resolved
+    TofConvergenceInfo info{};
+    /// True once tofRawSec and info are final
+    bool resolved{false};
+    /// Plan index of the reciprocal robot link supplying this TOF, if any
+    std::optional<size_t> reciprocalOf{};
+    /// Beam counts to start refinement at
+    acoustics::BeamCounts startBeams{0, 0};
+    /// True if a cheap engine's TOF is to be checked against 3D
+    bool spotCheck{false};
+    /// Engine sampled by the spot check even if the scheduler rejects it
+    TofEngine spotRejected{TofEngine::kBellhop3D};
+    /// Cheap TOF held back for the spot check
+    std::optional<SpotCheckSample> spotSample{};
+    /// Relative cost of tracing the link, for cheapest-first ordering
+    double expectedCost{0.0};
+    /// Rays of the ladder's first level, and of the whole ladder at most,
+    /// with any Nx2D slice run; set under a ping ray limit, see ladderRays()
+    int64_t openingRays{0};
+    int64_t maxRays{0};
+  };
+
+  /// @brief Refinement memory carried across pings for one link.
+  struct LinkRefinementState {
+    /// Beam level of the last successful solve
+    acoustics::BeamCounts lastBeams{0, 0};
+    /// Failed pings in a row
+    int consecutiveFailures{0};
+    /// Pings left to skip before retrying
+    int skipPings{0};
+    /// Recent solves for keyframe prediction
+    KeyframeTrack keyframes{};
+  };
+
+  BellhopWorkerPool &pool_;
   acoustics::AcousticsBuilder &builder_;
   acoustics::BhContext<true, true> &context_;
-  GlobalTofMode mode_{GlobalTofMode::kOneWay};
-  bool allowMultipath_{false};
-  bool logAllMeasurements_{false};
-  double debugRangeErrorPct_{0.0};
-  std::string debugOutputDir_;
+  RangeSystemConfig config_;
+  TofCache tofCache_;
   std::vector<RangeLink> links_{};
+  /// Parallel to links_
+  std::vector<LinkRefinementState> linkStates_{};
+  /// Indices into links_ of links whose endpoints are both alive
+  std::vector<size_t> activeLinks_{};
+  /// Position of each link in activeLinks_, or kInactiveLink; parallel to
+  /// links_
+  std::vector<size_t> activeSlots_{};
+  static constexpr size_t kInactiveLink = static_cast<size_t>(-1);
+  /// True after a removal left activeLinks_ out of link order
+  bool activeUnsorted_{false};
+  /// Indices into links_ of each robot's links, as pinger or target
+  std::vector<std::vector<size_t>> robotLinks_{};
+  /// Inactive links with a dead pinger, and with a live pinger but a dead
+  /// target; added to deadSkips_ on every ping
+  size_t deadPingerLinks_{0};
+  size_t deadTargetLinks_{0};
+  DeadLinkSkips deadSkips_{};
+
+  /// {pinger type, pinger index, target type, target index}
+  using LinkKey = std::tuple<EndpointType, size_t, EndpointType, size_t>;
+  static LinkKey linkKey(const RangeLink &link) {
+    return {link.pinger.type, link.pinger.index, link.target.type,
+            link.target.index};
+  }
   std::vector<RangeMeasurement> measurements_{};
+  /// Lowest pool worker that traces; 1 in async mode so worker 0 stays with
+  /// the caller's thread
+  size_t firstTraceWorker_{0};
+  /// Widest bearing and elevation spread of one fan-out group's targets
+  /// (radians); see AcousticsBuilder::fanTargetSpanRad()
+  double fanBearingSpanRad_{0.0};
+  double fanElevationSpanRad_{0.0};
+
+  FidelityScheduler scheduler_;
+  /// Pings planned so far; rotates spot checks and TDMA slots
+  size_t pingCount_{0};
+  /// Draws of the kRandomK schedule
+  std::mt19937_64 scheduleRng_;
+
+  /// @brief A ping whose Bellhop runs are in flight.
+  struct PendingPing {
+    double simTimeSec{0.0};
+    std::vector<PlannedLink> plan{};
+    int fanOutRuns{0};
+    std::future<void> traced{};
+  };
+  /// @brief A debug ray trace queued by debugOutputRangeErrors().
+  struct DebugDump {
+    RangeLink link{};
+    std::string tag{};
+    double simTimeSec{0.0};
+    Eigen::Vector3d pingerPos{};
+    Eigen::Vector3d targetPos{};
+    acoustics::BeamCounts beams{0, 0};
+  };
+  std::vector<DebugDump> debugDumps_{};
+
+  /// @brief Traces one dump in ray mode on a worker and writes its env file.
+  void writeDebugDump(BellhopWorker &worker, const DebugDump &dump) const;
+
+  /// @brief A ping planned by recordPing(), traced by solveRecorded().
+  struct RecordedPing {
+    double simTimeSec{0.0};
+    std::vector<PlannedLink> plan{};
+    int fanOutRuns{0};
+  };
+  std::vector<RecordedPing> recorded_{};
+  /// Indexed by landmark; empty where the landmark had no atlas
+  std::vector<std::optional<TravelTimeAtlas>> atlases_{};
+  /// Indexed by landmark; empty where the landmark had no bundle
+  std::vector<std::optional<RayBundle>> rayBundles_{};
+  /// Built from the primary builder's environment when straightRayFastPath
+  /// is set
+  std::optional<StraightRayEstimator> straightRay_{};
+  /// Built from the primary builder's environment when imageSourceModel and
+  /// allowMultipath are set
+  std::optional<ImageSourceModel> imageSource_{};
+  /// Built from the primary builder's environment when nx2dSlices is set
+  std::optional<MetricEnvironment> sliceEnvironment_{};
+  /// Opened when persistentTofCacheDir is set
+  std::optional<PersistentTofCache> persistentCache_{};
+
+  /// Declared after everything the tracer touches, so destruction joins it
+  /// first
+  std::optional<PendingPing> pending_{};
+
+  /// @brief Runs liveness and bounds checks in link order, marking robots
+  ///        dead. No Bellhop runs happen here.
+  std::vector<PlannedLink> planPing(double simTimeSec, rb::RbWorld &world);
+
+  /// @brief Marks the links config_.schedule fires on this ping.
+  /// @details Only active links are candidates; see selectScheduledLinks().
+  std::vector<bool> scheduleLinks(const rb::RbWorld &world);
+
+  /// @brief Beam settings that key the TofCache.
+  TofBeamSettings beamSettings() const;
+
+  /// @brief Resolves links whose KeyframeTrack can predict this ping.
+  void resolveFromKeyframes(std::vector<PlannedLink> &plan);
+
+  /// @brief Resolves links whose geometry is within tolerance of an earlier
+  ///        solve, with geometric correction.
+  void resolveFromCache(std::vector<PlannedLink> &plan);
+
+  /// @brief Precomputed TOFs from a landmark to a receiver, if the landmark
+  ///        has an atlas or ray bundle.
+  std::optional<acoustics::ArrivalPair>
+  landmarkLookup(size_t landmark, const Eigen::Vector3d &receiver) const;
+
+  /// @brief Resolves robot-landmark links from the landmark's atlas or ray
+  ///        bundle where it has a usable arrival.
+  void resolveFromLandmarks(std::vector<PlannedLink> &plan);
+
+  /// @brief Resolves links whose straight-ray estimate is within the error
+  ///        threshold, without Bellhop.
+  void resolveFromStraightRay(std::vector<PlannedLink> &plan);
+
+  /// @brief Resolves links the image-source model covers, without Bellhop.
+  void resolveFromImageSource(std::vector<PlannedLink> &plan);
+
+  /// @brief Budget check for a cheap engine's TOF, with the scheduler on.
+  /// @details A link due a spot check keeps the TOF as its spotSample
+  ///          instead, so it goes on to 3D. That happens if the engine is
+  ///          accepted, or if it is the link's spotRejected engine.
+  /// @return True if the engine should resolve the link now
+  bool scheduleCheap(PlannedLink &planned, TofEngine engine,
+                     double heuristicM, float tofRawSec) const;
+
+  /// @brief Engine that produced a resolved link's TOF.
+  /// @details The one place that maps TofConvergenceInfo's from* flags to
+  ///          engines; a new engine only needs adding here.
+  static TofEngine engineOf(const TofConvergenceInfo &info);
+
+  /// @brief Stores this ping's fresh solves in the TofCache, in link order.
+  void storeInCache(const std::vector<PlannedLink> &plan);
+
+  /// @brief Runs every Bellhop trace of a ping: fan-out, then per-link
+  ///        refinement and reciprocal copies.
+  /// @details Touches only the plan, the config, and pool workers from
+  ///          firstTraceWorker_ on, so it may run off the caller's thread.
+  /// @return Number of fan-out runs
+  int traceLinks(std::vector<PlannedLink> &plan);
+
+  /// @brief Serial tail of a ping: cache insert, link state, and commit.
+  void finishPing(double simTimeSec, std::vector<PlannedLink> &plan,
+                  int fanOutRuns);
+
+  /// @brief Records warm-start levels, failure backoff and keyframes from
+  ///        this ping.
+  /// @details Backoff skips 2^(n-1) - 1 pings after n consecutive failures,
+  ///          capped at failureBackoffMaxPings. Links the budget cut short
+  ///          are left untouched.
+  void updateLinkStates(const std::vector<PlannedLink> &plan);
+
+  /// @brief Traces a whole epoch serially on one worker.
+  /// @return Number of fan-out runs
+  int traceEpoch(BellhopWorker &worker, std::vector<PlannedLink> &plan);
+
+  /// @brief Plan indices of each fan-out group: a pinger's unresolved
+  ///        targets split into narrow bearing sectors, at least two each.
+  /// @details See @ref pinger_fan_out.
+  std::vector<std::vector<size_t>>
+  fanOutGroups(const std::vector<PlannedLink> &plan) const;
+
+  /// @brief Fan-out groups to trace, in budget order.
+  /// @details Under a budget the groups with the lowest summed expectedCost
+  ///          come first. With a ping ray limit each group then reserves its
+  ///          run, priced on builder, before any is traced; groups that do
+  ///          not fit are left to per-link tracing.
+  std::vector<std::vector<size_t>>
+  admitFanOut(const std::vector<PlannedLink> &plan, PingBudget &budget,
+              const acoustics::AcousticsBuilder &builder) const;
+
+  /// @brief Plan indices of active links still needing their own trace.
+  /// @details Cheapest expectedCost first when a budget is set, otherwise
+  ///          in link order.
+  std::vector<size_t> pendingLinks(const std::vector<PlannedLink> &plan) const;
+
+  /// @brief Rays each pending link may trace under a ping ray limit.
+  /// @details Reserved serially in pending order before any link starts, so
+  ///          the outcome does not depend on the worker count. Each link
+  ///          first reserves its opening level, so earlier ladders cannot
+  ///          starve later links; what is left then tops links up to their
+  ///          whole ladder in the same order. 0 leaves a link untraced.
+  /// @return One allowance per pending link, all 0 without a ping ray limit
+  std::vector<int64_t> reserveLinkRays(const std::vector<PlannedLink> &plan,
+                                       const std::vector<size_t> &pending,
+                                       PingBudget &budget) const;
+
+  /// @brief Rays of the first level of a ladder from startBeams, and an upper
+  ///        bound on the whole ladder, with the Nx2D slice run if enabled.
+  std::pair<int64_t, int64_t>
+  ladderRays(acoustics::BeamCounts startBeams) const;
+
+  /// @brief The level after beams: kBeamIterativeFactor times each axis, or
+  ///        one new angle between each pair when nested, clamped to maxBeams.
+  static acoustics::BeamCounts nextLevel(const acoustics::BeamCounts &beams,
+                                         const acoustics::BeamCounts &maxBeams,
+                                         bool nested);
+
+  /// @brief Resolves one link via its bearing slice if allowed, otherwise
+  ///        via acquireTof() on the given worker.
+  /// @details A link reached after the ping's time ran out, or left without
+  ///          rays by reserveLinkRays(), is resolved with no TOF and
+  ///          info.budgetExceeded set.
+  /// @param rayAllowance From reserveLinkRays(); 0 without a ping ray limit
+  void traceLink(BellhopWorker &worker, PlannedLink &planned,
+                 PingBudget &budget, int64_t rayAllowance);
+
+  /// @brief Traces the link's bearing slice in the worker's 2D context.
+  /// @param[out] runs Bellhop runs spent, even when nothing was accepted
+  /// @return False if the slice was not allowed or had no direct arrival
+  bool traceSlice(BellhopWorker &worker, PlannedLink &planned, int &runs);
+
+  /// @brief Copies resolved TOFs onto their reciprocal robot links.
+  static void copyReciprocals(std::vector<PlannedLink> &plan);
+
+  /// @brief Resolves each pinger's targets with one multi-receiver run.
+  /// @details Only direct-path results are accepted; the rest stay unresolved
+  ///          for per-link refinement. See @ref pinger_fan_out.
+  /// @return Number of Bellhop runs executed
+  int resolveFanOut(std::vector<PlannedLink> &plan, PingBudget &budget);
+
+  /// @brief Traces one pinger's targets (plan indices) in a single run.
+  /// @details Rays were reserved by admitFanOut(); only the clock is checked.
+  /// @return False if the ping's time had run out, leaving the targets
+  ///         unresolved
+  bool traceFanOut(BellhopWorker &worker, std::vector<PlannedLink> &plan,
+                   const std::vector<size_t> &members, PingBudget &budget);
+
+  /// @brief Resolves every remaining active link via acquireTof(), reusing
+  ///        reciprocal robot-pair results.
+  void resolvePlannedLinks(std::vector<PlannedLink> &plan,
+                           PingBudget &budget);
+
+  /// @brief Samples SSP, converts TOF to range, and logs in link order.
+  void commitPing(double simTimeSec, std::vector<PlannedLink> &plan,
+                  int fanOutRuns);
 
   /// @brief Append measurement to the log if logAllMeasurements_ is enabled.
   void maybeLog(const RangeMeasurement &meas);
 
   /// @brief Check if either endpoint is dead and skip the link if so.
+  /// @details The caller is responsible for logging the skipped measurement.
   /// @param[in]  world  Simulation world
   /// @param[in]  link   The link to check
   /// @param[out] meas   Measurement to populate with skip status
@@ -277,25 +1046,22 @@ private:
   bool skipIfDead(const rb::RbWorld &world, const RangeLink &link,
                   RangeMeasurement &meas);
 
-  /// @brief Check if two successive TOF values have converged.
-  /// @param curr Current TOF value (must be >= 0)
-  /// @param prev Previous TOF value (must be >= 0)
-  /// @param[out] delta Populated with |curr - prev| for logging
-  /// @return true if |curr - prev| < atol + rtol * |prev|
-  static bool checkTofConvergence(float curr, float prev, float &delta);
-
   /// @brief Acquire time-of-flight for a link via iterative beam refinement.
   /// @details Direct-path arrivals are accepted immediately. When
   /// allowMultipath_ is enabled, multipath arrivals require convergence
   /// across two successive beam levels. See @ref iterative_beam_solver.
-  /// @param[in]     link     The acoustic link
-  /// @param[in]     tag      Log tag for this measurement
-  /// @param[in,out] tofCache Cache of TOF values keyed by unordered robot pair
+  /// Source and receiver must already be aimed at the link.
+  /// @param[in] worker     Builder/context to trace with (aimed at the link)
+  /// @param[in] tag        Log tag for this measurement
+  /// @param[in] startBeams First ladder level, clamped per axis to
+  ///                       [getNumBeams(), getMaxBeams()]
+  /// @param[in,out] budget Charged per run; once exhausted, the ladder stops
+  ///                       with info.budgetExceeded set
   /// @return {TOF in seconds, convergence diagnostics}. TOF is negative if
   ///         no arrival found or multipath did not converge.
   std::pair<float, TofConvergenceInfo>
-  acquireTof(const RangeLink &link, const std::string &tag,
-             std::map<std::pair<size_t, size_t>, float> &tofCache);
+  acquireTof(BellhopWorker &worker, const std::string &tag,
+             acoustics::BeamCounts startBeams, PingBudget::Link &budget);
 
   /**
    * @brief Returns the TOF multiplier for the given mode.
@@ -312,11 +1078,16 @@ private:
   static bool isAlive(const rb::RbWorld &world, const RangeEndpoint &endpoint);
 
   /**
-   * @brief Marks a robot as dead by index.
+   * @brief Marks a robot as dead by index and drops its links from the
+   * active set in O(degree).
    * @param world The simulation world
    * @param robotIdx Index into the world's robot list
    */
-  static void markRobotDead(rb::RbWorld &world, size_t robotIdx);
+  void markRobotDead(rb::RbWorld &world, size_t robotIdx);
+
+  /// @brief Rebuilds activeLinks_, robotLinks_ and the dead-link counts
+  ///        from links_.
+  void rebuildActiveLinks(const rb::RbWorld &world);
 
   /**
    * @brief Resolves the 3D position of an endpoint.
@@ -0,0 +1,145 @@
+/** @file BellhopWorkerPool.h
+ * @brief Per-thread Bellhop context and builder replicas for parallel links
+ */
+
+#pragma once
+
+#include "acoustics/AcousticsBuilder.h"
+#include "acoustics/BellhopContext.h"
+#include "acoustics/EnvironmentSnapshot.h"
+#include "acoustics/SliceBuilder.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace sim {
+
+/**
+ * @brief Peak arrival storage a worker's 3D runs have needed.
+ */
+struct BellhopWorkerUsage {
+  /// 3D runs recorded
+  size_t runs{0};
+  /// Most receivers in one run
+  size_t peakReceivers{0};
+  /// Most arrivals stored at one receiver in any run
+  int32_t peakArrivals{0};
+  /// Arrival slots per receiver the context allocated (MaxNArr)
+  int32_t arrivalSlots{0};
+  /// Largest arrival storage one run filled (bytes)
+  size_t peakArrivalBytes{0};
+
+  /// @brief Folds one finished run into the peaks.
+  void note(const acoustics::Arrival &arrival);
+};
+
+/**
+ * @brief Builder and context pair that a single thread traces links with.
+ */
+struct BellhopWorker {
+  /// Builder bound to context's params
+  acoustics::AcousticsBuilder *builder{nullptr};
+  /// Bellhop state owned by this worker
+  acoustics::BhContext<true, true> *context{nullptr};
+  /// 2D builder for Nx2D slices, null unless the pool enabled slices
+  acoustics::SliceBuilder *sliceBuilder{nullptr};
+  /// 2D Bellhop state sliceBuilder is bound to
+  acoustics::BhContext<false, false> *sliceContext{nullptr};
+  /// Peak usage of context, for sizing bellhop_memory_mib
+  BellhopWorkerUsage usage{};
+};
+
+/**
+ * @brief Pool of independent Bellhop environments for thread-parallel links.
+ *
+ * @details Worker 0 is always the primary builder/context passed in, so a pool
+ * of one worker behaves exactly like the serial code path. Every additional
+ * worker owns a fresh BhContext and an AcousticsBuilder stamped from a single
+ * snapshot of the primary's environment (see AcousticsBuilder::snapshot()).
+ *
+ * Two levels of parallelism exist: workers here, and Bellhop's own ray
+ * threads inside each run (bhcInit::numThreads). Use
+ * bellhopThreadsPerWorker() to split the machine between them.
+ */
+class BellhopWorkerPool {
+public:
+  /**
+   * @param primaryBuilder Built builder used as worker 0 and as the template
+   *        for replicas
+   * @param primaryContext Context primaryBuilder is bound to
+   * @param init Bellhop init used for every replica context
+   * @param numWorkers Total workers including the primary (>= 1)
+   */
+  BellhopWorkerPool(acoustics::AcousticsBuilder &primaryBuilder,
+                    acoustics::BhContext<true, true> &primaryContext,
+                    const bhc::bhcInit &init, size_t numWorkers);
+
+  // Replicas are bound to their contexts, so the pool stays put
+  BellhopWorkerPool(const BellhopWorkerPool &) = delete;
+  BellhopWorkerPool &operator=(const BellhopWorkerPool &) = delete;
+  BellhopWorkerPool(BellhopWorkerPool &&) = delete;
+  BellhopWorkerPool &operator=(BellhopWorkerPool &&) = delete;
+
+  /// @brief Number of workers, including the primary.
+  [[nodiscard]] size_t size() const noexcept { return workers_.size(); }
+
+  /// @brief Worker by index; worker 0 is the primary builder/context.
+  [[nodiscard]] BellhopWorker &worker(size_t idx) { return workers_.at(idx); }
+
+  /**
+   * @brief Calls fn(worker, item) for every item in [0, numItems).
+   *
+   * @details Items are handed out dynamically so long Bellhop runs do not
+   * stall a static partition. Each worker is used by exactly one thread at a
+   * time. Runs inline on the first worker when only one worker or item is
+   * available. The first exception thrown by any item is rethrown after all
+   * threads join.
+   *
+   * fn must only write state owned by its item; callers merge results in
+   * item order afterwards to stay deterministic.
+   *
+   * @param firstWorker Lowest worker index to use; the calling thread acts as
+   *        this worker. Pass 1 to leave the primary free for another thread.
+   */
+  void parallelFor(size_t numItems,
+                   const std::function<void(BellhopWorker &, size_t)> &fn,
+                   size_t firstWorker = 0);
+
+  /**
+   * @brief Bellhop ray threads per context that avoid oversubscription.
+   * @param requested Explicit thread count; <= 0 selects automatically
+   * @param numWorkers Workers sharing the machine
+   * @return requested if positive, -1 (Bellhop's own default of all cores)
+   *         for a single worker, otherwise hardware threads / numWorkers
+   */
+  static int bellhopThreadsPerWorker(int requested, size_t numWorkers);
+
+  /**
+   * @brief Gives every worker a 2D context and SliceBuilder for Nx2D runs.
+   * @details Each slice fan has the worker builder's maximum elevation beam
+   * count and its elevation spread. The 2D contexts take their own
+   * `init.maxMemory`.
+   * @param init Bellhop init used for every 2D context
+   */
+  void enableSlices(const bhc::bhcInit &init);
+
+  /**
+   * @brief Logs each worker's peak arrival usage against its budget.
+   * @details Warns when a worker filled every arrival slot at some receiver,
+   * meaning Bellhop may have dropped arrivals and the budget is too small.
+   * @param maxMemoryBytes bhcInit::maxMemory every 3D context was given
+   */
+  void logMemoryUsage(size_t maxMemoryBytes) const;
+
+private:
+  std::vector<std::unique_ptr<acoustics::BhContext<true, true>>> contexts_{};
+  std::vector<std::unique_ptr<acoustics::AcousticsBuilder>> builders_{};
+  std::vector<BellhopWorker> workers_{};
+  std::vector<std::unique_ptr<acoustics::BhContext<false, false>>>
+      sliceContexts_{};
+  std::vector<std::unique_ptr<acoustics::SliceBuilder>> sliceBuilders_{};
+};
+
+} // namespace sim
@@ -0,0 +1,157 @@
+/** @file FidelityScheduler.h
+ * @brief Picks the cheapest TOF engine expected to meet a range-error budget
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace sim {
+
+/**
+ * @brief TOF engines, cheapest first.
+ */
+enum class TofEngine {
+  kLookup,      ///< KeyframeTrack, TofCache, TravelTimeAtlas or RayBundle
+  kStraightRay, ///< StraightRayEstimator
+  kImageSource, ///< ImageSourceModel
+  kSlice,       ///< Nx2D bearing slice
+  kBellhop3D,   ///< Full 3D refinement ladder
+};
+
+/// Number of TofEngine values
+constexpr size_t kNumTofEngines = 5;
+
+/// @brief Short engine name for logs.
+const char *engineName(TofEngine engine);
+
+/**
+ * @brief Budget and calibration settings of a FidelityScheduler.
+ */
+struct FidelityConfig {
+  /// Largest predicted range error (m) a cheap engine may have; <= 0
+  /// disables the scheduler, leaving each engine's own threshold in charge
+  double rangeErrorBudgetM{0.0};
+  /// One link in this many is also traced in 3D to calibrate the engine
+  /// that resolved it; <= 0 disables spot checks
+  int spotCheckInterval{20};
+  /// Weight of the newest spot check in an engine's calibration, in (0, 1]
+  double calibrationWeight{0.2};
+};
+
+/**
+ * @brief Decides per link whether a cheap TOF engine is trusted, and learns
+ * how far each engine's error heuristic is off.
+ *
+ * @details Each cheap engine supplies a geometric error heuristic h in
+ * meters of range. The scheduler predicts the error as `scale * h`, where
+ * `scale` starts at 1, and accepts the engine when the prediction is within
+ * `rangeErrorBudgetM`. The range system tries engines cheapest first, so
+ * the first accepted one is the cheapest expected to meet the budget.
+ *
+ * Spot checks trace a link in 3D even when a cheap engine accepted it. The
+ * observed range error e then moves the engine's scale toward e / h by an
+ * exponential moving average with weight `calibrationWeight`. Rejected
+ * engines are sampled in rotation too (see rejectedSpotEngine()), so a scale
+ * that overshot can come back down. Heuristics
+ * are floored at kMinHeuristicM, so an engine without one (such as a
+ * landmark lookup) is calibrated from its spot checks alone.
+ */
+class FidelityScheduler {
+public:
+  /// Floor applied to every heuristic (m)
+  static constexpr double kMinHeuristicM = 1.0e-3;
+
+  explicit FidelityScheduler(const FidelityConfig &config);
+
+  [[nodiscard]] bool enabled() const noexcept {
+    return config_.rangeErrorBudgetM > 0.0;
+  }
+
+  /// @brief Calibrated range error (m) for an engine's heuristic.
+  [[nodiscard]] double predictedErrorM(TofEngine engine,
+                                       double heuristicM) const;
+
+  /// @brief True if the prediction is within the budget. Always true for
+  ///        kBellhop3D.
+  [[nodiscard]] bool accepts(TofEngine engine, double heuristicM) const;
+
+  /**
+   * @brief True if a link should be spot-checked this ping.
+   * @details Rotates through links, so each one is checked every
+   *          `spotCheckInterval` pings.
+   * @param pingIndex Running ping count
+   * @param linkIdx Index of the link
+   */
+  [[nodiscard]] bool spotCheckDue(size_t pingIndex, size_t linkIdx) const;
+
+  /**
+   * @brief Cheap engine a due spot check samples even if it was rejected.
+   * @details Accepted engines are always sampled. Without also sampling
+   *          rejected ones, an engine pushed over the budget by one outlier
+   *          would never be checked again and its scale could never recover.
+   *          Successive spot checks of a link rotate through the cheap
+   *          engines.
+   * @param pingIndex Running ping count
+   * @param linkIdx Index of the link
+   */
+  [[nodiscard]] TofEngine rejectedSpotEngine(size_t pingIndex,
+                                             size_t linkIdx) const;
+
+  /**
+   * @brief Folds one spot check into an engine's calibration.
+   * @param engine Engine that produced the cheap TOF
+   * @param heuristicM Heuristic the engine was accepted with
+   * @param observedM |cheap - 3D| range error
+   */
+  void calibrate(TofEngine engine, double heuristicM, double observedM);
+
+  /// @brief Current heuristic scale of an engine.
+  [[nodiscard]] double scale(TofEngine engine) const;
+
+  /// @brief Spot checks folded into an engine's calibration so far.
+  [[nodiscard]] int spotChecks(TofEngine engine) const;
+
+  [[nodiscard]] const FidelityConfig &config() const noexcept {
+    return config_;
+  }
+
+  /**
+   * @brief Straight-ray heuristic: the estimator's own error bound.
+   * @param errorSec StraightRayEstimate::errorSec
+   * @param meanSpeedMps Path length over TOF
+   */
+  static double straightRayHeuristicM(double errorSec, double meanSpeedMps);
+
+  /**
+   * @brief Image-source heuristic: a column spread of Δc shifts the mean
+   *        speed by up to Δc / 2 over the whole path.
+   * @param tofSec Accepted image-source TOF
+   * @param speedSpreadMps Largest spread the model accepts
+   */
+  static double imageSourceHeuristicM(double tofSec, double speedSpreadMps);
+
+  /**
+   * @brief Nx2D heuristic: the path length a slice misses by ignoring
+   *        horizontal refraction.
+   * @details A cross-bearing gradient g bends rays with curvature
+   *          k = g / c, which lengthens a chord of range R by k^2 R^3 / 24.
+   * @param crossGradient Largest cross-bearing gradient (1/s)
+   * @param soundSpeedMps Sound speed at the source
+   * @param rangeM Horizontal source-receiver range
+   */
+  static double sliceHeuristicM(double crossGradient, double soundSpeedMps,
+                                double rangeM);
+
+private:
+  struct Calibration {
+    double scale{1.0};
+    int spotChecks{0};
+  };
+
+  FidelityConfig config_{};
+  std::array<Calibration, kNumTofEngines> calibration_{};
+};
+
+} // namespace sim
@@ -0,0 +1,81 @@
+/** @file ImageSourceModel.h
+ * @brief Analytic direct and bounced arrivals in near-isovelocity shallow water
+ */
+
+#pragma once
+
+#include "acoustics/Arrival.h"
+#include "acoustics/SimulationConfig.h"
+#include "mantaray/sim/MetricEnvironment.h"
+
+#include <Eigen/Core>
+#include <optional>
+
+namespace sim {
+
+/**
+ * @brief Applicability and order limits of an ImageSourceModel.
+ */
+struct ImageSourceConfig {
+  /// Largest sound-speed spread over the water column still treated as
+  /// isovelocity (m/s)
+  double maxSpeedSpreadMps{2.0};
+  /// Most surface plus bottom reflections per image path
+  int maxBounces{4};
+};
+
+/**
+ * @brief Image-source arrivals between a flat surface and a flat bottom.
+ *
+ * @details At the link's horizontal midpoint, the Grid2D bathymetry gives the
+ * waveguide depth D, and the Grid3D column above it gives the mean sound
+ * speed c. The model applies only when the column's speed spread is at most
+ * `maxSpeedSpreadMps`. Each reflection mirrors the source in the surface
+ * (z = 0) or the bottom (z = D). A path with k bounces that starts at the
+ * surface unfolds to the vertical distance
+ * @code
+ *   2D floor(k/2) + (k odd ? zs + zr : zs - zr)
+ * @endcode
+ * and one that starts at the bottom unfolds to
+ * @code
+ *   2D ceil(k/2) - (k odd ? zs + zr : zs - zr)
+ * @endcode
+ * Its TOF is the unfolded length divided by c.
+ *
+ * The direct path is taken only when the straight segment stays above the
+ * true bathymetry. When it does not, the fastest image path becomes the
+ * any-path arrival, as Bellhop's would. Bounced paths assume the flat
+ * midpoint bottom, so they are only as good as that approximation.
+ */
+class ImageSourceModel {
+public:
+  /**
+   * @param ssp Sound speed grid, copied and converted to meters
+   * @param bathymetry Seafloor depth grid, copied and converted to meters
+   * @param config Applicability and order limits
+   */
+  ImageSourceModel(const acoustics::SSPConfig &ssp,
+                   const acoustics::BathymetryConfig &bathymetry,
+                   const ImageSourceConfig &config);
+
+  /**
+   * @brief Direct and fastest-any arrivals between two points.
+   * @return Arrivals in the same form Bellhop runs produce, or std::nullopt
+   *         where the column is not near-isovelocity or an endpoint is not in
+   *         the water
+   */
+  [[nodiscard]] std::optional<acoustics::ArrivalPair>
+  arrivals(const Eigen::Vector3d &source,
+           const Eigen::Vector3d &receiver) const;
+
+private:
+  /// Mean sound speed over the column at (x, y) down to depth, or nullopt if
+  /// its spread exceeds maxSpeedSpreadMps
+  [[nodiscard]] std::optional<double> isovelocitySpeed(double x, double y,
+                                                       double depth) const;
+
+  ImageSourceConfig config_{};
+  MetricEnvironment environment_;
+};
+
+} // namespace sim
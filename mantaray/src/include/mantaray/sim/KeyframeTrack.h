@@ -0,0 +1,103 @@
+/** @file KeyframeTrack.h
+ * @brief Per-link TOF prediction between Bellhop keyframes
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+namespace sim {
+
+/**
+ * @brief Bounds that force a new keyframe.
+ */
+struct KeyframeConfig {
+  /// Longest time (s) a link may go between keyframes
+  double maxIntervalSec{600.0};
+  /// Largest range residual (m) a prediction may carry
+  double maxResidualM{0.5};
+};
+
+/**
+ * @brief Predicts a link's TOF from its last two keyframe solves and the
+ * current geometric range.
+ *
+ * @details A keyframe is a solved TOF T_k at geometric (straight-line) range
+ * r_k. Between the two keyframes the prediction is a cubic Hermite fit of
+ * TOF against range. The slope at each keyframe is T_k / r_k, the slope a
+ * straight ray in uniform water would have. Outside the keyframe ranges,
+ * the nearer keyframe is scaled by r / r_k, like the TofCache correction.
+ *
+ * The residual of a prediction at range r is estimated from the two
+ * one-sided scalings, which differ when the mean slowness changes with
+ * geometry:
+ * @code
+ *   residual = r |T0 / r0 - T1 / r1| * c,   c = r1 / T1
+ * @endcode
+ * Each new keyframe also measures the true residual of the prediction it
+ * replaces. predict() declines, forcing a keyframe, when:
+ * - there are fewer than two keyframes
+ * - the newest is older than `maxIntervalSec`
+ * - the keyframes disagree on whether the path was multipath
+ * - the last measured residual or the estimated residual exceeds
+ *   `maxResidualM`
+ */
+class KeyframeTrack {
+public:
+  /// @brief One solved TOF.
+  struct Keyframe {
+    double timeSec{0.0};
+    /// Straight-line source-receiver distance (m)
+    double rangeM{0.0};
+    float tofRawSec{-1.0f};
+    bool multipathUsed{false};
+  };
+
+  /// @brief A predicted TOF.
+  struct Prediction {
+    float tofRawSec{-1.0f};
+    /// Estimated range residual (m)
+    double residualM{0.0};
+    bool multipathUsed{false};
+  };
+
+  /**
+   * @brief Adds a solve, dropping the oldest keyframe.
+   * @details The solve's TOF is first compared with this track's
+   *          prediction at its range, setting lastResidualM().
+   */
+  void add(const Keyframe &keyframe);
+
+  /// @brief Forgets every keyframe, e.g. after a failed solve.
+  void reset();
+
+  /**
+   * @brief Predicted TOF at a time and geometric range.
+   * @return The prediction, or std::nullopt if a new keyframe is due
+   */
+  [[nodiscard]] std::optional<Prediction>
+  predict(double timeSec, double rangeM, const KeyframeConfig &config) const;
+
+  /// @brief Keyframes held, at most two.
+  [[nodiscard]] size_t size() const noexcept { return count_; }
+
+  /// @brief Residual (m) measured by the last add(), or nullopt if it had no
+  ///        prediction to compare with.
+  [[nodiscard]] std::optional<double> lastResidualM() const noexcept {
+    return lastResidualM_;
+  }
+
+private:
+  /// Hermite or scaled TOF at a range, ignoring every bound; needs two
+  /// keyframes with positive ranges
+  [[nodiscard]] std::optional<double> interpolate(double rangeM) const;
+
+  /// Older keyframe first
+  std::array<Keyframe, 2> keyframes_{};
+  size_t count_{0};
+  std::optional<double> lastResidualM_{};
+};
+
+} // namespace sim
@@ -0,0 +1,59 @@
+/** @file LinkSchedule.h
+ * @brief Picks the subset of links that fire on one ping
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace sim {
+
+/** @brief Which links fire on a ping. See @ref link_schedules. */
+enum class LinkSchedule {
+  /// Every link, every ping
+  kAllPairs,
+  /// One pinger per ping, each in its own fixed slot
+  kTdma,
+  /// k random targets per pinger
+  kRandomK,
+  /// The k nearest targets per pinger
+  kNearestK
+};
+
+/**
+ * @brief A link that may fire this ping.
+ */
+struct ScheduleCandidate {
+  /// Index of the link in the caller's link list
+  size_t linkIdx{0};
+  /// Fixed TDMA slot of the link's pinger; also groups links by pinger
+  size_t pingerSlot{0};
+  /// Pinger-target distance (m), read by kNearestK
+  double rangeM{0.0};
+};
+
+/**
+ * @brief Marks the links a schedule fires on one ping.
+ *
+ * @details kTdma fires the pinger whose slot is `pingIndex % numSlots`. A
+ * slot keeps its pinger for the whole run, so a dead pinger, or one with no
+ * candidates this ping, leaves its slot idle instead of shifting the others.
+ * kRandomK and kNearestK pick up to k candidates per pinger; kRandomK draws
+ * from rng, visiting pingers in slot order so a seed replays exactly.
+ *
+ * @param candidates Links whose endpoints are both alive, in link order
+ * @param numLinks Size of the returned mask
+ * @param numSlots TDMA frame length, greater than every pingerSlot
+ * @param pingIndex Pings scheduled before this one
+ * @param k Targets per pinger for kRandomK and kNearestK
+ * @param rng Draws of kRandomK; untouched by the other schedules
+ * @return Per link, whether it fires
+ */
+std::vector<bool> selectScheduledLinks(
+    LinkSchedule schedule, const std::vector<ScheduleCandidate> &candidates,
+    size_t numLinks, size_t numSlots, size_t pingIndex, size_t k,
+    std::mt19937_64 &rng);
+
+} // namespace sim
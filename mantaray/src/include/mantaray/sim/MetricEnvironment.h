@@ -0,0 +1,64 @@
+/** @file MetricEnvironment.h
+ * @brief Sound speed and seafloor lookups in meters, without Bellhop
+ */
+
+#pragma once
+
+#include "acoustics/Grid.h"
+#include "acoustics/SimulationConfig.h"
+
+#include <Eigen/Core>
+#include <optional>
+
+namespace sim {
+
+/**
+ * @brief Copies of the SSP and bathymetry grids converted to meters, for
+ * analytic TOF models that run without Bellhop.
+ *
+ * @details The configs' `isKm` covers every dimension, so km grids are scaled
+ * on construction and all queries take world positions in meters (z is depth,
+ * positive down).
+ */
+class MetricEnvironment {
+public:
+  MetricEnvironment(const acoustics::SSPConfig &ssp,
+                    const acoustics::BathymetryConfig &bathymetry);
+
+  /// @brief Trilinear sound speed, clamped to the grid (m/s).
+  [[nodiscard]] double soundSpeed(const Eigen::Vector3d &position) const;
+
+  /// @brief Seafloor depth, or std::nullopt off the bathymetry grid (m).
+  [[nodiscard]] std::optional<double> bottomDepth(double x, double y) const;
+
+  /// @brief True inside the SSP grid and above the seafloor.
+  [[nodiscard]] bool inWater(const Eigen::Vector3d &position) const;
+
+  /**
+   * @brief Vertical slice along the source-receiver bearing.
+   * @param rangeStepM Spacing of the slice's range axis
+   * @param maxRangeM Farthest range to sample; clipped where the grids end
+   * @return The slice, or std::nullopt if the grids end before the receiver
+   */
+  [[nodiscard]] std::optional<acoustics::BearingSlice>
+  bearingSlice(const Eigen::Vector3d &source, const Eigen::Vector3d &receiver,
+               double rangeStepM, double maxRangeM) const;
+
+  /**
+   * @brief Largest horizontal sound-speed gradient across the bearing
+   *        (1/s), sampled along the source-receiver track at every SSP depth.
+   * @details Nx2D runs model gradients along the bearing but not across it,
+   *          so this is what bounds their error.
+   */
+  [[nodiscard]] double crossBearingGradient(const Eigen::Vector3d &source,
+                                            const Eigen::Vector3d &receiver,
+                                            double rangeStepM) const;
+
+  [[nodiscard]] const acoustics::Grid3D &ssp() const noexcept { return ssp_; }
+
+private:
+  acoustics::Grid3D ssp_;
+  acoustics::Grid2D bathymetry_;
+};
+
+} // namespace sim
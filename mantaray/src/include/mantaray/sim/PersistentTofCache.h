@@ -0,0 +1,119 @@
+/** @file PersistentTofCache.h
+ * @brief Memory-mapped TOF cache shared across runs and processes
+ */
+
+#pragma once
+
+#include "acoustics/SimulationConfig.h"
+#include "mantaray/sim/TofCache.h"
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace sim {
+
+/**
+ * @brief Lookup and insert counts of a PersistentTofCache in this process.
+ */
+struct PersistentTofCacheStats {
+  size_t hits{0};
+  size_t misses{0};
+  size_t inserts{0};
+  /// Inserts dropped because every slot in the probe window was taken
+  size_t dropped{0};
+};
+
+/**
+ * @brief On-disk counterpart of TofCache, so repeated geometry across runs
+ * of the same environment never re-enters Bellhop.
+ *
+ * @details Solves are stored in a fixed-size open-addressing hash table in a
+ * memory-mapped file. The file is named after a hash of the SSP and
+ * bathymetry grids, the quantization tolerance and the solver settings, so
+ * every run of the same environment and solver shares it. Only full 3D
+ * Bellhop solves belong in it. Keys are the quantized endpoint cells, as in
+ * TofCache, plus the beam settings. Hits get the same geometric correction.
+ *
+ * Several processes may use one file at once. Lookups hold a shared
+ * `flock` and inserts an exclusive one, so a reader never sees a
+ * half-written slot. The first process to lock an empty file sizes it and
+ * writes the header; later ones check the header and adopt its capacity.
+ * A full probe window drops the insert, since the environment is static
+ * and entries never expire.
+ */
+class PersistentTofCache {
+public:
+  /**
+   * @param directory Where the cache file lives; created if missing
+   * @param environmentHash See environmentHash()
+   * @param toleranceMeters Quantization cell size and reuse tolerance
+   * @param slots Table capacity when the file is created
+   */
+  PersistentTofCache(const std::filesystem::path &directory,
+                     uint64_t environmentHash, double toleranceMeters,
+                     size_t slots);
+  ~PersistentTofCache();
+
+  PersistentTofCache(const PersistentTofCache &) = delete;
+  PersistentTofCache &operator=(const PersistentTofCache &) = delete;
+  PersistentTofCache(PersistentTofCache &&) = delete;
+  PersistentTofCache &operator=(PersistentTofCache &&) = delete;
+
+  /**
+   * @brief Stable hash of everything a stored TOF depends on besides the
+   *        endpoints.
+   * @details Also covers the file format version, so a layout change never
+   *          reads an old file.
+   * @param runSignature Solver and engine settings of the run (RunType, beam
+   *        fan, multipath, fan-out, warm start and backoff, refinement, beam
+   *        box and step constants, Nx2D and fidelity), in any stable text
+   *        form
+   */
+  static uint64_t environmentHash(const acoustics::SSPConfig &ssp,
+                                  const acoustics::BathymetryConfig &bathymetry,
+                                  double toleranceMeters,
+                                  const std::string &runSignature);
+
+  /// @brief Corrected entry like TofCache::lookup(), or std::nullopt.
+  [[nodiscard]] std::optional<TofCache::Entry>
+  lookup(const Eigen::Vector3d &pinger, const Eigen::Vector3d &target,
+         const TofBeamSettings &beam);
+
+  /// @brief Stores a successful solve, replacing any entry with its key.
+  void insert(const Eigen::Vector3d &pinger, const Eigen::Vector3d &target,
+              const TofBeamSettings &beam, const TofCache::Entry &entry);
+
+  /// @brief Entries in the file, from every process.
+  [[nodiscard]] size_t size() const;
+
+  [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+  [[nodiscard]] const PersistentTofCacheStats &stats() const noexcept {
+    return stats_;
+  }
+
+  [[nodiscard]] const std::filesystem::path &path() const noexcept {
+    return path_;
+  }
+
+private:
+  struct Header;
+  struct Slot;
+
+  std::filesystem::path path_{};
+  double tolerance_{0.0};
+  int fd_{-1};
+  void *mapping_{nullptr};
+  size_t mappedBytes_{0};
+  size_t capacity_{0};
+  PersistentTofCacheStats stats_{};
+
+  Header &header() const;
+  Slot *slots() const;
+};
+
+} // namespace sim
@@ -0,0 +1,118 @@
+/** @file PingBudget.h
+ * @brief Wall-clock and ray-count limits on the Bellhop work of one ping
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace sim {
+
+/**
+ * @brief Per-ping and per-link compute limits. Each limit <= 0 is off.
+ */
+struct BudgetConfig {
+  /// Wall-clock time (s) a ping may spend tracing
+  double pingSeconds{0.0};
+  /// Rays a ping may trace
+  int64_t pingRays{0};
+  /// Wall-clock time (s) one link's refinement may take
+  double linkSeconds{0.0};
+  /// Rays one link's refinement may trace
+  int64_t linkRays{0};
+
+  [[nodiscard]] bool enabled() const noexcept {
+    return pingSeconds > 0.0 || pingRays > 0 || linkSeconds > 0.0 ||
+           linkRays > 0;
+  }
+};
+
+/**
+ * @brief Tracks one ping's spending against its BudgetConfig.
+ *
+ * @details The clock starts at construction. Rays are charged as Bellhop
+ * runs finish, from any number of worker threads. A budget only ever stops
+ * work between runs, so a run in progress always completes.
+ *
+ * Charges from parallel links land in completion order, so a ray limit
+ * checked against them picks different links for different worker counts.
+ * To avoid that, callers reserve() each piece of work's rays serially, in
+ * the order it should be served, before dispatching any of it. A link
+ * started with an allowance answers to that allowance instead of the
+ * ping's shared count. Wall-clock limits stay timing dependent.
+ */
+class PingBudget {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Spending of one link, charged to its ping as well.
+  class Link {
+  public:
+    /// @brief Adds a finished run's rays to the link and its ping.
+    void charge(int64_t rays);
+
+    /// @brief True once the link or its ping is out of time or rays; with
+    ///        an allowance, that replaces the ping's rays.
+    [[nodiscard]] bool exhausted(Clock::time_point now = Clock::now()) const;
+
+    [[nodiscard]] int64_t rays() const noexcept { return rays_; }
+
+  private:
+    friend class PingBudget;
+    Link(PingBudget &ping, Clock::time_point start, int64_t allowance)
+        : ping_(&ping), start_(start), allowance_(allowance) {}
+
+    PingBudget *ping_;
+    Clock::time_point start_;
+    int64_t allowance_{0};
+    int64_t rays_{0};
+  };
+
+  explicit PingBudget(const BudgetConfig &config,
+                      Clock::time_point start = Clock::now());
+
+  /// @brief Starts a link's budget; its clock starts now.
+  [[nodiscard]] Link startLink(Clock::time_point now = Clock::now());
+
+  /// @brief Starts a link limited to rayAllowance rays from reserve().
+  [[nodiscard]] Link startLink(int64_t rayAllowance,
+                               Clock::time_point now = Clock::now());
+
+  /**
+   * @brief Reserves rays for work dispatched later, all or nothing.
+   * @details Call serially. Charges and earlier reservations count against
+   * the ping's ray limit.
+   * @return True without a ping ray limit or if every ray fits
+   */
+  [[nodiscard]] bool reserve(int64_t rays);
+
+  /// @brief Reserves as many of rays as still fit; all without a ray limit.
+  [[nodiscard]] int64_t reserveUpTo(int64_t rays);
+
+  /// @brief Releases reservations once the work they covered has charged.
+  void settle() noexcept { reserved_ = 0; }
+
+  /// @brief Adds a finished run's rays to the ping.
+  void charge(int64_t rays);
+
+  /// @brief True once the ping is out of time or rays.
+  [[nodiscard]] bool exhausted(Clock::time_point now = Clock::now()) const;
+
+  /// @brief True once the ping is out of wall-clock time.
+  [[nodiscard]] bool timedOut(Clock::time_point now = Clock::now()) const;
+
+  [[nodiscard]] int64_t rays() const noexcept { return rays_; }
+
+  [[nodiscard]] const BudgetConfig &config() const noexcept { return config_; }
+
+private:
+  BudgetConfig config_{};
+  Clock::time_point start_;
+  std::atomic<int64_t> rays_{0};
+  /// Rays reserved and not yet settled; touched serially only
+  int64_t reserved_{0};
+};
+
+} // namespace sim
@@ -0,0 +1,110 @@
+/** @file RayBundle.h
+ * @brief In-memory ray fan of a static source with eigenray interpolation
+ */
+
+#pragma once
+
+#include "acoustics/Arrival.h"
+#include "mantaray/sim/SpatialHash.h"
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+/**
+ * @brief Resolution of a RayBundle and its eigenray search.
+ */
+struct RayBundleConfig {
+  /// Farthest horizontal range the fan is traced to (m)
+  double maxRangeM{5000.0};
+  /// Spacing kept between stored ray points, and the spatial hash cell (m)
+  double pointSpacingM{25.0};
+  /// A ray farther than this from the receiver does not bracket it (m)
+  double maxMissM{50.0};
+};
+
+/**
+ * @brief Ray paths traced once from a static source, kept compressed in
+ * memory, and searched for the rays passing a receiver.
+ *
+ * @details Each ray is stored as a polyline of points at least
+ * `pointSpacingM` apart (points where the bounce count changes are always
+ * kept), holding position, travel time, and bounces so far. The points are
+ * indexed by a SpatialHash, so a lookup only visits segments near the
+ * receiver.
+ *
+ * For every ray with a segment within `maxMissM` of the receiver, the closest
+ * point Q on that ray gives a travel-time estimate
+ * @code
+ *   tau = tau(Q) + (P - Q) . t / c
+ * @endcode
+ * with t the segment's unit tangent and c its mean speed (length / delta
+ * tau). Along the ray this is exact to first order; across it the wavefront
+ * is locally perpendicular to the ray, so the offset adds nothing. The
+ * nearest kBracketRays rays are then averaged with inverse-distance weights,
+ * which interpolates between the rays that bracket the receiver.
+ *
+ * Direct-path estimates use only segments with no bounces so far. Any-path
+ * estimates use every segment but average only the rays with the fewest
+ * bounces, the usual fastest arrival, since rays along different paths do
+ * not bracket one another.
+ */
+class RayBundle {
+public:
+  /// @brief Rays averaged per estimate.
+  static constexpr size_t kBracketRays{4};
+
+  /// @brief One sample along a ray.
+  struct RayPoint {
+    Eigen::Vector3d position{};
+    /// Travel time from the source (s)
+    double tau{0.0};
+    /// Surface plus bottom bounces so far
+    int32_t bounces{0};
+  };
+
+  /// @param config Compression and search settings
+  explicit RayBundle(const RayBundleConfig &config);
+
+  /**
+   * @brief Compresses and indexes one ray.
+   * @param points Samples from the source outward; rays of fewer than two
+   *        points are ignored
+   */
+  void addRay(const std::vector<RayPoint> &points);
+
+  /**
+   * @brief Eigenray travel times to a receiver.
+   * @return Each path's TOF, or acoustics::kNoArrival where no ray of that
+   *         kind passes within `maxMissM`
+   */
+  [[nodiscard]] acoustics::ArrivalPair
+  lookup(const Eigen::Vector3d &receiver) const;
+
+  /// @brief Number of stored rays.
+  [[nodiscard]] size_t numRays() const noexcept { return rayStarts_.size(); }
+
+  /// @brief Number of stored points over all rays.
+  [[nodiscard]] size_t numPoints() const noexcept { return points_.size(); }
+
+private:
+  struct StoredPoint {
+    Eigen::Vector3f position{};
+    float tau{0.0f};
+    int32_t bounces{0};
+    uint32_t ray{0};
+  };
+
+  RayBundleConfig config_{};
+  std::vector<StoredPoint> points_{};
+  /// First point of each ray in points_
+  std::vector<size_t> rayStarts_{};
+  /// Longest stored segment, widens the hash query so no segment is missed
+  double maxSegmentM_{0.0};
+  SpatialHash index_;
+};
+
+} // namespace sim
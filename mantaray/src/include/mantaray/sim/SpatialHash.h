@@ -0,0 +1,67 @@
+/** @file SpatialHash.h
+ * @brief Uniform grid index for fixed-radius neighbour queries
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sim {
+
+/**
+ * @brief Buckets points into cubic cells for fast radius queries.
+ *
+ * @details With the cell size equal to the query radius, a query only visits
+ * the 27 cells around the query point, so building neighbour lists for N
+ * points costs O(N) instead of the O(N^2) of checking every pair. Ids are
+ * caller-defined (e.g. robot or landmark indices) and need not be dense.
+ */
+class SpatialHash {
+public:
+  /**
+   * @param cellSizeMeters Edge length of a cell (> 0); pick about the usual
+   *        query radius
+   */
+  explicit SpatialHash(double cellSizeMeters);
+
+  /// @brief Removes every point, keeping the cell size.
+  void clear();
+
+  /// @brief Adds a point under the given id.
+  void insert(size_t id, const Eigen::Vector3d &position);
+
+  /**
+   * @brief Ids of all points within radius of a position (inclusive).
+   * @return Ids in ascending order, so callers get a deterministic ordering
+   */
+  [[nodiscard]] std::vector<size_t> query(const Eigen::Vector3d &position,
+                                          double radiusMeters) const;
+
+  /// @brief Number of stored points.
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+private:
+  using Cell = std::array<int64_t, 3>;
+
+  struct CellHash {
+    size_t operator()(const Cell &cell) const noexcept;
+  };
+
+  struct Point {
+    size_t id{0};
+    Eigen::Vector3d position{};
+  };
+
+  double cellSize_{1.0};
+  size_t size_{0};
+  std::unordered_map<Cell, std::vector<Point>, CellHash> cells_{};
+
+  Cell cellOf(const Eigen::Vector3d &position) const;
+};
+
+} // namespace sim
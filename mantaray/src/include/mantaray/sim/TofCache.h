@@ -0,0 +1,139 @@
+/** @file TofCache.h
+ * @brief Persistent cross-ping time-of-flight cache keyed on geometry
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace sim {
+
+/**
+ * @brief Beam settings a cached TOF was solved with.
+ * @details A TOF is only reused under identical settings, since beam density
+ * decides whether a direct path is found at all.
+ */
+struct TofBeamSettings {
+  /// Initial elevation beam count
+  int numBeams{0};
+  /// Maximum elevation beam count for refinement
+  int maxBeams{0};
+  /// Elevation half-cone angle in degrees
+  double beamSpreadDeg{0.0};
+  /// Whether converged multipath results are accepted
+  bool allowMultipath{false};
+  /// Initial bearing beam count
+  int numBearingBeams{0};
+  /// Maximum bearing beam count for refinement
+  int maxBearingBeams{0};
+  /// Bearing half-cone angle in degrees
+  double bearingSpreadDeg{0.0};
+
+  bool operator==(const TofBeamSettings &other) const {
+    return numBeams == other.numBeams && maxBeams == other.maxBeams &&
+           beamSpreadDeg == other.beamSpreadDeg &&
+           allowMultipath == other.allowMultipath &&
+           numBearingBeams == other.numBearingBeams &&
+           maxBearingBeams == other.maxBearingBeams &&
+           bearingSpreadDeg == other.bearingSpreadDeg;
+  }
+};
+
+/**
+ * @brief Memoizes solved TOFs across pings for nearly identical geometry.
+ *
+ * @details Positions are quantized to cubic cells of edge `toleranceMeters`.
+ * A lookup hits when both endpoints fall in the same cells as a stored solve
+ * and each lies within `toleranceMeters` of the stored endpoint. The cached
+ * TOF is then scaled by the ratio of straight-line separations,
+ * @code
+ *   tof = tofCached * |pinger - target| / |pingerCached - targetCached|
+ * @endcode
+ * which absorbs the first-order change in path length. The correction is
+ * exact for straight rays in uniform water; otherwise the residual grows with
+ * the tolerance (each endpoint moves at most `toleranceMeters`), so keep it
+ * small relative to link range.
+ *
+ * Endpoints are stored in a canonical order, so a solve for A->B also serves
+ * B->A (acoustic reciprocity). Only successful solves are stored; the
+ * environment is static, so entries never expire.
+ */
+class TofCache {
+public:
+  /// @brief A stored solve.
+  struct Entry {
+    /// Raw one-way TOF in seconds
+    float tofRawSec{-1.0f};
+    /// True if the TOF came from a converged multipath arrival
+    bool multipathUsed{false};
+  };
+
+  /**
+   * @param toleranceMeters Position tolerance and quantization cell size;
+   *        <= 0 disables the cache
+   */
+  explicit TofCache(double toleranceMeters);
+
+  /// @brief True if lookups and inserts do anything.
+  [[nodiscard]] bool enabled() const noexcept { return tolerance_ > 0.0; }
+
+  /**
+   * @brief Returns a geometrically corrected TOF if a nearby solve exists.
+   * @return Corrected entry, or std::nullopt on a miss
+   */
+  [[nodiscard]] std::optional<Entry> lookup(const Eigen::Vector3d &pinger,
+                                            const Eigen::Vector3d &target,
+                                            const TofBeamSettings &beam) const;
+
+  /**
+   * @brief Stores a successful solve, replacing any entry in the same cells.
+   * @details Failed solves (negative TOF) are ignored.
+   */
+  void insert(const Eigen::Vector3d &pinger, const Eigen::Vector3d &target,
+              const TofBeamSettings &beam, const Entry &entry);
+
+  /// @brief Number of stored solves.
+  [[nodiscard]] size_t size() const noexcept { return entries_.size(); }
+
+private:
+  using Cell = std::array<int64_t, 3>;
+
+  struct Key {
+    Cell first{};
+    Cell second{};
+    TofBeamSettings beam{};
+    bool operator==(const Key &other) const {
+      return first == other.first && second == other.second &&
+             beam == other.beam;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const noexcept;
+  };
+
+  struct Stored {
+    Eigen::Vector3d first{};
+    Eigen::Vector3d second{};
+    Entry entry{};
+  };
+
+  double tolerance_{0.0};
+  std::unordered_map<Key, Stored, KeyHash> entries_{};
+
+  Cell cellOf(const Eigen::Vector3d &position) const;
+
+  /// @brief Builds the canonical key, swapping a and b if needed.
+  /// @return {key, true if the endpoints were swapped}
+  std::pair<Key, bool> makeKey(const Eigen::Vector3d &a,
+                               const Eigen::Vector3d &b,
+                               const TofBeamSettings &beam) const;
+};
+
+} // namespace sim
@@ -0,0 +1,72 @@
+/** @file TofLadder.h
+ * @brief Acceptance rules for the TOF of a beam refinement ladder
+ */
+
+#pragma once
+
+#include "acoustics/Arrival.h"
+
+namespace sim {
+
+/**
+ * @brief Decides, level by level, when a link's arrivals give a TOF.
+ *
+ * @details A direct path is accepted from any level. A multipath TOF is
+ * accepted once two successive full-fan levels agree:
+ * @code
+ *   |TOF_new - TOF_prev| < kConvergenceAtol + kConvergenceRtol * |TOF_prev|
+ * @endcode
+ * A zoomed level only traces a window around the source-receiver line, so it
+ * may find a direct path but neither confirms nor replaces a multipath TOF.
+ * See @ref iterative_beam_solver.
+ */
+class TofLadder {
+public:
+  /// @brief Absolute TOF convergence tolerance (seconds).
+  /// ~15cm range error at 1500 m/s.
+  static constexpr double kConvergenceAtol{1e-3};
+
+  /// @brief Relative TOF convergence tolerance.
+  static constexpr double kConvergenceRtol{1e-3};
+
+  /// @brief Outcome of one level.
+  struct Verdict {
+    /// True once the link has a TOF
+    bool accepted{false};
+    float tofRawSec{acoustics::kNoArrival};
+    bool multipathUsed{false};
+    /// True if this level's multipath was compared with the previous one
+    bool compared{false};
+    /// |TOF_new - TOF_prev| of that comparison
+    float delta{0.0f};
+  };
+
+  /// @param allowMultipath Accept converged bounced paths, not just direct
+  explicit TofLadder(bool allowMultipath) : allowMultipath_(allowMultipath) {}
+
+  /**
+   * @brief Folds in the arrivals of one traced level.
+   * @param arrivals Arrivals over every ray of the level
+   * @param fullFan False for a zoomed fan
+   */
+  Verdict addLevel(const acoustics::ArrivalPair &arrivals, bool fullFan);
+
+  /// @brief True once a full-fan level found any arrival.
+  [[nodiscard]] bool sawMultipath() const noexcept {
+    return prevAnyTof_ >= 0.0f;
+  }
+
+  /// @brief Check if two successive TOF values have converged.
+  /// @param curr Current TOF value (must be >= 0)
+  /// @param prev Previous TOF value (must be >= 0)
+  /// @param[out] delta Populated with |curr - prev| for logging
+  /// @return true if |curr - prev| < atol + rtol * |prev|
+  static bool converged(float curr, float prev, float &delta);
+
+private:
+  bool allowMultipath_;
+  /// Fastest arrival of the last full-fan level, or kNoArrival
+  float prevAnyTof_{acoustics::kNoArrival};
+};
+
+} // namespace sim
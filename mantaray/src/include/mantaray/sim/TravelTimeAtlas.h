@@ -0,0 +1,91 @@
+/** @file TravelTimeAtlas.h
+ * @brief Precomputed travel-time field around a static source
+ */
+
+#pragma once
+
+#include "acoustics/Arrival.h"
+#include "acoustics/Grid.h"
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+/**
+ * @brief Resolution and extent of a TravelTimeAtlas receiver grid.
+ */
+struct AtlasGridConfig {
+  /// Farthest horizontal range covered (m); links beyond it use Bellhop
+  double maxRangeM{5000.0};
+  /// Range spacing (m)
+  double rangeStepM{50.0};
+  /// Depth spacing (m)
+  double depthStepM{10.0};
+  /// Bearing spacing (deg)
+  double bearingStepDeg{5.0};
+};
+
+/**
+ * @brief Direct-path and fastest-any-path TOF from one source to a polar grid
+ * of receivers, looked up by trilinear interpolation.
+ *
+ * @details The grid matches Bellhop's native rectilinear receiver layout:
+ * bearing (deg, [-180, 180]) x horizontal range x depth around the source, so
+ * one run fills it with no resampling. Fields are stored as acoustics::Grid3D
+ * with x = bearing, y = range, z = depth. A lookup needs all eight
+ * surrounding cells to hold an arrival; otherwise that path is reported as
+ * acoustics::kNoArrival and the caller falls back to Bellhop. The endpoints of
+ * the bearing axis are the same direction, so no wrap-around is needed.
+ *
+ * Acoustic reciprocity makes the atlas of a landmark valid for pings in
+ * either direction.
+ */
+class TravelTimeAtlas {
+public:
+  /// @brief Receiver axes for a grid config and a depth interval.
+  struct Axes {
+    std::vector<double> bearingsDeg{};
+    std::vector<double> rangesM{};
+    std::vector<double> depthsM{};
+  };
+
+  /**
+   * @brief Builds evenly spaced axes; each includes both of its endpoints.
+   * @details Range starts at 0. Depth spans [minDepthM, maxDepthM].
+   */
+  static Axes makeAxes(const AtlasGridConfig &config, double minDepthM,
+                       double maxDepthM);
+
+  /**
+   * @param source Source position the fields were traced from
+   * @param axes Receiver axes the fields were traced on
+   * @param arrivals One ArrivalPair per cell, bearing-major then depth then
+   *        range (the order of AcousticsBuilder::updateSourceAndReceiverGrid())
+   */
+  TravelTimeAtlas(const Eigen::Vector3d &source, const Axes &axes,
+                  const std::vector<acoustics::ArrivalPair> &arrivals);
+
+  /**
+   * @brief Interpolated TOFs to a receiver position.
+   * @return Each path's TOF, or acoustics::kNoArrival where the position is
+   *         off the grid or a surrounding cell has no such arrival
+   */
+  [[nodiscard]] acoustics::ArrivalPair
+  lookup(const Eigen::Vector3d &receiver) const;
+
+  /// @brief Cells with a direct-path arrival.
+  [[nodiscard]] size_t directCells() const noexcept { return directCells_; }
+
+  /// @brief Total number of cells.
+  [[nodiscard]] size_t size() const noexcept { return direct_.size(); }
+
+private:
+  Eigen::Vector3d source_{};
+  acoustics::Grid3D direct_;
+  acoustics::Grid3D any_;
+  size_t directCells_{0};
+};
+
+} // namespace sim
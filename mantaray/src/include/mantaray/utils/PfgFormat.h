@@ -0,0 +1,17 @@
+/** @file PfgFormat.h
+ * @brief Record type tokens of the PyFactorGraphs (.pfg) text format
+ */
+#pragma once
+
+namespace pyfg {
+
+// ---- PFG 3D record type tokens ----
+// These must match the py_factor_graph Python reader/writer exactly.
+inline constexpr const char *kVertexSe3Quat = "VERTEX_SE3:QUAT";
+inline constexpr const char *kVertexSe3QuatPrior = "VERTEX_SE3:QUAT:PRIOR";
+inline constexpr const char *kVertexXyz = "VERTEX_XYZ";
+inline constexpr const char *kVertexXyzPrior = "VERTEX_XYZ:PRIOR";
+inline constexpr const char *kEdgeSe3Quat = "EDGE_SE3:QUAT";
+inline constexpr const char *kEdgeRange = "EDGE_RANGE";
+
+} // namespace pyfg
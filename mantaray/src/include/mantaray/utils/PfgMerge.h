@@ -0,0 +1,37 @@
+/** @file PfgMerge.h
+ * @brief Combines sharded PFG files into a single factor graph
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pyfg {
+
+/**
+ * @brief File name a shard writes its partial factor graph to.
+ * @param index Shard index in [0, count)
+ * @param count Total number of shards
+ * @return e.g. "output_shard_3_of_8.pfg"
+ */
+std::string shardFileName(size_t index, size_t count);
+
+/**
+ * @brief Merges the PFG files written by every shard of one run.
+ *
+ * @details Each shard runs the same deterministic physics, so everything but
+ * the range edges must match line for line; a mismatch (different config,
+ * seed, or build) throws std::runtime_error. Range edges of all shards are
+ * appended after the shared records, stably sorted by timestamp, which
+ * restores the order of an unsharded run since each ping epoch lives in
+ * exactly one shard.
+ *
+ * @param shardPaths Shard files, in any order
+ * @param outPath Merged output path (e.g. "output.pfg")
+ * @return Number of range edges written
+ */
+size_t mergePfgShards(const std::vector<std::string> &shardPaths,
+                      const std::string &outPath);
+
+} // namespace pyfg
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "mantaray/sim/AcousticPairwiseRangeSystem.h"
+#include "mantaray/utils/PfgFormat.h"
 #include "rb/RbWorld.h"
 #include <array>
 #include <string>
@@ -14,15 +15,6 @@
  */
 namespace pyfg {
 
-// ---- PFG 3D record type tokens ----
-// These must match the py_factor_graph Python reader/writer exactly.
-inline constexpr const char *kVertexSe3Quat = "VERTEX_SE3:QUAT";
-inline constexpr const char *kVertexSe3QuatPrior = "VERTEX_SE3:QUAT:PRIOR";
-inline constexpr const char *kVertexXyz = "VERTEX_XYZ";
-inline constexpr const char *kVertexXyzPrior = "VERTEX_XYZ:PRIOR";
-inline constexpr const char *kEdgeSe3Quat = "EDGE_SE3:QUAT";
-inline constexpr const char *kEdgeRange = "EDGE_RANGE";
-
 /**
  * @name Covariance Serialization
  * @brief PFG covariance format: column-major lower-triangular unique elements.
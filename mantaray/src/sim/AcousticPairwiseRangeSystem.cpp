@@ -1,5 +1,11 @@
 #include <mantaray/sim/AcousticPairwiseRangeSystem.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <numeric>
+
 namespace {
 /// Compact composite key for correlating general and bellhop logs.
 /// Format: "[t=<time> <pingerIdx>[R|L]-><targetIdx>[R|L]]"
@@ -10,38 +16,140 @@ std::string measureTag(double simTimeSec, const sim::RangeEndpoint &pinger,
   return fmt::format("[t={:.1f} {}[{}]->{}[{}]]", simTimeSec, pinger.index, p,
                      target.index, t);
 }
+
+/// Beam counts as "<elevation>x<bearing>" for logs.
+std::string formatBeams(const acoustics::BeamCounts &beams) {
+  return fmt::format("{}x{}", beams.elevation, beams.bearing);
+}
 } // namespace
 
 namespace sim {
 
 AcousticPairwiseRangeSystem::AcousticPairwiseRangeSystem(
-    acoustics::AcousticsBuilder &builder,
-    acoustics::BhContext<true, true> &context, GlobalTofMode mode,
-    bool allowMultipath, bool logAllMeasurements, double debugRangeErrorPct,
-    std::string debugOutputDir)
-    : builder_(builder),
-      context_(context),
-      mode_(mode),
-      allowMultipath_(allowMultipath),
-      logAllMeasurements_(logAllMeasurements),
-      debugRangeErrorPct_(debugRangeErrorPct),
-      debugOutputDir_(std::move(debugOutputDir)) {}
+    BellhopWorkerPool &pool, RangeSystemConfig config)
+    : pool_(pool),
+      builder_(*pool.worker(0).builder),
+      context_(*pool.worker(0).context),
+      config_(std::move(config)),
+      tofCache_(config_.tofCacheToleranceM),
+      firstTraceWorker_(config_.asyncPipeline ? 1 : 0),
+      scheduler_(config_.fidelity), scheduleRng_(config_.scheduleSeed) {
+  CHECK(!config_.asyncPipeline || pool_.size() >= 2,
+        "Async pipeline needs a second Bellhop worker to trace with");
+  if (config_.fanOutPerPinger) {
+    CHECK(config_.fanOutMaxTargets >= 2,
+          "Fan-out groups need room for at least two targets");
+    const auto beams = builder_.getNumBeams();
+    const auto maxBeams = builder_.getMaxBeams();
+    fanBearingSpanRad_ = acoustics::AcousticsBuilder::fanTargetSpanRad(
+        beams.bearing, maxBeams.bearing,
+        builder_.getBearingSpreadDeg() * acoustics::kDegree2Radians);
+    fanElevationSpanRad_ = acoustics::AcousticsBuilder::fanTargetSpanRad(
+        beams.elevation, maxBeams.elevation,
+        builder_.getElevationSpreadDeg() * acoustics::kDegree2Radians);
+  }
+  if (config_.straightRayFastPath) {
+    straightRay_.emplace(builder_.getSSPConfig(),
+                         builder_.getBathymetryConfig(), config_.straightRay);
+  }
+  if (config_.imageSourceModel && config_.allowMultipath) {
+    imageSource_.emplace(builder_.getSSPConfig(),
+                         builder_.getBathymetryConfig(), config_.imageSource);
+  }
+  if (!config_.persistentTofCacheDir.empty()) {
+    CHECK(tofCache_.enabled(),
+          "Persistent TOF cache needs tof_cache_tolerance_m > 0");
+    // Solver and engine settings a run was made with; changing one starts a
+    // new file
+    const auto numBeams = builder_.getNumBeams();
+    const auto maxBeams = builder_.getMaxBeams();
+    const auto runSignature = fmt::format(
+        "runtype={};beams={}x{},{}x{},{},{};multipath={};fanout={},{};"
+        "warmstart={};backoff={};refinement={};zoom={};step={};box={};"
+        "nx2d={},{},{},{};fidelity={},{},{}",
+        context_.params().Beam->RunType, numBeams.elevation, numBeams.bearing,
+        maxBeams.elevation, maxBeams.bearing,
+        builder_.getElevationSpreadDeg(), builder_.getBearingSpreadDeg(),
+        config_.allowMultipath, config_.fanOutPerPinger,
+        config_.fanOutMaxTargets, config_.beamWarmStart,
+        config_.failureBackoffMaxPings,
+        static_cast<int>(config_.beamRefinement), config_.zoomWindowDeg,
+        acoustics::kBeamStepSizeRatio, acoustics::kBeamBoxScale,
+        config_.nx2dSlices, config_.nx2d.maxCrossGradient,
+        config_.nx2d.rangeStepM, config_.nx2d.rangeExtent,
+        config_.fidelity.rangeErrorBudgetM, config_.fidelity.spotCheckInterval,
+        config_.fidelity.calibrationWeight);
+    persistentCache_.emplace(
+        config_.persistentTofCacheDir,
+        PersistentTofCache::environmentHash(
+            builder_.getSSPConfig(), builder_.getBathymetryConfig(),
+            config_.tofCacheToleranceM, runSignature),
+        config_.tofCacheToleranceM, config_.persistentTofCacheSlots);
+  }
+  if (config_.nx2dSlices) {
+    CHECK(pool_.worker(firstTraceWorker_).sliceBuilder != nullptr,
+          "Nx2D slices need BellhopWorkerPool::enableSlices()");
+    sliceEnvironment_.emplace(builder_.getSSPConfig(),
+                              builder_.getBathymetryConfig());
+  }
+}
 
 void AcousticPairwiseRangeSystem::rebuildPairs(const rb::RbWorld &world) {
+  // Carry per-link refinement memory over to links that survive the rebuild
+  std::map<LinkKey, LinkRefinementState> previousStates;
+  for (size_t i = 0; i < links_.size(); ++i) {
+    previousStates.emplace(linkKey(links_[i]), linkStates_[i]);
+  }
   links_.clear();
+  linkStates_.clear();
 
   const size_t numRobots = world.robots.size();
   const size_t numLandmarks = world.landmarks.size();
+  const bool gated = config_.maxLinkRangeM > 0.0;
+
+  // Neighbour candidates per robot: all, or those within range plus skin
+  const double gateRadius = config_.maxLinkRangeM + config_.linkSkinM;
+  SpatialHash robotHash(gated ? gateRadius : 1.0);
+  SpatialHash landmarkHash(gated ? gateRadius : 1.0);
+  if (gated) {
+    for (size_t i = 0; i < numRobots; ++i) {
+      if (world.robots[i]->isAlive_) {
+        robotHash.insert(
+            i, positionOf(world, RangeEndpoint{EndpointType::kRobot, i}));
+      }
+    }
+    for (size_t i = 0; i < numLandmarks; ++i) {
+      landmarkHash.insert(i, world.landmarks[i]);
+    }
+  } else {
+    links_.reserve(numRobots * (numRobots > 0 ? numRobots - 1 : 0) +
+                   numRobots * numLandmarks);
+  }
 
   // Convention: the robot is always the pinger, even for robot-landmark links
   // where the physical ping originates at the landmark. This ensures the SSP
   // is always sampled at the robot's position, which is the unknown being
   // estimated — the landmark position is known a priori.
-  links_.reserve(numRobots * (numRobots > 0 ? numRobots - 1 : 0) +
-                 numRobots * numLandmarks);
-
+  std::vector<size_t> targetRobots;
+  std::vector<size_t> targetLandmarks;
   for (size_t pingerRobot = 0; pingerRobot < numRobots; ++pingerRobot) {
-    for (size_t targetRobot = 0; targetRobot < numRobots; ++targetRobot) {
+    if (gated) {
+      // Dead robots never ping again
+      if (!world.robots[pingerRobot]->isAlive_) {
+        continue;
+      }
+      const auto pingerPos = positionOf(
+          world, RangeEndpoint{EndpointType::kRobot, pingerRobot});
+      targetRobots = robotHash.query(pingerPos, gateRadius);
+      targetLandmarks = landmarkHash.query(pingerPos, gateRadius);
+    } else {
+      targetRobots.resize(numRobots);
+      std::iota(targetRobots.begin(), targetRobots.end(), size_t{0});
+      targetLandmarks.resize(numLandmarks);
+      std::iota(targetLandmarks.begin(), targetLandmarks.end(), size_t{0});
+    }
+
+    for (size_t targetRobot : targetRobots) {
       if (pingerRobot == targetRobot) {
         continue;
       }
@@ -51,13 +159,53 @@ void AcousticPairwiseRangeSystem::rebuildPairs(const rb::RbWorld &world) {
       });
     }
 
-    for (size_t landmarkIdx = 0; landmarkIdx < numLandmarks; ++landmarkIdx) {
+    for (size_t landmarkIdx : targetLandmarks) {
       links_.push_back(RangeLink{
           RangeEndpoint{EndpointType::kRobot, pingerRobot},
           RangeEndpoint{EndpointType::kLandmark, landmarkIdx},
       });
     }
   }
+
+  LinkRefinementState fresh{};
+  fresh.lastBeams = builder_.getNumBeams();
+  linkStates_.reserve(links_.size());
+  for (const auto &link : links_) {
+    auto it = previousStates.find(linkKey(link));
+    linkStates_.push_back(it != previousStates.end() ? it->second : fresh);
+  }
+  rebuildActiveLinks(world);
+  if (gated) {
+    SPDLOG_DEBUG("Rebuilt link graph: {} links within {:.0f} m (+{:.0f} m "
+                 "skin)",
+                 links_.size(), config_.maxLinkRangeM, config_.linkSkinM);
+  }
+}
+
+void AcousticPairwiseRangeSystem::rebuildActiveLinks(
+    const rb::RbWorld &world) {
+  activeLinks_.clear();
+  activeSlots_.assign(links_.size(), kInactiveLink);
+  activeUnsorted_ = false;
+  robotLinks_.assign(world.robots.size(), {});
+  deadPingerLinks_ = 0;
+  deadTargetLinks_ = 0;
+  for (size_t i = 0; i < links_.size(); ++i) {
+    const auto &link = links_[i];
+    for (const auto &endpoint : {link.pinger, link.target}) {
+      if (endpoint.type == EndpointType::kRobot) {
+        robotLinks_[endpoint.index].push_back(i);
+      }
+    }
+    if (!isAlive(world, link.pinger)) {
+      ++deadPingerLinks_;
+    } else if (!isAlive(world, link.target)) {
+      ++deadTargetLinks_;
+    } else {
+      activeSlots_[i] = activeLinks_.size();
+      activeLinks_.push_back(i);
+    }
+  }
 }
 
 void AcousticPairwiseRangeSystem::checkBounds(rb::RbWorld &world) {
@@ -78,10 +226,17 @@ void AcousticPairwiseRangeSystem::checkBounds(rb::RbWorld &world) {
       markRobotDead(world, i);
     }
   }
+  // Robots move little between bounds checks, so the skin covers pairs that
+  // come into range before the next refresh
+  if (config_.maxLinkRangeM > 0.0) {
+    // An in-flight ping indexes the current links
+    flush();
+    rebuildPairs(world);
+  }
 }
 
 void AcousticPairwiseRangeSystem::maybeLog(const RangeMeasurement &meas) {
-  if (logAllMeasurements_) {
+  if (config_.logAllMeasurements) {
     measurements_.push_back(meas);
   }
 }
@@ -94,7 +249,6 @@ bool AcousticPairwiseRangeSystem::skipIfDead(const rb::RbWorld &world,
     SPDLOG_TRACE("Ping dropped: pinger {:d}[{}] is dead", link.pinger.index,
                  link.pinger.type == EndpointType::kRobot ? "robot"
                                                           : "landmark");
-    maybeLog(meas);
     return true;
   }
   if (!isAlive(world, link.target)) {
@@ -102,119 +256,183 @@ bool AcousticPairwiseRangeSystem::skipIfDead(const rb::RbWorld &world,
     SPDLOG_TRACE("Ping dropped: target {:d}[{}] is dead", link.target.index,
                  link.target.type == EndpointType::kRobot ? "robot"
                                                           : "landmark");
-    maybeLog(meas);
     return true;
   }
   return false;
 }
 
-bool AcousticPairwiseRangeSystem::checkTofConvergence(float curr, float prev,
-                                                      float &delta) {
-  delta = std::abs(curr - prev);
-  float tolerance = static_cast<float>(kTofConvergenceAtol +
-                                       kTofConvergenceRtol * std::abs(prev));
-  return delta < tolerance;
-}
-
-std::pair<float, TofConvergenceInfo> AcousticPairwiseRangeSystem::acquireTof(
-    const RangeLink &link, const std::string &tag,
-    std::map<std::pair<size_t, size_t>, float> &tofCache) {
-  const bool isRobotPair = link.pinger.type == EndpointType::kRobot &&
-                           link.target.type == EndpointType::kRobot;
-
-  if (isRobotPair) {
-    auto key = std::make_pair(std::min(link.pinger.index, link.target.index),
-                              std::max(link.pinger.index, link.target.index));
-    auto it = tofCache.find(key);
-    if (it != tofCache.end()) {
-      bellhop_logger->debug("{} Using cached TOF (reciprocal)", tag);
-      TofConvergenceInfo info{};
-      info.fromCache = true;
-      info.converged = true;
-      info.finalBeams = builder_.getNumBeams();
-      return {it->second, info};
-    }
-  }
-
-  const int originalBeams = builder_.getNumBeams();
-  const int maxBeams = builder_.getMaxBeams();
+std::pair<float, TofConvergenceInfo>
+AcousticPairwiseRangeSystem::acquireTof(BellhopWorker &worker,
+                                        const std::string &tag,
+                                        acoustics::BeamCounts startBeams,
+                                        PingBudget::Link &budget) {
+  auto &builder = *worker.builder;
+  auto &context = *worker.context;
+  const auto originalBeams = builder.getNumBeams();
+  const auto maxBeams = builder.getMaxBeams();
   float tofRawSec = acoustics::kNoArrival;
-  float prevAnyTof = -1.0f;
+  TofLadder ladder(config_.allowMultipath);
   TofConvergenceInfo info{};
   info.iterations = 0;
   bool tofConverged = false;
 
-  for (int beams = originalBeams; beams <= maxBeams;) {
-    ++info.iterations;
-    info.finalBeams = beams;
+  // Warm start: skip ladder levels this link needed last time
+  startBeams.elevation = std::clamp(
+      startBeams.elevation, originalBeams.elevation, maxBeams.elevation);
+  startBeams.bearing = std::clamp(startBeams.bearing, originalBeams.bearing,
+                                  maxBeams.bearing);
+  if (startBeams != originalBeams) {
+    SPDLOG_DEBUG("{} Warm start at {} beams", tag, formatBeams(startBeams));
+    builder.rebuildBeam(startBeams);
+  }
 
-    bellhop_logger->debug("\n===Start Bellhop {} (beams={})===\n", tag, beams);
+  const bool nested = config_.beamRefinement == BeamRefinement::kNested;
+  // Zoom is dropped for the rest of the ladder once its levels run out
+  bool zoom = config_.beamRefinement == BeamRefinement::kZoom;
+  // Arrivals over every ray traced at the current level, or so far (nested)
+  acoustics::ArrivalPair arrivals{};
+  int zoomLevel = 0;
+  auto trace = [&](const acoustics::BeamCounts &beams, const char *rays,
+                   int64_t rayCount) {
+    bellhop_logger->debug("\n===Start Bellhop {} (beams={}, {})===\n", tag,
+                          formatBeams(beams), rays);
     if (bellhop_logger->level() == spdlog::level::debug) {
-      bhc::echo(context_.params());
+      bhc::echo(context.params());
     }
-    bhc::run(context_.params(), context_.outputs());
+    bhc::run(context.params(), context.outputs());
     bellhop_logger->debug("\n===End Bellhop {}===\n", tag);
+    ++info.bellhopRuns;
+    budget.charge(rayCount);
 
-    acoustics::Arrival arrival(context_.params(), context_.outputs());
-    auto arrivals = arrival.getFastestArrivals();
+    acoustics::Arrival arrival(context.params(), context.outputs());
+    worker.usage.note(arrival);
+    arrivals.merge(arrival.getFastestArrivals().front());
+  };
 
-    // Direct path found — accept immediately, no convergence needed
-    if (arrivals.directPath >= 0.0f) {
+  // True once the loaded level nests the previous one, so only the
+  // interleaved angles need tracing
+  bool newRaysOnly = false;
+  auto prevBeams = startBeams;
+  auto raysOf = [](const acoustics::BeamCounts &beams) {
+    return static_cast<int64_t>(beams.elevation) * beams.bearing;
+  };
+  for (auto beams = startBeams;;) {
+    // Budgets are checked between levels; the first level always runs
+    if (info.iterations > 0 && budget.exhausted()) {
+      SPDLOG_WARN("{} Compute budget exhausted after {} rays at {} beams", tag,
+                  budget.rays(), formatBeams(info.finalBeams));
+      info.budgetExceeded = true;
+      break;
+    }
+    ++info.iterations;
+    info.finalBeams = beams;
+
+    if (newRaysOnly) {
+      // Earlier levels' arrivals carry over; they are rays of this level too.
+      // An axis at its cap kept its angles, so only grown axes add rays.
+      const bool elevationGrew = beams.elevation != prevBeams.elevation;
+      if (elevationGrew) {
+        builder.rebuildBeam(beams, acoustics::BeamSubset::kNewElevations);
+        trace(beams, "new elevations",
+              (beams.elevation - prevBeams.elevation) * int64_t{beams.bearing});
+      }
+      if (beams.bearing != prevBeams.bearing) {
+        const auto subset = elevationGrew
+                                ? acoustics::BeamSubset::kNewBearings
+                                : acoustics::BeamSubset::kNewBearingsOnly;
+        builder.rebuildBeam(beams, subset);
+        trace(beams, "new bearings",
+              (beams.bearing - prevBeams.bearing) *
+                  int64_t{elevationGrew ? prevBeams.elevation
+                                        : beams.elevation});
+      }
+    } else {
+      if (!nested) {
+        arrivals = acoustics::ArrivalPair{};
+      }
+      trace(beams, zoomLevel > 0 ? "zoomed" : "all rays", raysOf(beams));
+    }
+
+    // A zoomed fan only sees rays near the source-receiver line, so its
+    // bounced arrivals are never compared with a full fan's
+    const auto verdict = ladder.addLevel(arrivals, zoomLevel == 0);
+    if (verdict.accepted && !verdict.multipathUsed) {
       SPDLOG_INFO(
           "{} Direct path found: tof={:.6f}s at {} beams (iteration {})", tag,
-          arrivals.directPath, beams, info.iterations);
-      tofRawSec = arrivals.directPath;
+          verdict.tofRawSec, formatBeams(beams), info.iterations);
+      tofRawSec = verdict.tofRawSec;
       tofConverged = true;
       break;
     }
-
-    // Check multipath convergence (requires two successive agreeing values)
-    float multipathDelta = 0.0f;
-    if (allowMultipath_ && arrivals.anyPath >= 0.0f && prevAnyTof >= 0.0f) {
-      if (checkTofConvergence(arrivals.anyPath, prevAnyTof, multipathDelta)) {
-        SPDLOG_INFO("{} Multipath TOF converged: delta={:.2e}s after {} "
-                    "iterations (beams={})",
-                    tag, multipathDelta, info.iterations, beams);
-        tofRawSec = arrivals.anyPath;
-        info.lastDelta = multipathDelta;
-        info.multipathUsed = true;
-        tofConverged = true;
-        break;
-      }
+    if (verdict.accepted) {
+      SPDLOG_INFO("{} Multipath TOF converged: delta={:.2e}s after {} "
+                  "iterations (beams={})",
+                  tag, verdict.delta, info.iterations, formatBeams(beams));
+      tofRawSec = verdict.tofRawSec;
+      info.lastDelta = verdict.delta;
+      info.multipathUsed = true;
+      tofConverged = true;
+      break;
+    }
+    if (verdict.compared) {
       SPDLOG_INFO("{} Multipath TOF delta={:.2e}s, not converged", tag,
-                  multipathDelta);
+                  verdict.delta);
     }
 
-    // Update previous multipath value
-    if (arrivals.anyPath >= 0.0f) {
-      prevAnyTof = arrivals.anyPath;
+    // Zoom: densify around the geometric direction instead of growing the
+    // whole fan. Bounced arrivals leave the source elsewhere, so they are no
+    // guide to the direct path.
+    if (zoom && zoomLevel == kMaxZoomLevels) {
+      SPDLOG_INFO("{} No direct path after {} zoom levels, growing the fan",
+                  tag, zoomLevel);
+      zoom = false;
+      zoomLevel = 0;
+      builder.rebuildBeam(beams);
+    } else if (zoom) {
+      ++zoomLevel;
+      const double halfWidthDeg =
+          config_.zoomWindowDeg / std::pow(kBeamIterativeFactor, zoomLevel - 1);
+      SPDLOG_INFO("{} No direct path, zooming to +/-{:.3f} deg around the "
+                  "source-receiver line",
+                  tag, halfWidthDeg);
+      builder.zoomBeam(halfWidthDeg * acoustics::kDegree2Radians);
+      continue;
     }
 
-    // Scale up for next iteration
-    int nextBeams = static_cast<int>(beams * kBeamIterativeFactor);
-    nextBeams = std::min(nextBeams, maxBeams);
-
-    if (beams >= maxBeams) {
-      if (prevAnyTof >= 0.0f) {
+    if (beams == maxBeams) {
+      if (ladder.sawMultipath()) {
         SPDLOG_WARN("{} Multipath TOF did not converge at max {} beams", tag,
-                    maxBeams);
+                    formatBeams(maxBeams));
       } else {
-        SPDLOG_INFO("{} No arrivals found at max {} beams", tag, maxBeams);
+        SPDLOG_INFO("{} No arrivals found at max {} beams", tag,
+                    formatBeams(maxBeams));
       }
       break;
     }
 
+    // Scale up each axis below its cap for the next iteration. Nested levels
+    // interleave one new angle between each pair of old ones; an axis that
+    // would pass its cap is clamped and the level is traced whole.
+    auto nests = [](int n, int next) { return next == n || next == 2 * n - 1; };
+    const auto nextBeams = nextLevel(beams, maxBeams, nested);
+    newRaysOnly = nested && nests(beams.elevation, nextBeams.elevation) &&
+                  nests(beams.bearing, nextBeams.bearing);
+
     SPDLOG_INFO(
         "{} No direct path, refining: {} -> {} beams (multipath={:.6f}s)", tag,
-        beams, nextBeams, arrivals.anyPath >= 0 ? arrivals.anyPath : -1.0f);
+        formatBeams(beams), formatBeams(nextBeams),
+        arrivals.anyPath >= 0 ? arrivals.anyPath : -1.0f);
 
-    builder_.rebuildBeam(nextBeams);
+    if (!newRaysOnly) {
+      builder.rebuildBeam(nextBeams);
+    }
+    prevBeams = beams;
     beams = nextBeams;
   }
 
-  // Restore original beam count
-  if (builder_.getNumBeams() != originalBeams) {
-    builder_.rebuildBeam(originalBeams);
+  // Restore original beam count and fan
+  if (builder.getNumBeams() != originalBeams || zoomLevel > 0) {
+    builder.rebuildBeam(originalBeams);
   }
 
   // Reject unconverged results
@@ -222,82 +440,171 @@ std::pair<float, TofConvergenceInfo> AcousticPairwiseRangeSystem::acquireTof(
     tofRawSec = acoustics::kNoArrival;
   }
   info.converged = tofConverged;
+  return {tofRawSec, info};
+}
 
-  if (isRobotPair) {
-    auto key = std::make_pair(std::min(link.pinger.index, link.target.index),
-                              std::max(link.pinger.index, link.target.index));
-    tofCache[key] = tofRawSec;
-  }
+acoustics::BeamCounts
+AcousticPairwiseRangeSystem::nextLevel(const acoustics::BeamCounts &beams,
+                                       const acoustics::BeamCounts &maxBeams,
+                                       bool nested) {
+  auto grow = [&](int n, int cap) {
+    int next = nested ? 2 * n - 1 : static_cast<int>(n * kBeamIterativeFactor);
+    return std::min(next, cap);
+  };
+  return {grow(beams.elevation, maxBeams.elevation),
+          grow(beams.bearing, maxBeams.bearing)};
+}
 
-  return {tofRawSec, info};
+std::pair<int64_t, int64_t> AcousticPairwiseRangeSystem::ladderRays(
+    acoustics::BeamCounts startBeams) const {
+  const auto numBeams = builder_.getNumBeams();
+  const auto maxBeams = builder_.getMaxBeams();
+  // Same clamping as acquireTof()
+  startBeams.elevation = std::clamp(startBeams.elevation, numBeams.elevation,
+                                    maxBeams.elevation);
+  startBeams.bearing =
+      std::clamp(startBeams.bearing, numBeams.bearing, maxBeams.bearing);
+  auto raysOf = [](const acoustics::BeamCounts &beams) {
+    return static_cast<int64_t>(beams.elevation) * beams.bearing;
+  };
+  // A slice run fans the maximum elevations over one bearing
+  const int64_t opening =
+      (sliceEnvironment_ ? int64_t{maxBeams.elevation} : 0) +
+      raysOf(startBeams);
+
+  // Tracing every level whole bounds nested levels too; zoomed levels keep
+  // the first level's counts
+  int64_t total = opening;
+  if (config_.beamRefinement == BeamRefinement::kZoom) {
+    total += kMaxZoomLevels * raysOf(startBeams);
+  }
+  const bool nested = config_.beamRefinement == BeamRefinement::kNested;
+  for (auto beams = startBeams; beams != maxBeams;) {
+    const auto next = nextLevel(beams, maxBeams, nested);
+    if (next == beams) {
+      break;
+    }
+    total += raysOf(next);
+    beams = next;
+  }
+  return {opening, total};
 }
 
-void AcousticPairwiseRangeSystem::debugOutputRangeErrors(RangeMeasurement &meas,
-                                                         RangeLink &link,
-                                                         const std::string &tag,
-                                                         double simTimeSec,
-                                                         double trueRange) {
+void AcousticPairwiseRangeSystem::debugOutputRangeErrors(
+    const RangeMeasurement &meas, const RangeLink &link, const std::string &tag,
+    double simTimeSec, const Eigen::Vector3d &pingerPos,
+    const Eigen::Vector3d &targetPos, const acoustics::BeamCounts &beams) {
+  const double trueRange = (pingerPos - targetPos).norm();
   // Debug ray trace on high error
-  if (debugRangeErrorPct_ > 0.0 && trueRange > 0.0) {
+  if (config_.debugRangeErrorPct > 0.0 && trueRange > 0.0) {
     double errorPct =
         std::abs(meas.rangeMeters - trueRange) / trueRange * 100.0;
-    if (errorPct > debugRangeErrorPct_) {
+    if (errorPct > config_.debugRangeErrorPct) {
       SPDLOG_WARN("{} Range error {:.1f}% exceeds threshold {:.1f}%, "
-                  "dumping debug ray trace",
-                  tag, errorPct, debugRangeErrorPct_);
+                  "queueing debug ray trace",
+                  tag, errorPct, config_.debugRangeErrorPct);
+      debugDumps_.push_back(
+          DebugDump{link, tag, simTimeSec, pingerPos, targetPos, beams});
+    }
+  }
+}
 
-      // Switch to ray trace mode, preserving all other RunType flags
-      char savedRunType[7];
-      std::strcpy(savedRunType, context_.params().Beam->RunType);
-      savedRunType[0] = 'R';
-      std::strcpy(context_.params().Beam->RunType, savedRunType);
-      savedRunType[0] = 'A'; // prepare restore value
+void AcousticPairwiseRangeSystem::writeDebugDumps() {
+  flush();
+  if (debugDumps_.empty()) {
+    return;
+  }
+  SPDLOG_INFO("Writing {} debug ray traces on {} workers", debugDumps_.size(),
+              pool_.size());
+  pool_.parallelFor(debugDumps_.size(), [&](BellhopWorker &worker, size_t d) {
+    writeDebugDump(worker, debugDumps_[d]);
+  });
+  debugDumps_.clear();
+}
 
-      // Ray Preprocess allocates ray data alongside existing arrivals data.
-      // Both fit in memory as long as maxMemory is sufficient.
-      bhc::run(context_.params(), context_.outputs());
+void AcousticPairwiseRangeSystem::writeDebugDump(BellhopWorker &worker,
+                                                 const DebugDump &dump) const {
+  auto &builder = *worker.builder;
+  auto &context = *worker.context;
+  auto boundary =
+      builder.updateSourceAndReceiver(dump.pingerPos, dump.targetPos);
+  CHECK(boundary == acoustics::BoundaryCheck::kInBounds,
+        "Debug dump link was validated when the measurement was taken");
+  // Reproduce the level the link was solved at (zoomed fans are not kept)
+  const auto originalBeams = builder.getNumBeams();
+  if (dump.beams.elevation > 0 && dump.beams != originalBeams) {
+    builder.rebuildBeam(dump.beams);
+  }
 
-      auto filename =
-          fmt::format("{}/debug_{}{}_to_{}{}_{:.0f}s", debugOutputDir_,
-                      link.pinger.type == EndpointType::kRobot ? "R" : "L",
-                      link.pinger.index,
-                      link.target.type == EndpointType::kRobot ? "R" : "L",
-                      link.target.index, simTimeSec);
-      // writeenv captures the environment snapshot
-      // (source/receiver/SSP/bathy) writeout for ray mode segfaults in
-      // bellhop's Ray::Writeout (null ray ptr) NOTE: THis is a fundamental
-      // bug in bellhop that we cannot fix
-      bhc::writeenv(context_.params(), filename.c_str());
+  // Switch to ray trace mode, preserving all other RunType flags
+  char savedRunType[7];
+  std::strcpy(savedRunType, context.params().Beam->RunType);
+  savedRunType[0] = 'R';
+  std::strcpy(context.params().Beam->RunType, savedRunType);
+  savedRunType[0] = 'A'; // prepare restore value
 
-      // Restore arrivals mode — next bhc::run() re-preprocesses for arrivals
-      std::strcpy(context_.params().Beam->RunType, savedRunType);
-    }
-  }
-}
+  // Ray Preprocess allocates ray data alongside existing arrivals data.
+  // Both fit in memory as long as maxMemory is sufficient.
+  bhc::run(context.params(), context.outputs());
 
-void AcousticPairwiseRangeSystem::update(double simTimeSec,
-                                         rb::RbWorld &world) {
-  // Cache Bellhop TOF for robot-robot pairs — acoustic reciprocity means
-  // the propagation time is identical in both directions, so we only need
-  // to run Bellhop once per unordered pair.
-  std::map<std::pair<size_t, size_t>, float> tofCache;
+  const auto &link = dump.link;
+  auto filename =
+      fmt::format("{}/debug_{}{}_to_{}{}_{:.0f}s", config_.debugOutputDir,
+                  link.pinger.type == EndpointType::kRobot ? "R" : "L",
+                  link.pinger.index,
+                  link.target.type == EndpointType::kRobot ? "R" : "L",
+                  link.target.index, dump.simTimeSec);
+  // writeenv captures the environment snapshot
+  // (source/receiver/SSP/bathy) writeout for ray mode segfaults in
+  // bellhop's Ray::Writeout (null ray ptr) NOTE: THis is a fundamental
+  // bug in bellhop that we cannot fix
+  bhc::writeenv(context.params(), filename.c_str());
+  SPDLOG_DEBUG("{} Debug ray trace written to {}", dump.tag, filename);
 
-  int totalLinks = 0;
-  int cachedCount = 0;
-  int directCount = 0;
-  int multipathCount = 0;
-  int failedCount = 0;
+  // Restore arrivals mode — next bhc::run() re-preprocesses for arrivals
+  std::strcpy(context.params().Beam->RunType, savedRunType);
+  if (builder.getNumBeams() != originalBeams) {
+    builder.rebuildBeam(originalBeams);
+  }
+}
 
-  for (auto &link : links_) {
-    RangeMeasurement meas;
+std::vector<AcousticPairwiseRangeSystem::PlannedLink>
+AcousticPairwiseRangeSystem::planPing(double simTimeSec, rb::RbWorld &world) {
+  // Links of robots that died before this ping are counted, not planned
+  deadSkips_.pingerDead += deadPingerLinks_;
+  deadSkips_.targetDead += deadTargetLinks_;
+  if (activeUnsorted_) {
+    std::sort(activeLinks_.begin(), activeLinks_.end());
+    for (size_t slot = 0; slot < activeLinks_.size(); ++slot) {
+      activeSlots_[activeLinks_[slot]] = slot;
+    }
+    activeUnsorted_ = false;
+  }
+  const auto scheduled = scheduleLinks(world);
+  // Deaths below shrink activeLinks_, so the plan takes its own copy
+  std::vector<PlannedLink> plan(activeLinks_.size());
+  for (size_t p = 0; p < plan.size(); ++p) {
+    plan[p].linkIdx = activeLinks_[p];
+  }
+  for (auto &planned : plan) {
+    const size_t linkIdx = planned.linkIdx;
+    const auto &link = links_[linkIdx];
+    auto &meas = planned.meas;
     meas.simTimeSec = simTimeSec;
     meas.pinger = link.pinger;
     meas.target = link.target;
-    const auto tag = measureTag(simTimeSec, link.pinger, link.target);
+    planned.tag = measureTag(simTimeSec, link.pinger, link.target);
+    const auto &tag = planned.tag;
 
+    // Skipped links are logged in commitPing() to keep link order. Only an
+    // endpoint killed earlier in this ping can be dead here.
     if (skipIfDead(world, link, meas)) {
       continue;
     }
+    if (!scheduled[linkIdx]) {
+      meas.status = RangeStatus::kSkippedNotScheduled;
+      continue;
+    }
 
     const Eigen::Vector3d pingerPos = positionOf(world, link.pinger);
     const Eigen::Vector3d targetPos = positionOf(world, link.target);
@@ -320,7 +627,6 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
       }
       SPDLOG_WARN("{} Ping dropped: pinger out of bounds", tag);
       meas.status = RangeStatus::kOutOfBounds;
-      maybeLog(meas);
       continue;
     }
 
@@ -337,7 +643,6 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
       }
       SPDLOG_WARN("{} Ping dropped: target out of bounds", tag);
       meas.status = RangeStatus::kOutOfBounds;
-      maybeLog(meas);
       continue;
     case acoustics::BoundaryCheck::kSourceOutofBounds:
       if (link.pinger.type == EndpointType::kRobot) {
@@ -345,7 +650,6 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
       }
       SPDLOG_WARN("{} Ping dropped: pinger out of bounds", tag);
       meas.status = RangeStatus::kOutOfBounds;
-      maybeLog(meas);
       continue;
     case acoustics::BoundaryCheck::kEitherOrOutOfBounds:
       if (link.target.type == EndpointType::kRobot) {
@@ -356,15 +660,900 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
       }
       SPDLOG_WARN("{} Ping dropped: both pinger and target out of bounds", tag);
       meas.status = RangeStatus::kOutOfBounds;
+      continue;
+    }
+
+    // Range gate: listed pairs may have drifted apart since the last refresh
+    if (config_.maxLinkRangeM > 0.0 &&
+        (pingerPos - targetPos).norm() > config_.maxLinkRangeM) {
+      SPDLOG_TRACE("{} Ping skipped: beyond max link range", tag);
+      meas.status = RangeStatus::kSkippedOutOfRange;
+      continue;
+    }
+
+    // Backoff after bounds checks, so deaths are unaffected by it
+    auto &state = linkStates_[linkIdx];
+    if (state.skipPings > 0) {
+      --state.skipPings;
+      SPDLOG_DEBUG("{} Ping skipped: backing off after {} failures ({} more)",
+                   tag, state.consecutiveFailures, state.skipPings);
+      meas.status = RangeStatus::kSkippedBackoff;
+      continue;
+    }
+
+    planned.active = true;
+    planned.pingerPos = pingerPos;
+    planned.targetPos = targetPos;
+    planned.startBeams =
+        config_.beamWarmStart ? state.lastBeams : builder_.getNumBeams();
+    // Short links starting low on the ladder are the likeliest to find a
+    // direct path in one run; recent failures push a link to the back.
+    // acquireTof() starts no lower than getNumBeams() on either axis.
+    const auto numBeams = builder_.getNumBeams();
+    const double rays =
+        std::max(planned.startBeams.elevation, numBeams.elevation) *
+        std::max(planned.startBeams.bearing, numBeams.bearing);
+    planned.expectedCost = (targetPos - pingerPos).norm() * rays *
+                           (1 + state.consecutiveFailures);
+    if (config_.budget.pingRays > 0) {
+      std::tie(planned.openingRays, planned.maxRays) =
+          ladderRays(planned.startBeams);
+    }
+  }
+
+  // Links planned earlier stay active even if a later check kills one of
+  // their endpoints, matching measuring the links one at a time.
+
+  // Acoustic reciprocity means the propagation time is identical in both
+  // directions, so only the first link of each robot pair runs Bellhop.
+  std::map<std::pair<size_t, size_t>, size_t> firstOfPair;
+  for (size_t i = 0; i < plan.size(); ++i) {
+    const auto &link = links_[plan[i].linkIdx];
+    const bool isRobotPair = link.pinger.type == EndpointType::kRobot &&
+                             link.target.type == EndpointType::kRobot;
+    if (!plan[i].active || !isRobotPair) {
+      continue;
+    }
+    auto key = std::make_pair(std::min(link.pinger.index, link.target.index),
+                              std::max(link.pinger.index, link.target.index));
+    auto [it, inserted] = firstOfPair.emplace(key, i);
+    if (!inserted) {
+      plan[i].reciprocalOf = it->second;
+    }
+  }
+  for (auto &planned : plan) {
+    planned.spotCheck = planned.active && !planned.reciprocalOf &&
+                        scheduler_.spotCheckDue(pingCount_, planned.linkIdx);
+    if (planned.spotCheck) {
+      planned.spotRejected =
+          scheduler_.rejectedSpotEngine(pingCount_, planned.linkIdx);
+    }
+  }
+  ++pingCount_;
+  return plan;
+}
+
+std::vector<bool>
+AcousticPairwiseRangeSystem::scheduleLinks(const rb::RbWorld &world) {
+  if (config_.schedule == LinkSchedule::kAllPairs) {
+    return std::vector<bool>(links_.size(), true);
+  }
+  // Only robots ping, so each robot's index is its TDMA slot
+  std::vector<ScheduleCandidate> candidates;
+  candidates.reserve(activeLinks_.size());
+  for (size_t i : activeLinks_) {
+    const auto &link = links_[i];
+    const double rangeM =
+        config_.schedule == LinkSchedule::kNearestK
+            ? (positionOf(world, link.target) - positionOf(world, link.pinger))
+                  .norm()
+            : 0.0;
+    candidates.push_back(ScheduleCandidate{i, link.pinger.index, rangeM});
+  }
+  return selectScheduledLinks(config_.schedule, candidates, links_.size(),
+                              world.robots.size(), pingCount_,
+                              config_.scheduleK, scheduleRng_);
+}
+
+TofBeamSettings AcousticPairwiseRangeSystem::beamSettings() const {
+  const auto numBeams = builder_.getNumBeams();
+  const auto maxBeams = builder_.getMaxBeams();
+  return TofBeamSettings{numBeams.elevation,
+                         maxBeams.elevation,
+                         builder_.getElevationSpreadDeg(),
+                         config_.allowMultipath,
+                         numBeams.bearing,
+                         maxBeams.bearing,
+                         builder_.getBearingSpreadDeg()};
+}
+
+void AcousticPairwiseRangeSystem::resolveFromKeyframes(
+    std::vector<PlannedLink> &plan) {
+  if (!config_.keyframes) {
+    return;
+  }
+  for (auto &planned : plan) {
+    if (!planned.active || planned.reciprocalOf) {
+      continue;
+    }
+    const double rangeM = (planned.targetPos - planned.pingerPos).norm();
+    auto prediction = linkStates_[planned.linkIdx].keyframes.predict(
+        planned.meas.simTimeSec, rangeM, config_.keyframe);
+    if (!prediction) {
+      continue;
+    }
+    bellhop_logger->debug("{} Using keyframe TOF (residual {:.3f}m)",
+                          planned.tag, prediction->residualM);
+    planned.tofRawSec = prediction->tofRawSec;
+    planned.info.iterations = 0;
+    planned.info.finalBeams = builder_.getNumBeams();
+    planned.info.converged = true;
+    planned.info.multipathUsed = prediction->multipathUsed;
+    planned.info.fromKeyframe = true;
+    planned.resolved = true;
+  }
+}
+
+void AcousticPairwiseRangeSystem::resolveFromCache(
+    std::vector<PlannedLink> &plan) {
+  if (!tofCache_.enabled()) {
+    return;
+  }
+  const auto beam = beamSettings();
+  for (auto &planned : plan) {
+    if (!planned.active || planned.resolved || planned.reciprocalOf) {
+      continue;
+    }
+    auto hit = tofCache_.lookup(planned.pingerPos, planned.targetPos, beam);
+    if (!hit && persistentCache_) {
+      hit = persistentCache_->lookup(planned.pingerPos, planned.targetPos,
+                                     beam);
+    }
+    if (!hit || (scheduler_.enabled() &&
+                 !scheduleCheap(planned, TofEngine::kLookup,
+                                config_.tofCacheToleranceM, hit->tofRawSec))) {
+      continue;
+    }
+    bellhop_logger->debug("{} Using cached TOF (spatial)", planned.tag);
+    planned.tofRawSec = hit->tofRawSec;
+    planned.info.iterations = 0;
+    planned.info.finalBeams = builder_.getNumBeams();
+    planned.info.converged = true;
+    planned.info.multipathUsed = hit->multipathUsed;
+    planned.info.fromSpatialCache = true;
+    planned.resolved = true;
+  }
+}
+
+void AcousticPairwiseRangeSystem::buildLandmarkAtlases(
+    const rb::RbWorld &world) {
+  if (!config_.landmarkAtlas) {
+    return;
+  }
+  const auto &sspConfig = builder_.getSSPConfig();
+  const double kmScaler = sspConfig.isKm ? 1000.0 : 1.0;
+  const auto axes = TravelTimeAtlas::makeAxes(
+      config_.atlas, sspConfig.Grid.zCoords.front() * kmScaler,
+      sspConfig.Grid.zCoords.back() * kmScaler);
+  const size_t numLandmarks = world.landmarks.size();
+  // Atlases own non-copyable grids, so no assign()
+  atlases_.clear();
+  atlases_.resize(numLandmarks);
+  pool_.parallelFor(numLandmarks, [&](BellhopWorker &worker, size_t j) {
+    const auto &source = world.landmarks[j];
+    auto boundary = worker.builder->updateSourceAndReceiverGrid(
+        source, axes.rangesM, axes.depthsM, axes.bearingsDeg);
+    if (boundary != acoustics::BoundaryCheck::kInBounds) {
+      SPDLOG_WARN("Landmark {} out of bounds, no travel-time atlas", j);
+      return;
+    }
+    auto &context = *worker.context;
+    bhc::run(context.params(), context.outputs());
+    acoustics::Arrival arrival(context.params(), context.outputs());
+    worker.usage.note(arrival);
+    atlases_[j].emplace(
+        source, axes,
+        arrival.getFastestArrivals(worker.builder->getReceiverIndices()));
+    SPDLOG_INFO("Landmark {} atlas: {} of {} cells have a direct path", j,
+                atlases_[j]->directCells(), atlases_[j]->size());
+  });
+}
+
+void AcousticPairwiseRangeSystem::buildLandmarkRayBundles(
+    const rb::RbWorld &world) {
+  if (!config_.landmarkRayBundle) {
+    return;
+  }
+  const size_t numLandmarks = world.landmarks.size();
+  rayBundles_.clear();
+  rayBundles_.resize(numLandmarks);
+  pool_.parallelFor(numLandmarks, [&](BellhopWorker &worker, size_t j) {
+    auto boundary = worker.builder->updateSourceForRayFan(
+        world.landmarks[j], config_.rayBundle.maxRangeM);
+    if (boundary != acoustics::BoundaryCheck::kInBounds) {
+      SPDLOG_WARN("Landmark {} out of bounds, no ray bundle", j);
+      return;
+    }
+    auto &context = *worker.context;
+    bhc::run(context.params(), context.outputs());
+    const auto &rayInfo = *context.outputs().rayinfo;
+    auto &bundle = rayBundles_[j].emplace(config_.rayBundle);
+    std::vector<RayBundle::RayPoint> points;
+    for (int32_t r = 0; r < rayInfo.NRays; ++r) {
+      const auto &result = rayInfo.results[r];
+      points.clear();
+      for (int32_t k = 0; k < result.Nsteps; ++k) {
+        const auto &pt = result.ray[k];
+        points.push_back(RayBundle::RayPoint{
+            Eigen::Vector3d{pt.x.x, pt.x.y, pt.x.z}, pt.tau.real(),
+            pt.NumTopBnc + pt.NumBotBnc});
+      }
+      bundle.addRay(points);
+    }
+    SPDLOG_INFO("Landmark {} ray bundle: {} rays, {} points kept", j,
+                bundle.numRays(), bundle.numPoints());
+  });
+}
+
+std::optional<acoustics::ArrivalPair>
+AcousticPairwiseRangeSystem::landmarkLookup(
+    size_t landmark, const Eigen::Vector3d &receiver) const {
+  if (landmark < atlases_.size() && atlases_[landmark]) {
+    return atlases_[landmark]->lookup(receiver);
+  }
+  if (landmark < rayBundles_.size() && rayBundles_[landmark]) {
+    return rayBundles_[landmark]->lookup(receiver);
+  }
+  return std::nullopt;
+}
+
+void AcousticPairwiseRangeSystem::resolveFromLandmarks(
+    std::vector<PlannedLink> &plan) {
+  if (atlases_.empty() && rayBundles_.empty()) {
+    return;
+  }
+  for (auto &planned : plan) {
+    const auto &target = planned.meas.target;
+    if (!planned.active || planned.resolved || planned.spotSample ||
+        target.type != EndpointType::kLandmark) {
+      continue;
+    }
+    // Reciprocity: the landmark-sourced field serves robot-pinged links
+    auto lookup = landmarkLookup(target.index, planned.pingerPos);
+    if (!lookup) {
+      continue;
+    }
+    const auto &pair = *lookup;
+    const bool useMultipath = pair.directPath < 0.0f &&
+                              config_.allowMultipath && pair.anyPath >= 0.0f;
+    if (pair.directPath < 0.0f && !useMultipath) {
+      continue;
+    }
+    const float tofRawSec = useMultipath ? pair.anyPath : pair.directPath;
+    if (scheduler_.enabled() &&
+        !scheduleCheap(planned, TofEngine::kLookup, 0.0, tofRawSec)) {
+      continue;
+    }
+    bellhop_logger->debug("{} Using precomputed landmark TOF", planned.tag);
+    planned.tofRawSec = tofRawSec;
+    planned.info.iterations = 0;
+    planned.info.finalBeams = builder_.getMaxBeams();
+    planned.info.converged = true;
+    planned.info.multipathUsed = useMultipath;
+    planned.info.fromPrecomputed = true;
+    planned.resolved = true;
+  }
+}
+
+void AcousticPairwiseRangeSystem::resolveFromStraightRay(
+    std::vector<PlannedLink> &plan) {
+  if (!straightRay_) {
+    return;
+  }
+  for (auto &planned : plan) {
+    if (!planned.active || planned.resolved || planned.reciprocalOf ||
+        planned.spotSample) {
+      continue;
+    }
+    auto estimate = straightRay_->estimate(planned.pingerPos,
+                                           planned.targetPos);
+    if (!estimate) {
+      continue;
+    }
+    const float tofRawSec = static_cast<float>(estimate->tofSec);
+    if (scheduler_.enabled()) {
+      const double lengthM = (planned.targetPos - planned.pingerPos).norm();
+      const double meanSpeedMps =
+          estimate->tofSec > 0.0 ? lengthM / estimate->tofSec : 0.0;
+      const double heuristicM = FidelityScheduler::straightRayHeuristicM(
+          estimate->errorSec, meanSpeedMps);
+      if (!scheduleCheap(planned, TofEngine::kStraightRay, heuristicM,
+                         tofRawSec)) {
+        continue;
+      }
+    } else if (estimate->errorSec >= config_.straightRay.maxErrorSec) {
+      continue;
+    }
+    bellhop_logger->debug("{} Using straight-ray TOF (error {:.2e}s)",
+                          planned.tag, estimate->errorSec);
+    planned.tofRawSec = tofRawSec;
+    planned.info.iterations = 0;
+    planned.info.finalBeams = builder_.getNumBeams();
+    planned.info.converged = true;
+    planned.info.fromStraightRay = true;
+    planned.resolved = true;
+  }
+}
+
+void AcousticPairwiseRangeSystem::resolveFromImageSource(
+    std::vector<PlannedLink> &plan) {
+  if (!imageSource_) {
+    return;
+  }
+  for (auto &planned : plan) {
+    if (!planned.active || planned.resolved || planned.reciprocalOf ||
+        planned.spotSample) {
+      continue;
+    }
+    auto pair = imageSource_->arrivals(planned.pingerPos, planned.targetPos);
+    if (!pair || pair->anyPath < 0.0f) {
+      continue;
+    }
+    const bool useMultipath = pair->directPath < 0.0f;
+    const float tofRawSec = useMultipath ? pair->anyPath : pair->directPath;
+    if (scheduler_.enabled() &&
+        !scheduleCheap(planned, TofEngine::kImageSource,
+                       FidelityScheduler::imageSourceHeuristicM(
+                           tofRawSec, config_.imageSource.maxSpeedSpreadMps),
+                       tofRawSec)) {
+      continue;
+    }
+    bellhop_logger->debug("{} Using image-source TOF{}", planned.tag,
+                          useMultipath ? " (multipath)" : "");
+    planned.tofRawSec = tofRawSec;
+    planned.info.iterations = 0;
+    planned.info.finalBeams = builder_.getNumBeams();
+    planned.info.converged = true;
+    planned.info.multipathUsed = useMultipath;
+    planned.info.fromImageSource = true;
+    planned.resolved = true;
+  }
+}
+
+bool AcousticPairwiseRangeSystem::scheduleCheap(PlannedLink &planned,
+                                                TofEngine engine,
+                                                double heuristicM,
+                                                float tofRawSec) const {
+  const bool accepted = scheduler_.accepts(engine, heuristicM);
+  if (planned.spotCheck && (accepted || engine == planned.spotRejected)) {
+    bellhop_logger->debug("{} Spot-checking {} {} TOF against 3D", planned.tag,
+                          accepted ? "accepted" : "rejected",
+                          engineName(engine));
+    planned.spotSample = SpotCheckSample{engine, heuristicM, tofRawSec};
+    return false;
+  }
+  return accepted;
+}
+
+TofEngine
+AcousticPairwiseRangeSystem::engineOf(const TofConvergenceInfo &info) {
+  if (info.fromCache || info.fromSpatialCache || info.fromPrecomputed ||
+      info.fromKeyframe) {
+    return TofEngine::kLookup;
+  }
+  if (info.fromStraightRay) {
+    return TofEngine::kStraightRay;
+  }
+  if (info.fromImageSource) {
+    return TofEngine::kImageSource;
+  }
+  if (info.fromSlice) {
+    return TofEngine::kSlice;
+  }
+  return TofEngine::kBellhop3D;
+}
+
+void AcousticPairwiseRangeSystem::storeInCache(
+    const std::vector<PlannedLink> &plan) {
+  if (!tofCache_.enabled()) {
+    return;
+  }
+  // Inserted in link order so cache contents don't depend on thread timing.
+  // Only 3D solves are stored; cheaper engines would be served back as 3D,
+  // and a solve cut short by the budget is no answer at all.
+  const auto beam = beamSettings();
+  for (const auto &planned : plan) {
+    if (!planned.active || planned.reciprocalOf ||
+        planned.info.budgetExceeded ||
+        engineOf(planned.info) != TofEngine::kBellhop3D) {
+      continue;
+    }
+    tofCache_.insert(planned.pingerPos, planned.targetPos, beam,
+                     {planned.tofRawSec, planned.info.multipathUsed});
+    if (persistentCache_) {
+      persistentCache_->insert(planned.pingerPos, planned.targetPos, beam,
+                               {planned.tofRawSec, planned.info.multipathUsed});
+    }
+  }
+}
+
+void AcousticPairwiseRangeSystem::updateLinkStates(
+    const std::vector<PlannedLink> &plan) {
+  for (const auto &planned : plan) {
+    if (!planned.active) {
+      continue;
+    }
+    auto &state = linkStates_[planned.linkIdx];
+    const auto &info = planned.info;
+    // A budget cut, before or during the ladder, says nothing about the link
+    if (info.budgetExceeded) {
+      continue;
+    }
+    if (planned.tofRawSec >= 0.0f) {
+      state.consecutiveFailures = 0;
+      // Borrowed and cheap results say nothing about this link's 3D beam needs
+      if (engineOf(info) == TofEngine::kBellhop3D) {
+        // A fan-out hit came at single-link density, i.e. the first level
+        state.lastBeams =
+            info.fromFanOut ? builder_.getNumBeams() : info.finalBeams;
+      }
+      // Reciprocal copies may themselves be predictions
+      if (config_.keyframes && !info.fromKeyframe && !info.fromCache) {
+        state.keyframes.add(KeyframeTrack::Keyframe{
+            planned.meas.simTimeSec,
+            (planned.targetPos - planned.pingerPos).norm(), planned.tofRawSec,
+            info.multipathUsed});
+        const auto residual = state.keyframes.lastResidualM();
+        if (residual && *residual > config_.keyframe.maxResidualM) {
+          bellhop_logger->debug("{} Keyframe residual {:.3f}m over bound",
+                                planned.tag, *residual);
+        }
+      }
+      continue;
+    }
+    state.keyframes.reset();
+    ++state.consecutiveFailures;
+    if (config_.failureBackoffMaxPings > 0) {
+      // 0, 1, 3, 7, ... pings skipped after 1, 2, 3, 4, ... failures
+      const int exponent = std::min(state.consecutiveFailures - 1, 30);
+      const int backoff = (1 << exponent) - 1;
+      state.skipPings = std::min(backoff, config_.failureBackoffMaxPings);
+    }
+  }
+}
+
+std::vector<std::vector<size_t>> AcousticPairwiseRangeSystem::fanOutGroups(
+    const std::vector<PlannedLink> &plan) const {
+  // Group by pinger, keeping link order within each group
+  std::map<std::pair<EndpointType, size_t>, std::vector<size_t>> byPinger;
+  for (size_t i = 0; i < plan.size(); ++i) {
+    if (!plan[i].active || plan[i].resolved || plan[i].reciprocalOf) {
+      continue;
+    }
+    const auto &pinger = plan[i].meas.pinger;
+    byPinger[{pinger.type, pinger.index}].push_back(i);
+  }
+
+  struct Target {
+    size_t planIdx;
+    double bearingRad;
+    double elevationRad;
+  };
+  std::vector<std::vector<size_t>> groups;
+  for (auto &[pinger, members] : byPinger) {
+    if (members.size() < 2) {
+      continue;
+    }
+    std::vector<Target> targets;
+    targets.reserve(members.size());
+    for (size_t i : members) {
+      const Eigen::Vector3d delta = plan[i].targetPos - plan[i].pingerPos;
+      targets.push_back({i, std::atan2(delta(1), delta(0)),
+                         acoustics::utils::computeElevationAngle(delta)});
+    }
+    // Stable so equal bearings keep link order
+    std::stable_sort(targets.begin(), targets.end(),
+                     [](const Target &a, const Target &b) {
+                       return a.bearingRad < b.bearingRad;
+                     });
+
+    // Sweep by bearing; a group closes when it is full or a target would
+    // widen it past what one fan covers at single-link density
+    std::vector<size_t> group;
+    double minElevation = 0.0;
+    double maxElevation = 0.0;
+    auto closeGroup = [&]() {
+      // A lone target gains nothing over per-link refinement
+      if (group.size() >= 2) {
+        std::sort(group.begin(), group.end());
+        groups.push_back(std::move(group));
+      }
+      group.clear();
+    };
+    double firstBearing = 0.0;
+    for (const auto &target : targets) {
+      if (!group.empty()) {
+        const double low = std::min(minElevation, target.elevationRad);
+        const double high = std::max(maxElevation, target.elevationRad);
+        if (group.size() >= config_.fanOutMaxTargets ||
+            target.bearingRad - firstBearing > fanBearingSpanRad_ ||
+            high - low > fanElevationSpanRad_) {
+          closeGroup();
+        }
+      }
+      if (group.empty()) {
+        firstBearing = target.bearingRad;
+        minElevation = target.elevationRad;
+        maxElevation = target.elevationRad;
+      }
+      group.push_back(target.planIdx);
+      minElevation = std::min(minElevation, target.elevationRad);
+      maxElevation = std::max(maxElevation, target.elevationRad);
+    }
+    closeGroup();
+  }
+  return groups;
+}
+
+std::vector<std::vector<size_t>> AcousticPairwiseRangeSystem::admitFanOut(
+    const std::vector<PlannedLink> &plan, PingBudget &budget,
+    const acoustics::AcousticsBuilder &builder) const {
+  auto groups = fanOutGroups(plan);
+  if (!config_.budget.enabled()) {
+    return groups;
+  }
+  std::vector<double> costs;
+  costs.reserve(groups.size());
+  for (const auto &members : groups) {
+    double cost = 0.0;
+    for (size_t i : members) {
+      cost += plan[i].expectedCost;
+    }
+    costs.push_back(cost);
+  }
+  std::vector<size_t> order(groups.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t a, size_t b) { return costs[a] < costs[b]; });
+
+  std::vector<std::vector<size_t>> admitted;
+  std::vector<Eigen::Vector3d> receivers;
+  for (size_t g : order) {
+    auto &members = groups[g];
+    if (config_.budget.pingRays > 0) {
+      receivers.clear();
+      for (size_t i : members) {
+        receivers.push_back(plan[i].targetPos);
+      }
+      const auto beams =
+          builder.fanBeamCounts(plan[members.front()].pingerPos, receivers);
+      // Later groups are costlier, so stop at the first that does not fit
+      if (!budget.reserve(int64_t{beams.elevation} * beams.bearing)) {
+        break;
+      }
+    }
+    admitted.push_back(std::move(members));
+  }
+  return admitted;
+}
+
+int AcousticPairwiseRangeSystem::resolveFanOut(std::vector<PlannedLink> &plan,
+                                               PingBudget &budget) {
+  // Priced on the tracing thread's own builder, which matches the primary
+  const auto groups =
+      admitFanOut(plan, budget, *pool_.worker(firstTraceWorker_).builder);
+  std::atomic<int> runs{0};
+  pool_.parallelFor(
+      groups.size(),
+      [&](BellhopWorker &worker, size_t g) {
+        if (traceFanOut(worker, plan, groups[g], budget)) {
+          ++runs;
+        }
+      },
+      firstTraceWorker_);
+  // Every run has charged, so links reserve against the rays actually spent
+  budget.settle();
+  return runs;
+}
+
+bool AcousticPairwiseRangeSystem::traceFanOut(
+    BellhopWorker &worker, std::vector<PlannedLink> &plan,
+    const std::vector<size_t> &members, PingBudget &budget) {
+  if (budget.timedOut()) {
+    return false;
+  }
+  auto &builder = *worker.builder;
+  auto &context = *worker.context;
+  std::vector<Eigen::Vector3d> receivers;
+  receivers.reserve(members.size());
+  for (size_t i : members) {
+    receivers.push_back(plan[i].targetPos);
+  }
+  const auto &first = plan[members.front()];
+  auto boundary = builder.updateSourceAndReceivers(first.pingerPos, receivers);
+  CHECK(boundary == acoustics::BoundaryCheck::kInBounds,
+        "Fan-out endpoints were validated during planning");
+
+  bellhop_logger->debug("\n===Start Bellhop fan-out {} ({} targets)===\n",
+                        first.tag, members.size());
+  if (bellhop_logger->level() == spdlog::level::debug) {
+    bhc::echo(context.params());
+  }
+  bhc::run(context.params(), context.outputs());
+  bellhop_logger->debug("\n===End Bellhop fan-out {}===\n", first.tag);
+  // The fan is widened past getNumBeams() to keep its density, so charge
+  // the rays actually launched
+  const auto &angles = *context.params().Angles;
+  const acoustics::BeamCounts fanBeams{angles.alpha.n, angles.beta.n};
+  budget.charge(static_cast<int64_t>(fanBeams.elevation) * fanBeams.bearing);
+
+  acoustics::Arrival arrival(context.params(), context.outputs());
+  worker.usage.note(arrival);
+  auto arrivals = arrival.getFastestArrivals(builder.getReceiverIndices());
+  for (size_t k = 0; k < members.size(); ++k) {
+    auto &planned = plan[members[k]];
+    if (arrivals[k].directPath < 0.0f) {
+      SPDLOG_DEBUG("{} No direct path in fan-out, refining per link",
+                   planned.tag);
+      continue;
+    }
+    SPDLOG_INFO("{} Direct path found in fan-out: tof={:.6f}s", planned.tag,
+                arrivals[k].directPath);
+    planned.tofRawSec = arrivals[k].directPath;
+    planned.info.iterations = 1;
+    planned.info.finalBeams = fanBeams;
+    planned.info.converged = true;
+    planned.info.fromFanOut = true;
+    planned.resolved = true;
+  }
+  return true;
+}
+
+std::vector<size_t> AcousticPairwiseRangeSystem::pendingLinks(
+    const std::vector<PlannedLink> &plan) const {
+  std::vector<size_t> pending;
+  for (size_t i = 0; i < plan.size(); ++i) {
+    if (plan[i].active && !plan[i].resolved && !plan[i].reciprocalOf) {
+      pending.push_back(i);
+    }
+  }
+  // Under a budget, spend it on the links most likely to pay off
+  if (config_.budget.enabled()) {
+    std::stable_sort(pending.begin(), pending.end(), [&](size_t a, size_t b) {
+      return plan[a].expectedCost < plan[b].expectedCost;
+    });
+  }
+  return pending;
+}
+
+std::vector<int64_t> AcousticPairwiseRangeSystem::reserveLinkRays(
+    const std::vector<PlannedLink> &plan, const std::vector<size_t> &pending,
+    PingBudget &budget) const {
+  std::vector<int64_t> allowances(pending.size(), 0);
+  if (config_.budget.pingRays <= 0) {
+    return allowances;
+  }
+  // Links after the first whose opening level does not fit stay untraced,
+  // keeping cheapest-first strict
+  size_t admitted = 0;
+  for (; admitted < pending.size(); ++admitted) {
+    const auto &planned = plan[pending[admitted]];
+    if (!budget.reserve(planned.openingRays)) {
+      break;
+    }
+    allowances[admitted] = planned.openingRays;
+  }
+  const int64_t linkRays = config_.budget.linkRays;
+  for (size_t p = 0; p < admitted; ++p) {
+    const auto &planned = plan[pending[p]];
+    // A link's own limit stops it anyway, so it never needs more
+    int64_t wanted = planned.maxRays;
+    if (linkRays > 0) {
+      wanted = std::min(wanted, std::max(linkRays, planned.openingRays));
+    }
+    allowances[p] += budget.reserveUpTo(wanted - allowances[p]);
+  }
+  return allowances;
+}
+
+bool AcousticPairwiseRangeSystem::traceSlice(BellhopWorker &worker,
+                                             PlannedLink &planned, int &runs) {
+  if (!sliceEnvironment_ || planned.spotSample) {
+    return false;
+  }
+  const auto &nx2d = config_.nx2d;
+  const auto &source = planned.pingerPos;
+  const auto &receiver = planned.targetPos;
+  const double gradient = sliceEnvironment_->crossBearingGradient(
+      source, receiver, nx2d.rangeStepM);
+  const double rangeM = (receiver - source).head(2).norm();
+  const double heuristicM = FidelityScheduler::sliceHeuristicM(
+      gradient, sliceEnvironment_->soundSpeed(source), rangeM);
+  const bool allowed = scheduler_.enabled()
+                           ? scheduler_.accepts(TofEngine::kSlice, heuristicM)
+                           : gradient <= nx2d.maxCrossGradient;
+  if (!allowed) {
+    bellhop_logger->debug("{} Cross-bearing gradient {:.2e}/s, tracing 3D",
+                          planned.tag, gradient);
+    return false;
+  }
+  auto slice = sliceEnvironment_->bearingSlice(source, receiver,
+                                               nx2d.rangeStepM,
+                                               rangeM * nx2d.rangeExtent);
+  if (!slice) {
+    return false;
+  }
+
+  worker.sliceBuilder->update(*slice, source.z(), rangeM, receiver.z());
+  auto &context = *worker.sliceContext;
+  bellhop_logger->debug("\n===Start Bellhop {} (Nx2D slice)===\n",
+                        planned.tag);
+  if (bellhop_logger->level() == spdlog::level::debug) {
+    bhc::echo(context.params());
+  }
+  bhc::run(context.params(), context.outputs());
+  bellhop_logger->debug("\n===End Bellhop {}===\n", planned.tag);
+  ++runs;
+
+  const auto arrivals =
+      acoustics::Arrival(context.params(), context.outputs())
+          .getFastestArrivals()
+          .front();
+  // One level can only give a direct path; a bounced arrival needs the 3D
+  // ladder to confirm it across levels
+  const auto verdict =
+      TofLadder(config_.allowMultipath).addLevel(arrivals, true);
+  if (!verdict.accepted) {
+    return false;
+  }
+  const float tofRawSec = verdict.tofRawSec;
+  if (scheduler_.enabled() &&
+      !scheduleCheap(planned, TofEngine::kSlice, heuristicM, tofRawSec)) {
+    return false;
+  }
+  planned.tofRawSec = tofRawSec;
+  planned.info = TofConvergenceInfo{};
+  planned.info.bellhopRuns = runs;
+  planned.info.finalBeams = builder_.getMaxBeams();
+  planned.info.converged = true;
+  planned.info.fromSlice = true;
+  return true;
+}
+
+void AcousticPairwiseRangeSystem::traceLink(BellhopWorker &worker,
+                                            PlannedLink &planned,
+                                            PingBudget &budget,
+                                            int64_t rayAllowance) {
+  const bool noRays = config_.budget.pingRays > 0 && rayAllowance <= 0;
+  if (noRays || budget.timedOut()) {
+    SPDLOG_DEBUG("{} Not traced: ping compute budget exhausted", planned.tag);
+    planned.tofRawSec = acoustics::kNoArrival;
+    planned.info = TofConvergenceInfo{};
+    planned.info.iterations = 0;
+    planned.info.budgetExceeded = true;
+    planned.resolved = true;
+    return;
+  }
+  auto linkBudget = rayAllowance > 0 ? budget.startLink(rayAllowance)
+                                    : budget.startLink();
+  int sliceRuns = 0;
+  const bool sliced = traceSlice(worker, planned, sliceRuns);
+  // A slice fans the 3D elevation fan at its maximum over one bearing
+  linkBudget.charge(sliceRuns *
+                    int64_t{worker.builder->getMaxBeams().elevation});
+  if (sliced) {
+    planned.resolved = true;
+    return;
+  }
+  auto boundary = worker.builder->updateSourceAndReceiver(planned.pingerPos,
+                                                          planned.targetPos);
+  CHECK(boundary == acoustics::BoundaryCheck::kInBounds,
+        "Link endpoints were validated during planning");
+  std::tie(planned.tofRawSec, planned.info) =
+      acquireTof(worker, planned.tag, planned.startBeams, linkBudget);
+  // A rejected slice run still cost a Bellhop run
+  planned.info.bellhopRuns += sliceRuns;
+  planned.resolved = true;
+}
+
+void AcousticPairwiseRangeSystem::resolvePlannedLinks(
+    std::vector<PlannedLink> &plan, PingBudget &budget) {
+  const auto pending = pendingLinks(plan);
+  const auto allowances = reserveLinkRays(plan, pending, budget);
+  // Each item writes only its own plan entry, so merge order is link order
+  pool_.parallelFor(
+      pending.size(),
+      [&](BellhopWorker &worker, size_t item) {
+        traceLink(worker, plan[pending[item]], budget, allowances[item]);
+      },
+      firstTraceWorker_);
+  budget.settle();
+  copyReciprocals(plan);
+}
+
+void AcousticPairwiseRangeSystem::copyReciprocals(
+    std::vector<PlannedLink> &plan) {
+  // Reciprocal links always point at an earlier, now resolved, link
+  for (auto &planned : plan) {
+    if (!planned.active || !planned.reciprocalOf) {
+      continue;
+    }
+    const auto &source = plan[*planned.reciprocalOf];
+    bellhop_logger->debug("{} Using cached TOF (reciprocal)", planned.tag);
+    planned.tofRawSec = source.tofRawSec;
+    planned.info = TofConvergenceInfo{};
+    planned.info.fromCache = true;
+    planned.info.converged = true;
+    planned.info.finalBeams = source.info.finalBeams;
+    // Keep the budget cut, for updateLinkStates() and storeInCache()
+    if (source.info.budgetExceeded) {
+      planned.info.budgetExceeded = true;
+      planned.info.iterations = source.info.iterations;
+    }
+    planned.resolved = true;
+  }
+}
+
+void AcousticPairwiseRangeSystem::commitPing(double simTimeSec,
+                                             std::vector<PlannedLink> &plan,
+                                             int fanOutRuns) {
+  int totalLinks = 0;
+  int cachedCount = 0;
+  int directCount = 0;
+  int fanOutCount = 0;
+  int multipathCount = 0;
+  int failedCount = 0;
+  int cacheHits = 0;
+  int cacheMisses = 0;
+  int precomputedCount = 0;
+  int straightRayCount = 0;
+  int imageSourceCount = 0;
+  int sliceCount = 0;
+  int keyframeCount = 0;
+  int budgetCount = 0;
+  int bellhopRuns = fanOutRuns;
+  std::array<int, kNumTofEngines> engineCounts{};
+  int spotCheckCount = 0;
+
+  for (auto &planned : plan) {
+    auto &meas = planned.meas;
+    const auto &tag = planned.tag;
+    if (!planned.active) {
       maybeLog(meas);
       continue;
     }
 
-    // TOF acquisition with convergence verification
-    auto [tofRawSec, convergence] = acquireTof(link, tag, tofCache);
+    const float tofRawSec = planned.tofRawSec;
+    const auto &convergence = planned.info;
     ++totalLinks;
-    if (convergence.fromCache) {
+    if (tofCache_.enabled() && !convergence.fromCache &&
+        !convergence.fromPrecomputed && !convergence.fromKeyframe) {
+      ++(convergence.fromSpatialCache ? cacheHits : cacheMisses);
+    }
+    if (convergence.fromPrecomputed) {
+      ++precomputedCount;
+    }
+    if (convergence.fromKeyframe) {
+      ++keyframeCount;
+    }
+    if (convergence.fromImageSource) {
+      ++imageSourceCount;
+    }
+    if (convergence.fromSlice) {
+      ++sliceCount;
+    }
+    ++engineCounts[static_cast<size_t>(engineOf(convergence))];
+    if (convergence.budgetExceeded) {
+      ++failedCount;
+      ++budgetCount;
+    } else if (engineOf(convergence) == TofEngine::kLookup) {
       ++cachedCount;
+    } else if (convergence.fromFanOut) {
+      ++directCount;
+      ++fanOutCount;
+    } else if (convergence.fromStraightRay) {
+      ++directCount;
+      ++straightRayCount;
     } else if (convergence.converged && !convergence.multipathUsed) {
       ++directCount;
     } else if (convergence.converged && convergence.multipathUsed) {
@@ -372,7 +1561,17 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
     } else {
       ++failedCount;
     }
+    if (!convergence.fromCache && !convergence.fromFanOut &&
+        !convergence.fromSpatialCache && !convergence.fromPrecomputed) {
+      bellhopRuns += convergence.bellhopRuns;
+    }
 
+    if (convergence.budgetExceeded) {
+      meas.status = RangeStatus::kBudgetExceeded;
+      SPDLOG_WARN("{} Ping dropped: compute budget exceeded", tag);
+      maybeLog(meas);
+      continue;
+    }
     if (tofRawSec < 0.0f) {
       meas.status = RangeStatus::kNoArrival;
       SPDLOG_WARN("{} Ping dropped: no arrival", tag);
@@ -381,7 +1580,7 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
     }
 
     // SSP query at pinger position
-    const auto pos = acoustics::utils::safeEigenToVec23(pingerPos);
+    const auto pos = acoustics::utils::safeEigenToVec23(planned.pingerPos);
     float cPinger = 0.0f;
     bhc::get_ssp<true, true>(context_.params(), pos, cPinger);
     if (cPinger <= 0.0f) {
@@ -393,10 +1592,19 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
 
     // Successful measurement: compute range from TOF and local SSP
     meas.soundSpeedAtPingerMps = cPinger;
-    meas.tofEffectiveSec = tofRawSec * tofScale(mode_);
+    meas.tofEffectiveSec = tofRawSec * tofScale(config_.mode);
     meas.rangeMeters = meas.tofEffectiveSec * meas.soundSpeedAtPingerMps;
     meas.status = RangeStatus::kOk;
-    double trueRange = (pingerPos - targetPos).norm();
+    if (planned.spotSample && planned.spotSample->tofRawSec >= 0.0f) {
+      const auto &sample = *planned.spotSample;
+      const double errorM = std::abs(tofRawSec - sample.tofRawSec) *
+                            tofScale(config_.mode) * cPinger;
+      scheduler_.calibrate(sample.engine, sample.heuristicM, errorM);
+      ++spotCheckCount;
+      SPDLOG_DEBUG("{} Spot check: {} off by {:.3f}m (heuristic {:.3f}m)", tag,
+                   engineName(sample.engine), errorM, sample.heuristicM);
+    }
+    double trueRange = (planned.pingerPos - planned.targetPos).norm();
     SPDLOG_INFO("{} Ping OK{}: range={:.2f}m true={:.2f}m err={:.2f}m "
                 "tof={:.6f}s ssp={:.1f}m/s",
                 tag, convergence.multipathUsed ? " (multipath)" : "",
@@ -404,13 +1612,171 @@ void AcousticPairwiseRangeSystem::update(double simTimeSec,
                 meas.tofEffectiveSec, meas.soundSpeedAtPingerMps);
 
     measurements_.push_back(meas);
-    debugOutputRangeErrors(meas, link, tag, simTimeSec, trueRange);
+    // links_ may have been rebuilt since an offline epoch was planned
+    debugOutputRangeErrors(meas, RangeLink{meas.pinger, meas.target}, tag,
+                           simTimeSec, planned.pingerPos, planned.targetPos,
+                           convergence.finalBeams);
+  }
+
+  SPDLOG_INFO("t={:.1f}s TOF summary: {} links, {} cached ({} precomputed, {} "
+              "keyframe), {} direct ({} fan-out, {} straight-ray), {} "
+              "multipath, {} failed ({} over budget), {} via image sources, "
+              "{} via Nx2D slices, {} Bellhop runs, cache {} hits / {} "
+              "misses ({} entries)",
+              simTimeSec, totalLinks, cachedCount, precomputedCount,
+              keyframeCount, directCount, fanOutCount, straightRayCount,
+              multipathCount, failedCount, budgetCount, imageSourceCount,
+              sliceCount,
+              bellhopRuns, cacheHits, cacheMisses, tofCache_.size());
+  if (scheduler_.enabled()) {
+    const auto count = [&](TofEngine engine) {
+      return engineCounts[static_cast<size_t>(engine)];
+    };
+    SPDLOG_INFO("t={:.1f}s Engines: {} lookup, {} straight-ray, {} "
+                "image-source, {} Nx2D, {} 3D; {} spot checks, heuristic "
+                "scales {:.2f}/{:.2f}/{:.2f}/{:.2f}",
+                simTimeSec, count(TofEngine::kLookup),
+                count(TofEngine::kStraightRay), count(TofEngine::kImageSource),
+                count(TofEngine::kSlice), count(TofEngine::kBellhop3D),
+                spotCheckCount, scheduler_.scale(TofEngine::kLookup),
+                scheduler_.scale(TofEngine::kStraightRay),
+                scheduler_.scale(TofEngine::kImageSource),
+                scheduler_.scale(TofEngine::kSlice));
+  }
+}
+
+int AcousticPairwiseRangeSystem::traceLinks(std::vector<PlannedLink> &plan) {
+  PingBudget budget(config_.budget);
+  int fanOutRuns = config_.fanOutPerPinger ? resolveFanOut(plan, budget) : 0;
+  resolvePlannedLinks(plan, budget);
+  return fanOutRuns;
+}
+
+void AcousticPairwiseRangeSystem::finishPing(double simTimeSec,
+                                             std::vector<PlannedLink> &plan,
+                                             int fanOutRuns) {
+  storeInCache(plan);
+  updateLinkStates(plan);
+  commitPing(simTimeSec, plan, fanOutRuns);
+}
+
+void AcousticPairwiseRangeSystem::update(double simTimeSec,
+                                         rb::RbWorld &world) {
+  flush();
+  auto plan = planPing(simTimeSec, world);
+  resolveFromKeyframes(plan);
+  resolveFromCache(plan);
+  resolveFromLandmarks(plan);
+  resolveFromStraightRay(plan);
+  resolveFromImageSource(plan);
+  int fanOutRuns = traceLinks(plan);
+  finishPing(simTimeSec, plan, fanOutRuns);
+}
+
+void AcousticPairwiseRangeSystem::updateAsync(double simTimeSec,
+                                              rb::RbWorld &world) {
+  // The previous ping's results feed this ping's cache and warm starts
+  flush();
+  auto &ping = pending_.emplace();
+  ping.simTimeSec = simTimeSec;
+  ping.plan = planPing(simTimeSec, world);
+  resolveFromKeyframes(ping.plan);
+  resolveFromCache(ping.plan);
+  resolveFromLandmarks(ping.plan);
+  resolveFromStraightRay(ping.plan);
+  resolveFromImageSource(ping.plan);
+  ping.traced = std::async(std::launch::async, [this, &ping] {
+    ping.fanOutRuns = traceLinks(ping.plan);
+  });
+}
+
+void AcousticPairwiseRangeSystem::flush() {
+  if (!pending_) {
+    return;
+  }
+  try {
+    pending_->traced.get();
+  } catch (...) {
+    pending_.reset();
+    throw;
+  }
+  PendingPing ping = std::move(*pending_);
+  pending_.reset();
+  finishPing(ping.simTimeSec, ping.plan, ping.fanOutRuns);
+}
+
+void AcousticPairwiseRangeSystem::logCacheStats() const {
+  if (!tofCache_.enabled()) {
+    return;
+  }
+  SPDLOG_INFO("TOF cache: {} entries", tofCache_.size());
+  if (persistentCache_) {
+    const auto &stats = persistentCache_->stats();
+    SPDLOG_INFO("Persistent TOF cache {}: {} hits / {} misses, {} inserts, {} "
+                "dropped, {} of {} slots used",
+                persistentCache_->path().string(), stats.hits, stats.misses,
+                stats.inserts, stats.dropped, persistentCache_->size(),
+                persistentCache_->capacity());
   }
+}
+
+void AcousticPairwiseRangeSystem::recordPing(double simTimeSec,
+                                             rb::RbWorld &world) {
+  flush();
+  recorded_.push_back(RecordedPing{simTimeSec, planPing(simTimeSec, world)});
+  // The atlas is static, so using it keeps epochs independent
+  resolveFromLandmarks(recorded_.back().plan);
+  resolveFromStraightRay(recorded_.back().plan);
+  resolveFromImageSource(recorded_.back().plan);
+}
 
-  SPDLOG_INFO("t={:.1f}s TOF summary: {} links, {} cached, {} direct, "
-              "{} multipath, {} failed",
-              simTimeSec, totalLinks, cachedCount, directCount, multipathCount,
-              failedCount);
+int AcousticPairwiseRangeSystem::traceEpoch(BellhopWorker &worker,
+                                            std::vector<PlannedLink> &plan) {
+  PingBudget budget(config_.budget);
+  int fanOutRuns = 0;
+  if (config_.fanOutPerPinger) {
+    for (const auto &members : admitFanOut(plan, budget, *worker.builder)) {
+      if (traceFanOut(worker, plan, members, budget)) {
+        ++fanOutRuns;
+      }
+    }
+    budget.settle();
+  }
+  const auto pending = pendingLinks(plan);
+  const auto allowances = reserveLinkRays(plan, pending, budget);
+  for (size_t p = 0; p < pending.size(); ++p) {
+    traceLink(worker, plan[pending[p]], budget, allowances[p]);
+  }
+  copyReciprocals(plan);
+  return fanOutRuns;
+}
+
+void AcousticPairwiseRangeSystem::solveRecorded(size_t shardIndex,
+                                                size_t shardCount) {
+  CHECK(shardIndex < shardCount, "Shard index must be below the shard count");
+  // Round-robin, so each shard gets epochs spread over the whole run
+  if (shardCount > 1) {
+    std::vector<RecordedPing> mine;
+    for (size_t e = shardIndex; e < recorded_.size(); e += shardCount) {
+      mine.push_back(std::move(recorded_[e]));
+    }
+    SPDLOG_INFO("Shard {} of {}: keeping {} of {} ping epochs", shardIndex,
+                shardCount, mine.size(), recorded_.size());
+    recorded_ = std::move(mine);
+  }
+  SPDLOG_INFO("Solving {} recorded ping epochs on {} workers",
+              recorded_.size(), pool_.size() - firstTraceWorker_);
+  // One epoch per item: epochs share no state, so any worker may take any
+  pool_.parallelFor(
+      recorded_.size(),
+      [&](BellhopWorker &worker, size_t e) {
+        recorded_[e].fanOutRuns = traceEpoch(worker, recorded_[e].plan);
+      },
+      firstTraceWorker_);
+  for (auto &epoch : recorded_) {
+    commitPing(epoch.simTimeSec, epoch.plan, epoch.fanOutRuns);
+  }
+  recorded_.clear();
 }
 
 const std::vector<RangeMeasurement> &
@@ -450,12 +1816,39 @@ void AcousticPairwiseRangeSystem::markRobotDead(rb::RbWorld &world,
     return;
   }
   auto &robot = world.robots[robotIdx];
-  if (robot->isAlive_) {
-    const auto pos = world.dynamicsBodies.getPosition(robot->getBodyIdx());
-    SPDLOG_WARN("Marking robot {} as dead — position: [{}, {}, {}]", robotIdx,
-                pos.x(), pos.y(), pos.z());
+  if (!robot->isAlive_) {
+    return;
   }
+  const auto pos = world.dynamicsBodies.getPosition(robot->getBodyIdx());
+  SPDLOG_WARN("Marking robot {} as dead — position: [{}, {}, {}]", robotIdx,
+              pos.x(), pos.y(), pos.z());
   robot->isAlive_ = false;
+
+  // Robots added since the last rebuildPairs() have no links yet
+  if (robotIdx >= robotLinks_.size()) {
+    return;
+  }
+  for (size_t i : robotLinks_[robotIdx]) {
+    const bool isPinger = links_[i].pinger.type == EndpointType::kRobot &&
+                          links_[i].pinger.index == robotIdx;
+    const size_t slot = activeSlots_[i];
+    if (slot == kInactiveLink) {
+      // Already counted under its dead target; a dead pinger takes priority
+      if (isPinger) {
+        --deadTargetLinks_;
+        ++deadPingerLinks_;
+      }
+      continue;
+    }
+    // Swap-remove; planPing() restores link order before the next plan
+    const size_t moved = activeLinks_.back();
+    activeLinks_[slot] = moved;
+    activeSlots_[moved] = slot;
+    activeLinks_.pop_back();
+    activeSlots_[i] = kInactiveLink;
+    activeUnsorted_ = true;
+    ++(isPinger ? deadPingerLinks_ : deadTargetLinks_);
+  }
 }
 
 Eigen::Vector3d
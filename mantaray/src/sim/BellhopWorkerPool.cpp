@@ -0,0 +1,152 @@
+#include "mantaray/sim/BellhopWorkerPool.h"
+
+#include "mantaray/utils/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace sim {
+
+void BellhopWorkerUsage::note(const acoustics::Arrival &arrival) {
+  ++runs;
+  const size_t receivers = arrival.getReceiverCount();
+  const int32_t peak = arrival.getPeakArrivalCount();
+  peakReceivers = std::max(peakReceivers, receivers);
+  peakArrivals = std::max(peakArrivals, peak);
+  arrivalSlots = arrival.getArrivalCapacity();
+  peakArrivalBytes =
+      std::max(peakArrivalBytes, receivers * static_cast<size_t>(peak) *
+                                     sizeof(bhc::Arrival));
+}
+
+BellhopWorkerPool::BellhopWorkerPool(
+    acoustics::AcousticsBuilder &primaryBuilder,
+    acoustics::BhContext<true, true> &primaryContext, const bhc::bhcInit &init,
+    size_t numWorkers) {
+  CHECK(numWorkers >= 1, "Worker pool needs at least one worker");
+  workers_.push_back(BellhopWorker{&primaryBuilder, &primaryContext});
+  if (numWorkers == 1) {
+    return;
+  }
+
+  // One snapshot, bulk-copied into every replica context
+  const auto snapshot = primaryBuilder.snapshot();
+  for (size_t i = 1; i < numWorkers; ++i) {
+    auto context = std::make_unique<acoustics::BhContext<true, true>>(init);
+    auto builder =
+        acoustics::AcousticsBuilder::fromSnapshot(context->params(), snapshot);
+    workers_.push_back(BellhopWorker{builder.get(), context.get()});
+    contexts_.push_back(std::move(context));
+    builders_.push_back(std::move(builder));
+  }
+  SPDLOG_INFO("Bellhop worker pool ready: {} workers, {} Bellhop threads each",
+              workers_.size(), init.numThreads);
+}
+
+void BellhopWorkerPool::parallelFor(
+    size_t numItems, const std::function<void(BellhopWorker &, size_t)> &fn,
+    size_t firstWorker) {
+  CHECK(firstWorker < workers_.size(), "First worker index out of range");
+  const size_t numThreads = std::min(workers_.size() - firstWorker, numItems);
+  if (numThreads <= 1) {
+    for (size_t item = 0; item < numItems; ++item) {
+      fn(workers_[firstWorker], item);
+    }
+    return;
+  }
+
+  std::atomic<size_t> nextItem{0};
+  std::exception_ptr firstError{};
+  std::mutex errorMutex;
+  auto drain = [&](BellhopWorker &worker) {
+    try {
+      for (size_t item = nextItem++; item < numItems; item = nextItem++) {
+        fn(worker, item);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+      // Stop handing out work to every thread
+      nextItem = numItems;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (size_t t = 1; t < numThreads; ++t) {
+    threads.emplace_back(drain, std::ref(workers_[firstWorker + t]));
+  }
+  // Calling thread works too, as the first worker
+  drain(workers_[firstWorker]);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (firstError) {
+    std::rethrow_exception(firstError);
+  }
+}
+
+void BellhopWorkerPool::enableSlices(const bhc::bhcInit &init) {
+  if (!sliceContexts_.empty()) {
+    return;
+  }
+  for (auto &worker : workers_) {
+    auto context = std::make_unique<acoustics::BhContext<false, false>>(init);
+    auto &params = context->params();
+    // [0]=Arrivals [1]=Geometric [2-3]=unused [4]=Irregular grid [5]=2D
+    std::strcpy(params.Beam->RunType, "AG  I2");
+    std::strncpy(params.Title, worker.context->params().Title,
+                 sizeof(params.Title) - 1);
+    const auto &builder = *worker.builder;
+    auto sliceBuilder = std::make_unique<acoustics::SliceBuilder>(
+        params, builder.getMaxBeams().elevation,
+        builder.getElevationSpreadDeg() * acoustics::kDegree2Radians);
+    worker.sliceContext = context.get();
+    worker.sliceBuilder = sliceBuilder.get();
+    sliceContexts_.push_back(std::move(context));
+    sliceBuilders_.push_back(std::move(sliceBuilder));
+  }
+  SPDLOG_INFO("Nx2D slices ready: {} 2D contexts", sliceContexts_.size());
+}
+
+void BellhopWorkerPool::logMemoryUsage(size_t maxMemoryBytes) const {
+  constexpr double kMiB = 1024.0 * 1024.0;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    const auto &usage = workers_[i].usage;
+    if (usage.runs == 0) {
+      continue;
+    }
+    SPDLOG_INFO("Bellhop worker {}: {} runs, peak {} receivers, peak {}/{} "
+                "arrivals per receiver, peak arrivals {:.1f} of {:.1f} MiB",
+                i, usage.runs, usage.peakReceivers, usage.peakArrivals,
+                usage.arrivalSlots, usage.peakArrivalBytes / kMiB,
+                maxMemoryBytes / kMiB);
+    if (usage.arrivalSlots > 0 && usage.peakArrivals >= usage.arrivalSlots) {
+      SPDLOG_WARN("Bellhop worker {} filled all {} arrival slots at a "
+                  "receiver; arrivals may have been dropped, raise "
+                  "bellhop_memory_mib, or bellhop_arrivals_per_receiver if "
+                  "it is 0",
+                  i, usage.arrivalSlots);
+    }
+  }
+}
+
+int BellhopWorkerPool::bellhopThreadsPerWorker(int requested,
+                                               size_t numWorkers) {
+  if (requested > 0) {
+    return requested;
+  }
+  if (numWorkers <= 1) {
+    return -1;
+  }
+  const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<int>(std::max<size_t>(1, hardware / numWorkers));
+}
+
+} // namespace sim
@@ -0,0 +1,98 @@
+#include "mantaray/sim/FidelityScheduler.h"
+
+#include "mantaray/utils/checkAssert.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sim {
+
+const char *engineName(TofEngine engine) {
+  switch (engine) {
+  case TofEngine::kLookup:
+    return "lookup";
+  case TofEngine::kStraightRay:
+    return "straight-ray";
+  case TofEngine::kImageSource:
+    return "image-source";
+  case TofEngine::kSlice:
+    return "Nx2D";
+  case TofEngine::kBellhop3D:
+    return "3D";
+  }
+  throw std::logic_error("Unhandled TofEngine");
+}
+
+FidelityScheduler::FidelityScheduler(const FidelityConfig &config)
+    : config_(config) {
+  CHECK(config.calibrationWeight > 0.0 && config.calibrationWeight <= 1.0,
+        "Calibration weight must be in (0, 1]");
+}
+
+double FidelityScheduler::predictedErrorM(TofEngine engine,
+                                          double heuristicM) const {
+  if (engine == TofEngine::kBellhop3D) {
+    return 0.0;
+  }
+  return scale(engine) * std::max(heuristicM, kMinHeuristicM);
+}
+
+bool FidelityScheduler::accepts(TofEngine engine, double heuristicM) const {
+  return predictedErrorM(engine, heuristicM) <= config_.rangeErrorBudgetM;
+}
+
+bool FidelityScheduler::spotCheckDue(size_t pingIndex, size_t linkIdx) const {
+  if (!enabled() || config_.spotCheckInterval <= 0) {
+    return false;
+  }
+  const auto interval = static_cast<size_t>(config_.spotCheckInterval);
+  return (pingIndex + linkIdx) % interval == 0;
+}
+
+TofEngine FidelityScheduler::rejectedSpotEngine(size_t pingIndex,
+                                                size_t linkIdx) const {
+  const auto interval =
+      static_cast<size_t>(std::max(config_.spotCheckInterval, 1));
+  // Index of this spot check among the link's spot checks
+  const size_t round = (pingIndex + linkIdx) / interval;
+  // kBellhop3D is last, so this cycles through the cheap engines only
+  return static_cast<TofEngine>(round % (kNumTofEngines - 1));
+}
+
+void FidelityScheduler::calibrate(TofEngine engine, double heuristicM,
+                                  double observedM) {
+  if (engine == TofEngine::kBellhop3D) {
+    return;
+  }
+  auto &calibration = calibration_[static_cast<size_t>(engine)];
+  const double ratio = observedM / std::max(heuristicM, kMinHeuristicM);
+  calibration.scale += config_.calibrationWeight * (ratio - calibration.scale);
+  ++calibration.spotChecks;
+}
+
+double FidelityScheduler::scale(TofEngine engine) const {
+  return calibration_[static_cast<size_t>(engine)].scale;
+}
+
+int FidelityScheduler::spotChecks(TofEngine engine) const {
+  return calibration_[static_cast<size_t>(engine)].spotChecks;
+}
+
+double FidelityScheduler::straightRayHeuristicM(double errorSec,
+                                                double meanSpeedMps) {
+  return errorSec * meanSpeedMps;
+}
+
+double FidelityScheduler::imageSourceHeuristicM(double tofSec,
+                                                double speedSpreadMps) {
+  return 0.5 * tofSec * speedSpreadMps;
+}
+
+double FidelityScheduler::sliceHeuristicM(double crossGradient,
+                                          double soundSpeedMps,
+                                          double rangeM) {
+  const double curvature = crossGradient / soundSpeedMps;
+  return curvature * curvature * rangeM * rangeM * rangeM / 24.0;
+}
+
+} // namespace sim
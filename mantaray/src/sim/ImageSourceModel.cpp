@@ -0,0 +1,112 @@
+#include "mantaray/sim/ImageSourceModel.h"
+
+#include "mantaray/utils/checkAssert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Spacing of the seafloor clearance check along the direct segment (m)
+constexpr double kClearanceStepM = 10.0;
+
+} // namespace
+
+namespace sim {
+
+ImageSourceModel::ImageSourceModel(
+    const acoustics::SSPConfig &ssp,
+    const acoustics::BathymetryConfig &bathymetry,
+    const ImageSourceConfig &config)
+    : config_(config), environment_(ssp, bathymetry) {
+  CHECK(config.maxSpeedSpreadMps >= 0.0 && config.maxBounces >= 1,
+        "Image source needs a non-negative spread and at least one bounce");
+}
+
+std::optional<double> ImageSourceModel::isovelocitySpeed(double x, double y,
+                                                         double depth) const {
+  // Column samples at every SSP depth above the seafloor, plus the seafloor
+  std::vector<double> depths;
+  for (double z : environment_.ssp().zCoords) {
+    if (z >= 0.0 && z < depth) {
+      depths.push_back(z);
+    }
+  }
+  depths.push_back(depth);
+  double lowest = std::numeric_limits<double>::max();
+  double highest = std::numeric_limits<double>::lowest();
+  double weighted = 0.0;
+  double prevSpeed = 0.0;
+  for (size_t i = 0; i < depths.size(); ++i) {
+    const double speed = environment_.soundSpeed({x, y, depths[i]});
+    lowest = std::min(lowest, speed);
+    highest = std::max(highest, speed);
+    if (i > 0) {
+      weighted += 0.5 * (prevSpeed + speed) * (depths[i] - depths[i - 1]);
+    }
+    prevSpeed = speed;
+  }
+  if (highest - lowest > config_.maxSpeedSpreadMps) {
+    return std::nullopt;
+  }
+  const double span = depths.back() - depths.front();
+  return span > 0.0 ? weighted / span : lowest;
+}
+
+std::optional<acoustics::ArrivalPair>
+ImageSourceModel::arrivals(const Eigen::Vector3d &source,
+                           const Eigen::Vector3d &receiver) const {
+  if (!environment_.inWater(source) || !environment_.inWater(receiver)) {
+    return std::nullopt;
+  }
+  const Eigen::Vector3d mid = 0.5 * (source + receiver);
+  auto depth = environment_.bottomDepth(mid(0), mid(1));
+  if (!depth || source(2) > *depth || receiver(2) > *depth) {
+    return std::nullopt;
+  }
+  auto speed = isovelocitySpeed(mid(0), mid(1), *depth);
+  if (!speed) {
+    return std::nullopt;
+  }
+
+  const double r = (receiver.head(2) - source.head(2)).norm();
+  auto tof = [&](double vertical) {
+    return static_cast<float>(std::hypot(r, vertical) / *speed);
+  };
+
+  acoustics::ArrivalPair pair{};
+  const Eigen::Vector3d delta = receiver - source;
+  const int checks =
+      static_cast<int>(std::ceil(delta.norm() / kClearanceStepM));
+  bool clear = true;
+  for (int i = 1; i < checks && clear; ++i) {
+    const double t = static_cast<double>(i) / static_cast<double>(checks);
+    clear = environment_.inWater(source + t * delta);
+  }
+  if (clear) {
+    pair.directPath = tof(receiver(2) - source(2));
+  }
+
+  const double zs = source(2);
+  const double zr = receiver(2);
+  float fastestBounced = acoustics::kNoArrival;
+  for (int k = 1; k <= config_.maxBounces; ++k) {
+    const double term = k % 2 == 1 ? zs + zr : zs - zr;
+    const double surfaceFirst = 2.0 * *depth * (k / 2) + term;
+    const double bottomFirst = 2.0 * *depth * ((k + 1) / 2) - term;
+    for (double vertical : {surfaceFirst, bottomFirst}) {
+      const float t = tof(vertical);
+      if (fastestBounced < 0.0f || t < fastestBounced) {
+        fastestBounced = t;
+      }
+    }
+  }
+  pair.anyPath = pair.directPath >= 0.0f
+                     ? std::min(pair.directPath, fastestBounced)
+                     : fastestBounced;
+  return pair;
+}
+
+} // namespace sim
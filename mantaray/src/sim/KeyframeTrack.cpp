@@ -0,0 +1,84 @@
+#include "mantaray/sim/KeyframeTrack.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+void KeyframeTrack::add(const Keyframe &keyframe) {
+  lastResidualM_.reset();
+  auto predicted = interpolate(keyframe.rangeM);
+  if (predicted && keyframe.tofRawSec > 0.0f) {
+    const double speedMps = keyframe.rangeM / keyframe.tofRawSec;
+    lastResidualM_ = std::abs(*predicted - keyframe.tofRawSec) * speedMps;
+  }
+  if (count_ == 2) {
+    keyframes_[0] = keyframes_[1];
+    keyframes_[1] = keyframe;
+  } else {
+    keyframes_[count_++] = keyframe;
+  }
+}
+
+void KeyframeTrack::reset() {
+  count_ = 0;
+  lastResidualM_.reset();
+}
+
+std::optional<double> KeyframeTrack::interpolate(double rangeM) const {
+  if (count_ < 2) {
+    return std::nullopt;
+  }
+  const auto &k0 = keyframes_[0];
+  const auto &k1 = keyframes_[1];
+  if (k0.rangeM <= 0.0 || k1.rangeM <= 0.0) {
+    return std::nullopt;
+  }
+  const double slope0 = k0.tofRawSec / k0.rangeM;
+  const double slope1 = k1.tofRawSec / k1.rangeM;
+  const double low = std::min(k0.rangeM, k1.rangeM);
+  const double high = std::max(k0.rangeM, k1.rangeM);
+  if (rangeM < low || rangeM > high || high - low <= 0.0) {
+    // Scale the nearer keyframe
+    const bool nearFirst =
+        std::abs(rangeM - k0.rangeM) < std::abs(rangeM - k1.rangeM);
+    return rangeM * (nearFirst ? slope0 : slope1);
+  }
+  const double h = k1.rangeM - k0.rangeM;
+  const double t = (rangeM - k0.rangeM) / h;
+  const double t2 = t * t;
+  const double t3 = t2 * t;
+  return (2.0 * t3 - 3.0 * t2 + 1.0) * k0.tofRawSec +
+         (t3 - 2.0 * t2 + t) * h * slope0 +
+         (-2.0 * t3 + 3.0 * t2) * k1.tofRawSec + (t3 - t2) * h * slope1;
+}
+
+std::optional<KeyframeTrack::Prediction>
+KeyframeTrack::predict(double timeSec, double rangeM,
+                       const KeyframeConfig &config) const {
+  if (count_ < 2) {
+    return std::nullopt;
+  }
+  const auto &k0 = keyframes_[0];
+  const auto &k1 = keyframes_[1];
+  if (timeSec - k1.timeSec > config.maxIntervalSec ||
+      k0.multipathUsed != k1.multipathUsed ||
+      (lastResidualM_ && *lastResidualM_ > config.maxResidualM) ||
+      k1.tofRawSec <= 0.0f) {
+    return std::nullopt;
+  }
+  auto tof = interpolate(rangeM);
+  if (!tof) {
+    return std::nullopt;
+  }
+  const double speedMps = k1.rangeM / k1.tofRawSec;
+  const double residualM =
+      rangeM * std::abs(k0.tofRawSec / k0.rangeM - k1.tofRawSec / k1.rangeM) *
+      speedMps;
+  if (residualM > config.maxResidualM) {
+    return std::nullopt;
+  }
+  return Prediction{static_cast<float>(*tof), residualM, k1.multipathUsed};
+}
+
+} // namespace sim
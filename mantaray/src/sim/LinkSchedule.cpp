@@ -0,0 +1,74 @@
+#include "mantaray/sim/LinkSchedule.h"
+
+#include "mantaray/utils/checkAssert.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace sim {
+
+std::vector<bool> selectScheduledLinks(
+    LinkSchedule schedule, const std::vector<ScheduleCandidate> &candidates,
+    size_t numLinks, size_t numSlots, size_t pingIndex, size_t k,
+    std::mt19937_64 &rng) {
+  std::vector<bool> scheduled(numLinks, false);
+  for (const auto &candidate : candidates) {
+    CHECK(candidate.linkIdx < numLinks, "candidate link out of range");
+    CHECK(candidate.pingerSlot < numSlots, "pinger slot out of range");
+  }
+
+  switch (schedule) {
+  case LinkSchedule::kAllPairs:
+    for (const auto &candidate : candidates) {
+      scheduled[candidate.linkIdx] = true;
+    }
+    break;
+  case LinkSchedule::kTdma: {
+    if (numSlots == 0) {
+      break;
+    }
+    const size_t slot = pingIndex % numSlots;
+    for (const auto &candidate : candidates) {
+      if (candidate.pingerSlot == slot) {
+        scheduled[candidate.linkIdx] = true;
+      }
+    }
+    break;
+  }
+  case LinkSchedule::kRandomK: {
+    // Candidates grouped by pinger, in slot then link order
+    std::map<size_t, std::vector<size_t>> byPinger;
+    for (const auto &candidate : candidates) {
+      byPinger[candidate.pingerSlot].push_back(candidate.linkIdx);
+    }
+    for (auto &[slot, members] : byPinger) {
+      std::shuffle(members.begin(), members.end(), rng);
+      const size_t count = std::min(k, members.size());
+      for (size_t m = 0; m < count; ++m) {
+        scheduled[members[m]] = true;
+      }
+    }
+    break;
+  }
+  case LinkSchedule::kNearestK: {
+    std::map<size_t, std::vector<std::pair<double, size_t>>> byPinger;
+    for (const auto &candidate : candidates) {
+      byPinger[candidate.pingerSlot].emplace_back(candidate.rangeM,
+                                                  candidate.linkIdx);
+    }
+    for (auto &[slot, byRange] : byPinger) {
+      const size_t count = std::min(k, byRange.size());
+      std::partial_sort(byRange.begin(), byRange.begin() + count,
+                        byRange.end());
+      for (size_t m = 0; m < count; ++m) {
+        scheduled[byRange[m].second] = true;
+      }
+    }
+    break;
+  }
+  }
+  return scheduled;
+}
+
+} // namespace sim
@@ -0,0 +1,164 @@
+#include "mantaray/sim/MetricEnvironment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr double kKmToM = 1000.0;
+// Finite-difference half step for horizontal gradients (m)
+constexpr double kGradientStepM = 1.0;
+
+void scaleAxis(std::vector<double> &axis, double scale) {
+  for (auto &value : axis) {
+    value *= scale;
+  }
+}
+
+// Lower index and fraction of value within its cell, clamped to the axis
+std::pair<size_t, double> clampedCell(const std::vector<double> &axis,
+                                      double value) {
+  if (axis.size() < 2 || value <= axis.front()) {
+    return {0, 0.0};
+  }
+  if (value >= axis.back()) {
+    return {axis.size() - 2, 1.0};
+  }
+  auto upper = std::upper_bound(axis.begin(), axis.end(), value);
+  const auto lo =
+      static_cast<size_t>(std::distance(axis.begin(), upper)) - 1;
+  return {lo, (value - axis[lo]) / (axis[lo + 1] - axis[lo])};
+}
+
+// Half-open like acoustics::detail::bracketIndex, so interpolation succeeds
+bool onAxis(const std::vector<double> &axis, double value) {
+  return axis.size() >= 2 && value >= axis.front() && value < axis.back();
+}
+
+} // namespace
+
+namespace sim {
+
+MetricEnvironment::MetricEnvironment(
+    const acoustics::SSPConfig &ssp,
+    const acoustics::BathymetryConfig &bathymetry)
+    : ssp_(ssp.Grid.clone()), bathymetry_(bathymetry.Grid.clone()) {
+  if (ssp.isKm) {
+    scaleAxis(ssp_.xCoords, kKmToM);
+    scaleAxis(ssp_.yCoords, kKmToM);
+    scaleAxis(ssp_.zCoords, kKmToM);
+  }
+  if (bathymetry.isKm) {
+    scaleAxis(bathymetry_.xCoords, kKmToM);
+    scaleAxis(bathymetry_.yCoords, kKmToM);
+    scaleAxis(bathymetry_.data, kKmToM);
+  }
+}
+
+double MetricEnvironment::soundSpeed(const Eigen::Vector3d &position) const {
+  const auto [ix, fx] = clampedCell(ssp_.xCoords, position(0));
+  const auto [iy, fy] = clampedCell(ssp_.yCoords, position(1));
+  const auto [iz, fz] = clampedCell(ssp_.zCoords, position(2));
+  // A single-sample axis contributes its only value
+  const size_t jx = std::min(ix + 1, ssp_.nx() - 1);
+  const size_t jy = std::min(iy + 1, ssp_.ny() - 1);
+  const size_t jz = std::min(iz + 1, ssp_.nz() - 1);
+  auto lerp = [](double a, double b, double t) { return a + (b - a) * t; };
+  const double c00 = lerp(ssp_(ix, iy, iz), ssp_(jx, iy, iz), fx);
+  const double c01 = lerp(ssp_(ix, iy, jz), ssp_(jx, iy, jz), fx);
+  const double c10 = lerp(ssp_(ix, jy, iz), ssp_(jx, jy, iz), fx);
+  const double c11 = lerp(ssp_(ix, jy, jz), ssp_(jx, jy, jz), fx);
+  return lerp(lerp(c00, c10, fy), lerp(c01, c11, fy), fz);
+}
+
+std::optional<double> MetricEnvironment::bottomDepth(double x,
+                                                     double y) const {
+  if (!onAxis(bathymetry_.xCoords, x) || !onAxis(bathymetry_.yCoords, y)) {
+    return std::nullopt;
+  }
+  return bathymetry_.interpolateDataValue(x, y);
+}
+
+std::optional<acoustics::BearingSlice>
+MetricEnvironment::bearingSlice(const Eigen::Vector3d &source,
+                                const Eigen::Vector3d &receiver,
+                                double rangeStepM, double maxRangeM) const {
+  const Eigen::Vector2d delta = receiver.head(2) - source.head(2);
+  const double rangeM = delta.norm();
+  // A vertical link keeps any bearing; the slice still needs some extent
+  const Eigen::Vector2d dir =
+      rangeM > 0.0 ? Eigen::Vector2d{delta / rangeM} : Eigen::Vector2d::UnitX();
+  const auto [low, high] = ssp_.boundingBox();
+
+  acoustics::BearingSlice slice{};
+  const double endM = std::max(maxRangeM, rangeM + rangeStepM);
+  for (double r = 0.0; r <= endM + 0.5 * rangeStepM; r += rangeStepM) {
+    const Eigen::Vector2d xy = source.head(2) + r * dir;
+    auto bottom = bottomDepth(xy(0), xy(1));
+    if (!bottom || xy(0) < low(0) || xy(0) > high(0) || xy(1) < low(1) ||
+        xy(1) > high(1)) {
+      break;
+    }
+    slice.rangesM.push_back(r);
+    slice.bottomDepthsM.push_back(*bottom);
+  }
+  if (slice.rangesM.size() < 2 || slice.rangesM.back() < rangeM) {
+    return std::nullopt;
+  }
+
+  slice.depthsM = ssp_.zCoords;
+  const size_t nr = slice.rangesM.size();
+  slice.speeds.resize(slice.depthsM.size() * nr);
+  for (size_t iz = 0; iz < slice.depthsM.size(); ++iz) {
+    for (size_t ir = 0; ir < nr; ++ir) {
+      const Eigen::Vector2d xy = source.head(2) + slice.rangesM[ir] * dir;
+      slice.speeds[iz * nr + ir] =
+          soundSpeed({xy(0), xy(1), slice.depthsM[iz]});
+    }
+  }
+  return slice;
+}
+
+double
+MetricEnvironment::crossBearingGradient(const Eigen::Vector3d &source,
+                                        const Eigen::Vector3d &receiver,
+                                        double rangeStepM) const {
+  const Eigen::Vector2d delta = receiver.head(2) - source.head(2);
+  const double rangeM = delta.norm();
+  if (rangeM <= 0.0) {
+    return 0.0;
+  }
+  const Eigen::Vector2d dir = delta / rangeM;
+  const Eigen::Vector2d across{-dir(1), dir(0)};
+  const auto steps =
+      std::max<size_t>(1, static_cast<size_t>(std::ceil(rangeM / rangeStepM)));
+  double steepest = 0.0;
+  for (size_t i = 0; i <= steps; ++i) {
+    const double t = static_cast<double>(i) / static_cast<double>(steps);
+    const Eigen::Vector2d xy = source.head(2) + t * delta;
+    for (double z : ssp_.zCoords) {
+      const Eigen::Vector2d plus = xy + kGradientStepM * across;
+      const Eigen::Vector2d minus = xy - kGradientStepM * across;
+      const double gradient = (soundSpeed({plus(0), plus(1), z}) -
+                               soundSpeed({minus(0), minus(1), z})) /
+                              (2.0 * kGradientStepM);
+      steepest = std::max(steepest, std::abs(gradient));
+    }
+  }
+  return steepest;
+}
+
+bool MetricEnvironment::inWater(const Eigen::Vector3d &position) const {
+  const auto [low, high] = ssp_.boundingBox();
+  for (int axis = 0; axis < 3; ++axis) {
+    if (position(axis) < low(axis) || position(axis) > high(axis)) {
+      return false;
+    }
+  }
+  auto bottom = bottomDepth(position(0), position(1));
+  return bottom && position(2) < *bottom;
+}
+
+} // namespace sim
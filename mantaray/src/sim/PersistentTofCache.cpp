@@ -0,0 +1,350 @@
+#include "mantaray/sim/PersistentTofCache.h"
+
+#include "mantaray/utils/Logger.h"
+#include "mantaray/utils/checkAssert.h"
+
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::array<char, 8> kMagic{'M', 'R', 'T', 'O', 'F', 'C', 'C', '\0'};
+constexpr uint32_t kVersion = 2;
+// Slots tried after the home slot before an insert is dropped
+constexpr size_t kMaxProbes = 32;
+
+// FNV-1a, stable across runs and platforms of the same endianness
+class Fnv1a {
+public:
+  template <typename T> void add(const T &value) {
+    const auto *bytes = reinterpret_cast<const unsigned char *>(&value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      hash_ = (hash_ ^ bytes[i]) * 0x100000001b3ULL;
+    }
+  }
+  void add(const std::vector<double> &values) {
+    add(values.size());
+    for (double v : values) {
+      add(v);
+    }
+  }
+  void add(const std::string &text) {
+    add(text.size());
+    for (char c : text) {
+      add(c);
+    }
+  }
+  uint64_t value() const { return hash_; }
+
+private:
+  uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+// Holds a flock for its lifetime
+class FileLock {
+public:
+  FileLock(int fd, int operation) : fd_(fd) {
+    while (::flock(fd_, operation) != 0) {
+      if (errno != EINTR) {
+        throw std::runtime_error(std::string("Cannot lock TOF cache file: ") +
+                                 std::strerror(errno));
+      }
+    }
+  }
+  ~FileLock() { ::flock(fd_, LOCK_UN); }
+  FileLock(const FileLock &) = delete;
+  FileLock &operator=(const FileLock &) = delete;
+
+private:
+  int fd_;
+};
+
+} // namespace
+
+namespace sim {
+
+struct PersistentTofCache::Header {
+  std::array<char, 8> magic{};
+  uint32_t version{0};
+  uint32_t slotBytes{0};
+  uint64_t environmentHash{0};
+  uint64_t capacity{0};
+  uint64_t count{0};
+};
+
+struct PersistentTofCache::Slot {
+  uint64_t hash{0};
+  std::array<int64_t, 6> cells{};
+  std::array<double, 3> first{};
+  std::array<double, 3> second{};
+  int32_t numBeams{0};
+  int32_t maxBeams{0};
+  int32_t numBearingBeams{0};
+  int32_t maxBearingBeams{0};
+  double beamSpreadDeg{0.0};
+  double bearingSpreadDeg{0.0};
+  float tofRawSec{-1.0f};
+  uint8_t allowMultipath{0};
+  uint8_t multipathUsed{0};
+  uint8_t occupied{0};
+};
+
+namespace {
+
+// Canonical slot key: cells ordered as in TofCache, and the beam settings
+struct SlotKey {
+  std::array<int64_t, 6> cells{};
+  bool swapped{false};
+  uint64_t hash{0};
+};
+
+SlotKey makeSlotKey(const Eigen::Vector3d &a, const Eigen::Vector3d &b,
+                    const TofBeamSettings &beam, double tolerance) {
+  std::array<int64_t, 3> cellA{};
+  std::array<int64_t, 3> cellB{};
+  for (int i = 0; i < 3; ++i) {
+    cellA[i] = static_cast<int64_t>(std::floor(a(i) / tolerance));
+    cellB[i] = static_cast<int64_t>(std::floor(b(i) / tolerance));
+  }
+  SlotKey key{};
+  key.swapped = cellB < cellA;
+  const auto &first = key.swapped ? cellB : cellA;
+  const auto &second = key.swapped ? cellA : cellB;
+  Fnv1a fnv;
+  for (int i = 0; i < 3; ++i) {
+    key.cells[i] = first[i];
+    key.cells[i + 3] = second[i];
+  }
+  for (auto c : key.cells) {
+    fnv.add(c);
+  }
+  fnv.add(beam.numBeams);
+  fnv.add(beam.maxBeams);
+  fnv.add(beam.beamSpreadDeg);
+  fnv.add(beam.allowMultipath);
+  fnv.add(beam.numBearingBeams);
+  fnv.add(beam.maxBearingBeams);
+  fnv.add(beam.bearingSpreadDeg);
+  key.hash = fnv.value();
+  return key;
+}
+
+template <typename SlotT>
+bool matches(const SlotT &slot, const SlotKey &key,
+             const TofBeamSettings &beam) {
+  return slot.hash == key.hash && slot.cells == key.cells &&
+         slot.numBeams == beam.numBeams && slot.maxBeams == beam.maxBeams &&
+         slot.beamSpreadDeg == beam.beamSpreadDeg &&
+         static_cast<bool>(slot.allowMultipath) == beam.allowMultipath &&
+         slot.numBearingBeams == beam.numBearingBeams &&
+         slot.maxBearingBeams == beam.maxBearingBeams &&
+         slot.bearingSpreadDeg == beam.bearingSpreadDeg;
+}
+
+} // namespace
+
+PersistentTofCache::PersistentTofCache(const std::filesystem::path &directory,
+                                       uint64_t environmentHash,
+                                       double toleranceMeters, size_t slots)
+    : tolerance_(toleranceMeters) {
+  CHECK(toleranceMeters > 0.0 && slots > 0,
+        "Persistent TOF cache needs a positive tolerance and slot count");
+  std::filesystem::create_directories(directory);
+  path_ = directory / fmt::format("tofcache-{:016x}.bin", environmentHash);
+  fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error("Cannot open TOF cache file " + path_.string() +
+                             ": " + std::strerror(errno));
+  }
+  auto fail = [this](const std::string &message) {
+    ::close(fd_);
+    fd_ = -1;
+    throw std::runtime_error("TOF cache file " + path_.string() + ": " +
+                             message);
+  };
+
+  Header stored{};
+  {
+    FileLock lock(fd_, LOCK_EX);
+    struct stat st {};
+    if (::fstat(fd_, &st) != 0) {
+      fail(std::strerror(errno));
+    }
+    if (st.st_size == 0) {
+      Header fresh{};
+      fresh.magic = kMagic;
+      fresh.version = kVersion;
+      fresh.slotBytes = sizeof(Slot);
+      fresh.environmentHash = environmentHash;
+      fresh.capacity = slots;
+      // Sparse on most filesystems; untouched slots read as empty
+      const auto bytes =
+          static_cast<off_t>(sizeof(Header) + slots * sizeof(Slot));
+      if (::ftruncate(fd_, bytes) != 0 ||
+          ::pwrite(fd_, &fresh, sizeof(fresh), 0) !=
+              static_cast<ssize_t>(sizeof(fresh))) {
+        fail(std::strerror(errno));
+      }
+    }
+    if (::pread(fd_, &stored, sizeof(stored), 0) !=
+        static_cast<ssize_t>(sizeof(stored))) {
+      fail("truncated header");
+    }
+    if (::fstat(fd_, &st) != 0) {
+      fail(std::strerror(errno));
+    }
+    mappedBytes_ = sizeof(Header) + stored.capacity * sizeof(Slot);
+    if (stored.magic != kMagic || stored.version != kVersion ||
+        stored.slotBytes != sizeof(Slot) ||
+        stored.environmentHash != environmentHash ||
+        static_cast<size_t>(st.st_size) != mappedBytes_) {
+      fail("not a cache for this environment and build");
+    }
+  }
+  capacity_ = stored.capacity;
+  mapping_ = ::mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd_, 0);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    fail(std::strerror(errno));
+  }
+  if (capacity_ != slots) {
+    SPDLOG_INFO("Persistent TOF cache keeps its existing {} slots", capacity_);
+  }
+  SPDLOG_INFO("Persistent TOF cache {}: {} of {} slots used", path_.string(),
+              size(), capacity_);
+}
+
+PersistentTofCache::~PersistentTofCache() {
+  if (mapping_) {
+    ::munmap(mapping_, mappedBytes_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+uint64_t PersistentTofCache::environmentHash(
+    const acoustics::SSPConfig &ssp,
+    const acoustics::BathymetryConfig &bathymetry, double toleranceMeters,
+    const std::string &runSignature) {
+  Fnv1a fnv;
+  fnv.add(kVersion);
+  fnv.add(ssp.Grid.xCoords);
+  fnv.add(ssp.Grid.yCoords);
+  fnv.add(ssp.Grid.zCoords);
+  fnv.add(ssp.Grid.data);
+  fnv.add(ssp.isKm);
+  fnv.add(bathymetry.Grid.xCoords);
+  fnv.add(bathymetry.Grid.yCoords);
+  fnv.add(bathymetry.Grid.data);
+  fnv.add(bathymetry.interpolation);
+  fnv.add(bathymetry.isKm);
+  fnv.add(toleranceMeters);
+  fnv.add(runSignature);
+  return fnv.value();
+}
+
+PersistentTofCache::Header &PersistentTofCache::header() const {
+  return *static_cast<Header *>(mapping_);
+}
+
+PersistentTofCache::Slot *PersistentTofCache::slots() const {
+  return reinterpret_cast<Slot *>(static_cast<char *>(mapping_) +
+                                  sizeof(Header));
+}
+
+size_t PersistentTofCache::size() const {
+  FileLock lock(fd_, LOCK_SH);
+  return header().count;
+}
+
+std::optional<TofCache::Entry>
+PersistentTofCache::lookup(const Eigen::Vector3d &pinger,
+                           const Eigen::Vector3d &target,
+                           const TofBeamSettings &beam) {
+  const auto key = makeSlotKey(pinger, target, beam, tolerance_);
+  const Eigen::Vector3d &first = key.swapped ? target : pinger;
+  const Eigen::Vector3d &second = key.swapped ? pinger : target;
+  FileLock lock(fd_, LOCK_SH);
+  for (size_t probe = 0; probe <= kMaxProbes; ++probe) {
+    const Slot &slot = slots()[(key.hash + probe) % capacity_];
+    if (!slot.occupied) {
+      break;
+    }
+    if (!matches(slot, key, beam)) {
+      continue;
+    }
+    const Eigen::Vector3d storedFirst{slot.first.data()};
+    const Eigen::Vector3d storedSecond{slot.second.data()};
+    if ((first - storedFirst).norm() > tolerance_ ||
+        (second - storedSecond).norm() > tolerance_) {
+      break;
+    }
+    const double cachedRange = (storedFirst - storedSecond).norm();
+    const double queryRange = (first - second).norm();
+    TofCache::Entry entry{slot.tofRawSec, slot.multipathUsed != 0};
+    if (cachedRange > 0.0) {
+      entry.tofRawSec = static_cast<float>(
+          static_cast<double>(slot.tofRawSec) * queryRange / cachedRange);
+    }
+    ++stats_.hits;
+    return entry;
+  }
+  ++stats_.misses;
+  return std::nullopt;
+}
+
+void PersistentTofCache::insert(const Eigen::Vector3d &pinger,
+                                const Eigen::Vector3d &target,
+                                const TofBeamSettings &beam,
+                                const TofCache::Entry &entry) {
+  if (entry.tofRawSec < 0.0f) {
+    return;
+  }
+  const auto key = makeSlotKey(pinger, target, beam, tolerance_);
+  const Eigen::Vector3d &first = key.swapped ? target : pinger;
+  const Eigen::Vector3d &second = key.swapped ? pinger : target;
+  FileLock lock(fd_, LOCK_EX);
+  for (size_t probe = 0; probe <= kMaxProbes; ++probe) {
+    Slot &slot = slots()[(key.hash + probe) % capacity_];
+    const bool fresh = !slot.occupied;
+    if (!fresh && !matches(slot, key, beam)) {
+      continue;
+    }
+    slot.hash = key.hash;
+    slot.cells = key.cells;
+    for (int i = 0; i < 3; ++i) {
+      slot.first[i] = first(i);
+      slot.second[i] = second(i);
+    }
+    slot.numBeams = beam.numBeams;
+    slot.maxBeams = beam.maxBeams;
+    slot.numBearingBeams = beam.numBearingBeams;
+    slot.maxBearingBeams = beam.maxBearingBeams;
+    slot.beamSpreadDeg = beam.beamSpreadDeg;
+    slot.bearingSpreadDeg = beam.bearingSpreadDeg;
+    slot.allowMultipath = beam.allowMultipath;
+    slot.tofRawSec = entry.tofRawSec;
+    slot.multipathUsed = entry.multipathUsed;
+    slot.occupied = 1;
+    if (fresh) {
+      ++header().count;
+    }
+    ++stats_.inserts;
+    return;
+  }
+  ++stats_.dropped;
+}
+
+} // namespace sim
@@ -0,0 +1,68 @@
+#include "mantaray/sim/PingBudget.h"
+
+#include <algorithm>
+
+namespace sim {
+
+namespace {
+bool pastLimit(PingBudget::Clock::time_point start,
+               PingBudget::Clock::time_point now, double limitSec) {
+  return limitSec > 0.0 &&
+         std::chrono::duration<double>(now - start).count() >= limitSec;
+}
+} // namespace
+
+PingBudget::PingBudget(const BudgetConfig &config, Clock::time_point start)
+    : config_(config), start_(start) {}
+
+PingBudget::Link PingBudget::startLink(Clock::time_point now) {
+  return Link(*this, now, 0);
+}
+
+PingBudget::Link PingBudget::startLink(int64_t rayAllowance,
+                                       Clock::time_point now) {
+  return Link(*this, now, rayAllowance);
+}
+
+bool PingBudget::reserve(int64_t rays) {
+  if (config_.pingRays > 0 && rays_ + reserved_ + rays > config_.pingRays) {
+    return false;
+  }
+  reserved_ += rays;
+  return true;
+}
+
+int64_t PingBudget::reserveUpTo(int64_t rays) {
+  if (config_.pingRays > 0) {
+    rays = std::clamp<int64_t>(config_.pingRays - rays_ - reserved_, 0, rays);
+  }
+  reserved_ += rays;
+  return rays;
+}
+
+void PingBudget::charge(int64_t rays) { rays_ += rays; }
+
+bool PingBudget::exhausted(Clock::time_point now) const {
+  return pastLimit(start_, now, config_.pingSeconds) ||
+         (config_.pingRays > 0 && rays_ >= config_.pingRays);
+}
+
+bool PingBudget::timedOut(Clock::time_point now) const {
+  return pastLimit(start_, now, config_.pingSeconds);
+}
+
+void PingBudget::Link::charge(int64_t rays) {
+  rays_ += rays;
+  ping_->charge(rays);
+}
+
+bool PingBudget::Link::exhausted(Clock::time_point now) const {
+  const auto &config = ping_->config();
+  const bool pingOut = allowance_ > 0
+                           ? ping_->timedOut(now) || rays_ >= allowance_
+                           : ping_->exhausted(now);
+  return pingOut || pastLimit(start_, now, config.linkSeconds) ||
+         (config.linkRays > 0 && rays_ >= config.linkRays);
+}
+
+} // namespace sim
@@ -0,0 +1,132 @@
+#include "mantaray/sim/RayBundle.h"
+
+#include "mantaray/utils/checkAssert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace sim {
+
+RayBundle::RayBundle(const RayBundleConfig &config)
+    : config_(config), index_(config.pointSpacingM) {
+  CHECK(config.pointSpacingM > 0.0 && config.maxMissM > 0.0,
+        "Ray bundle spacing and miss distance must be positive");
+}
+
+void RayBundle::addRay(const std::vector<RayPoint> &points) {
+  if (points.size() < 2) {
+    return;
+  }
+  const auto ray = static_cast<uint32_t>(rayStarts_.size());
+  rayStarts_.push_back(points_.size());
+  auto store = [&](const RayPoint &point) {
+    if (points_.size() > rayStarts_.back()) {
+      maxSegmentM_ = std::max(
+          maxSegmentM_,
+          (point.position - points_.back().position.cast<double>()).norm());
+    }
+    index_.insert(points_.size(), point.position);
+    points_.push_back(StoredPoint{point.position.cast<float>(),
+                                  static_cast<float>(point.tau), point.bounces,
+                                  ray});
+  };
+
+  store(points.front());
+  for (size_t i = 1; i + 1 < points.size(); ++i) {
+    const auto &last = points_.back();
+    // Bounce changes are kept so direct segments end where the ray reflects
+    if (points[i].bounces != last.bounces ||
+        (points[i].position - last.position.cast<double>()).norm() >=
+            config_.pointSpacingM) {
+      store(points[i]);
+    }
+  }
+  store(points.back());
+}
+
+acoustics::ArrivalPair
+RayBundle::lookup(const Eigen::Vector3d &receiver) const {
+  struct Candidate {
+    double miss{0.0};
+    double tau{0.0};
+    int32_t bounces{0};
+  };
+  // Closest segment of each ray: [0] direct so far, [1] any
+  std::map<uint32_t, Candidate> best[2];
+
+  const double radius = config_.maxMissM + maxSegmentM_;
+  for (size_t id : index_.query(receiver, radius)) {
+    // Each segment is visited from its first point only
+    if (id + 1 >= points_.size() || points_[id + 1].ray != points_[id].ray) {
+      continue;
+    }
+    const auto &a = points_[id];
+    const auto &b = points_[id + 1];
+    const Eigen::Vector3d pa = a.position.cast<double>();
+    const Eigen::Vector3d segment = b.position.cast<double>() - pa;
+    const double length = segment.norm();
+    if (length <= 0.0 || b.tau <= a.tau) {
+      continue;
+    }
+    const Eigen::Vector3d tangent = segment / length;
+    const double s = std::clamp((receiver - pa).dot(tangent), 0.0, length);
+    const Eigen::Vector3d closest = pa + s * tangent;
+    const double miss = (receiver - closest).norm();
+    if (miss > config_.maxMissM) {
+      continue;
+    }
+    // tau(Q) plus the along-ray remainder, which is non-zero past the ends
+    const double speed = length / static_cast<double>(b.tau - a.tau);
+    const double tau = a.tau + s / speed +
+                       (receiver - closest).dot(tangent) / speed;
+    const Candidate candidate{miss, tau, std::max(a.bounces, b.bounces)};
+    const bool direct = a.bounces == 0 && b.bounces == 0;
+    for (int kind = direct ? 0 : 1; kind < 2; ++kind) {
+      auto [it, inserted] = best[kind].emplace(a.ray, candidate);
+      if (!inserted && miss < it->second.miss) {
+        it->second = candidate;
+      }
+    }
+  }
+
+  // Averages the nearest rays with the fewest bounces; rays along different
+  // paths would mix unrelated arrivals
+  auto blend = [](const std::map<uint32_t, Candidate> &rays) {
+    if (rays.empty()) {
+      return acoustics::kNoArrival;
+    }
+    int32_t fewest = rays.begin()->second.bounces;
+    for (const auto &[ray, candidate] : rays) {
+      fewest = std::min(fewest, candidate.bounces);
+    }
+    std::vector<Candidate> nearest;
+    nearest.reserve(rays.size());
+    for (const auto &[ray, candidate] : rays) {
+      if (candidate.bounces == fewest) {
+        nearest.push_back(candidate);
+      }
+    }
+    const size_t n = std::min(kBracketRays, nearest.size());
+    std::partial_sort(
+        nearest.begin(), nearest.begin() + static_cast<std::ptrdiff_t>(n),
+        nearest.end(),
+        [](const Candidate &l, const Candidate &r) { return l.miss < r.miss; });
+    constexpr double kMinMissM = 1e-3;
+    double weightSum = 0.0;
+    double tauSum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      const double weight = 1.0 / std::max(nearest[i].miss, kMinMissM);
+      weightSum += weight;
+      tauSum += weight * nearest[i].tau;
+    }
+    return static_cast<float>(tauSum / weightSum);
+  };
+
+  acoustics::ArrivalPair pair;
+  pair.directPath = blend(best[0]);
+  pair.anyPath = blend(best[1]);
+  return pair;
+}
+
+} // namespace sim
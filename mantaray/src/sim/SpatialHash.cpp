@@ -0,0 +1,72 @@
+#include "mantaray/sim/SpatialHash.h"
+
+#include "mantaray/utils/checkAssert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace sim {
+
+SpatialHash::SpatialHash(double cellSizeMeters) : cellSize_(cellSizeMeters) {
+  CHECK(cellSizeMeters > 0.0, "Spatial hash cell size must be positive");
+}
+
+size_t SpatialHash::CellHash::operator()(const Cell &cell) const noexcept {
+  // boost::hash_combine style mixing
+  size_t seed = 0;
+  for (auto c : cell) {
+    seed ^= std::hash<int64_t>{}(c) + 0x9e3779b97f4a7c15ULL + (seed << 6) +
+            (seed >> 2);
+  }
+  return seed;
+}
+
+SpatialHash::Cell SpatialHash::cellOf(const Eigen::Vector3d &position) const {
+  Cell cell{};
+  for (int i = 0; i < 3; ++i) {
+    cell[i] = static_cast<int64_t>(std::floor(position(i) / cellSize_));
+  }
+  return cell;
+}
+
+void SpatialHash::clear() {
+  cells_.clear();
+  size_ = 0;
+}
+
+void SpatialHash::insert(size_t id, const Eigen::Vector3d &position) {
+  cells_[cellOf(position)].push_back(Point{id, position});
+  ++size_;
+}
+
+std::vector<size_t> SpatialHash::query(const Eigen::Vector3d &position,
+                                       double radiusMeters) const {
+  std::vector<size_t> ids;
+  if (radiusMeters < 0.0) {
+    return ids;
+  }
+  const Cell center = cellOf(position);
+  const auto reach = static_cast<int64_t>(std::ceil(radiusMeters / cellSize_));
+  const double radiusSq = radiusMeters * radiusMeters;
+  for (int64_t dx = -reach; dx <= reach; ++dx) {
+    for (int64_t dy = -reach; dy <= reach; ++dy) {
+      for (int64_t dz = -reach; dz <= reach; ++dz) {
+        auto it = cells_.find(Cell{center[0] + dx, center[1] + dy,
+                                   center[2] + dz});
+        if (it == cells_.end()) {
+          continue;
+        }
+        for (const auto &point : it->second) {
+          if ((point.position - position).squaredNorm() <= radiusSq) {
+            ids.push_back(point.id);
+          }
+        }
+      }
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+} // namespace sim
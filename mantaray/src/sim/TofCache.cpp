@@ -0,0 +1,93 @@
+#include "mantaray/sim/TofCache.h"
+
+#include <cmath>
+#include <functional>
+
+namespace sim {
+
+TofCache::TofCache(double toleranceMeters) : tolerance_(toleranceMeters) {}
+
+size_t TofCache::KeyHash::operator()(const Key &key) const noexcept {
+  // boost::hash_combine style mixing
+  size_t seed = 0;
+  auto combine = [&seed](auto value) {
+    seed ^= std::hash<decltype(value)>{}(value) + 0x9e3779b97f4a7c15ULL +
+            (seed << 6) + (seed >> 2);
+  };
+  for (auto c : key.first) {
+    combine(c);
+  }
+  for (auto c : key.second) {
+    combine(c);
+  }
+  combine(key.beam.numBeams);
+  combine(key.beam.maxBeams);
+  combine(key.beam.beamSpreadDeg);
+  combine(key.beam.allowMultipath);
+  combine(key.beam.numBearingBeams);
+  combine(key.beam.maxBearingBeams);
+  combine(key.beam.bearingSpreadDeg);
+  return seed;
+}
+
+TofCache::Cell TofCache::cellOf(const Eigen::Vector3d &position) const {
+  Cell cell{};
+  for (int i = 0; i < 3; ++i) {
+    cell[i] = static_cast<int64_t>(std::floor(position(i) / tolerance_));
+  }
+  return cell;
+}
+
+std::pair<TofCache::Key, bool>
+TofCache::makeKey(const Eigen::Vector3d &a, const Eigen::Vector3d &b,
+                  const TofBeamSettings &beam) const {
+  Cell cellA = cellOf(a);
+  Cell cellB = cellOf(b);
+  if (cellB < cellA) {
+    return {Key{cellB, cellA, beam}, true};
+  }
+  return {Key{cellA, cellB, beam}, false};
+}
+
+std::optional<TofCache::Entry>
+TofCache::lookup(const Eigen::Vector3d &pinger, const Eigen::Vector3d &target,
+                 const TofBeamSettings &beam) const {
+  if (!enabled()) {
+    return std::nullopt;
+  }
+  auto [key, swapped] = makeKey(pinger, target, beam);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  const Eigen::Vector3d &first = swapped ? target : pinger;
+  const Eigen::Vector3d &second = swapped ? pinger : target;
+  const Stored &stored = it->second;
+  if ((first - stored.first).norm() > tolerance_ ||
+      (second - stored.second).norm() > tolerance_) {
+    return std::nullopt;
+  }
+
+  const double cachedRange = (stored.first - stored.second).norm();
+  const double queryRange = (first - second).norm();
+  Entry corrected = stored.entry;
+  if (cachedRange > 0.0) {
+    corrected.tofRawSec = static_cast<float>(
+        static_cast<double>(stored.entry.tofRawSec) * queryRange /
+        cachedRange);
+  }
+  return corrected;
+}
+
+void TofCache::insert(const Eigen::Vector3d &pinger,
+                      const Eigen::Vector3d &target,
+                      const TofBeamSettings &beam, const Entry &entry) {
+  if (!enabled() || entry.tofRawSec < 0.0f) {
+    return;
+  }
+  auto [key, swapped] = makeKey(pinger, target, beam);
+  Stored stored{swapped ? target : pinger, swapped ? pinger : target, entry};
+  entries_.insert_or_assign(key, stored);
+}
+
+} // namespace sim
@@ -0,0 +1,39 @@
+#include "mantaray/sim/TofLadder.h"
+
+#include <cmath>
+
+namespace sim {
+
+TofLadder::Verdict TofLadder::addLevel(const acoustics::ArrivalPair &arrivals,
+                                       bool fullFan) {
+  Verdict verdict{};
+  // Direct path found — accept immediately, no convergence needed
+  if (arrivals.directPath >= 0.0f) {
+    verdict.accepted = true;
+    verdict.tofRawSec = arrivals.directPath;
+    return verdict;
+  }
+  if (!fullFan || arrivals.anyPath < 0.0f) {
+    return verdict;
+  }
+
+  if (allowMultipath_ && prevAnyTof_ >= 0.0f) {
+    verdict.compared = true;
+    if (converged(arrivals.anyPath, prevAnyTof_, verdict.delta)) {
+      verdict.accepted = true;
+      verdict.tofRawSec = arrivals.anyPath;
+      verdict.multipathUsed = true;
+    }
+  }
+  prevAnyTof_ = arrivals.anyPath;
+  return verdict;
+}
+
+bool TofLadder::converged(float curr, float prev, float &delta) {
+  delta = std::abs(curr - prev);
+  float tolerance =
+      static_cast<float>(kConvergenceAtol + kConvergenceRtol * std::abs(prev));
+  return delta < tolerance;
+}
+
+} // namespace sim
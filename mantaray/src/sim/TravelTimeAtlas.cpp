@@ -0,0 +1,108 @@
+#include "mantaray/sim/TravelTimeAtlas.h"
+
+#include "acoustics/acousticsConstants.h"
+#include "mantaray/utils/checkAssert.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+namespace {
+
+// Lower cell index and fractional offset, or nullopt off the axis
+std::optional<std::pair<size_t, double>>
+bracket(const std::vector<double> &axis, double value) {
+  if (axis.size() < 2 || value < axis.front() || value > axis.back()) {
+    return std::nullopt;
+  }
+  auto upper = std::upper_bound(axis.begin(), axis.end(), value);
+  size_t lo = static_cast<size_t>(std::distance(axis.begin(), upper));
+  lo = std::min(lo, axis.size() - 1) - 1;
+  return std::make_pair(lo, (value - axis[lo]) / (axis[lo + 1] - axis[lo]));
+}
+
+std::vector<double> evenAxis(double low, double high, double step) {
+  CHECK(step > 0.0 && high > low, "Atlas axis needs a positive step and span");
+  const auto n = static_cast<size_t>(std::ceil((high - low) / step)) + 1;
+  std::vector<double> axis(n);
+  for (size_t i = 0; i < n; ++i) {
+    axis[i] = low + (high - low) * static_cast<double>(i) /
+                        static_cast<double>(n - 1);
+  }
+  return axis;
+}
+
+} // namespace
+
+namespace sim {
+
+TravelTimeAtlas::Axes TravelTimeAtlas::makeAxes(const AtlasGridConfig &config,
+                                                double minDepthM,
+                                                double maxDepthM) {
+  return Axes{evenAxis(-180.0, 180.0, config.bearingStepDeg),
+              evenAxis(0.0, config.maxRangeM, config.rangeStepM),
+              evenAxis(minDepthM, maxDepthM, config.depthStepM)};
+}
+
+TravelTimeAtlas::TravelTimeAtlas(
+    const Eigen::Vector3d &source, const Axes &axes,
+    const std::vector<acoustics::ArrivalPair> &arrivals)
+    : source_(source),
+      direct_(axes.bearingsDeg, axes.rangesM, axes.depthsM,
+              double{acoustics::kNoArrival}),
+      any_(axes.bearingsDeg, axes.rangesM, axes.depthsM,
+           double{acoustics::kNoArrival}) {
+  CHECK(arrivals.size() == direct_.size(),
+        "Atlas needs one arrival per receiver cell");
+  size_t cell = 0;
+  for (size_t ib = 0; ib < direct_.nx(); ++ib) {
+    for (size_t iz = 0; iz < direct_.nz(); ++iz) {
+      for (size_t ir = 0; ir < direct_.ny(); ++ir, ++cell) {
+        direct_(ib, ir, iz) = arrivals[cell].directPath;
+        any_(ib, ir, iz) = arrivals[cell].anyPath;
+        directCells_ += arrivals[cell].directPath >= 0.0f ? 1 : 0;
+      }
+    }
+  }
+}
+
+acoustics::ArrivalPair
+TravelTimeAtlas::lookup(const Eigen::Vector3d &receiver) const {
+  const Eigen::Vector2d delta = receiver.head(2) - source_.head(2);
+  const double bearingDeg =
+      std::atan2(delta(1), delta(0)) * acoustics::kRadians2Degree;
+  auto b = bracket(direct_.xCoords, bearingDeg);
+  auto r = bracket(direct_.yCoords, delta.norm());
+  auto z = bracket(direct_.zCoords, receiver(2));
+  if (!b || !r || !z) {
+    return acoustics::ArrivalPair{};
+  }
+
+  // https://en.wikipedia.org/wiki/Trilinear_interpolation
+  auto interpolate = [&](const acoustics::Grid3D &field) {
+    double value = 0.0;
+    for (size_t corner = 0; corner < 8; ++corner) {
+      const size_t db = corner & 1U;
+      const size_t dr = (corner >> 1U) & 1U;
+      const size_t dz = (corner >> 2U) & 1U;
+      const double tof =
+          field(b->first + db, r->first + dr, z->first + dz);
+      if (tof < 0.0) {
+        return acoustics::kNoArrival;
+      }
+      const double weight = (db ? b->second : 1.0 - b->second) *
+                            (dr ? r->second : 1.0 - r->second) *
+                            (dz ? z->second : 1.0 - z->second);
+      value += weight * tof;
+    }
+    return static_cast<float>(value);
+  };
+  acoustics::ArrivalPair pair;
+  pair.directPath = interpolate(direct_);
+  pair.anyPath = interpolate(any_);
+  return pair;
+}
+
+} // namespace sim
@@ -12,6 +12,7 @@
 // #define BHC_DLL_IMPORT 1
 #include "acoustics/Arrival.h"
 #include "acoustics/BellhopContext.h"
+#include "acoustics/BellhopMemory.h"
 #include "acoustics/acousticsConstants.h"
 #include "acoustics/helpers.h"
 #include <mantaray/config/EnvironmentConfig.h>
@@ -23,8 +24,10 @@
 #include "rb/RbWorld.h"
 #include "rb/RobotsAndSensors.h"
 #include <mantaray/sim/AcousticPairwiseRangeSystem.h>
+#include <mantaray/sim/BellhopWorkerPool.h>
 #include <mantaray/sim/CurrentDriftRobot.h>
 #include <mantaray/sim/RobotFactory.h>
+#include <mantaray/utils/PfgMerge.h>
 #include <mantaray/utils/PfgWriter.h>
 
 void PrtCallback(const char *message) { bellhop_logger->debug("{}", message); }
@@ -33,13 +36,44 @@ void OutputCallback(const char *message) {
 }
 
 config::SimConfig parseArgs(int argc, char *argv[]) {
-  if (argc < 2) {
-    fmt::print(stderr, "Usage: {} <sim_config.json>\n", argv[0]);
+  if (argc != 2 && !(argc == 4 && std::string(argv[2]) == "--shard")) {
+    fmt::print(stderr, "Usage: {} <sim_config.json> [--shard K/N]\n",
+               argv[0]);
     std::exit(1);
   }
 
   auto config = config::loadSimConfig(argv[1]);
 
+  // Shard K of N traces every Nth ping epoch, starting at epoch K
+  if (argc == 4) {
+    std::string spec = argv[3];
+    auto slash = spec.find('/');
+    try {
+      if (slash == std::string::npos) {
+        throw std::invalid_argument(spec);
+      }
+      config.shardIndex = std::stoul(spec.substr(0, slash));
+      config.shardCount = std::stoul(spec.substr(slash + 1));
+    } catch (const std::exception &) {
+      fmt::print(stderr, "Error: shard spec must be K/N, got: {}\n", spec);
+      std::exit(1);
+    }
+    if (config.shardCount == 0 || config.shardIndex >= config.shardCount) {
+      fmt::print(stderr, "Error: shard index must be in [0, N): {}\n", spec);
+      std::exit(1);
+    }
+    if (config.asyncPipeline) {
+      fmt::print(stderr, "Error: --shard cannot be used with async_pipeline\n");
+      std::exit(1);
+    }
+    config.offlinePings = true;
+    // Shards of one config get sibling output directories
+    config.outputDir =
+        (std::filesystem::path(config.outputDir) /
+         fmt::format("shard_{}_of_{}", config.shardIndex, config.shardCount))
+            .string();
+  }
+
   auto outDir = std::filesystem::path(config.outputDir);
   if (std::filesystem::exists(outDir) && !std::filesystem::is_empty(outDir)) {
     fmt::print(stderr, "Error: output directory is not empty: {}\n",
@@ -80,20 +114,14 @@ int main(int argc, char *argv[]) {
   init.outputCallback = OutputCallback;
   init.maxMemory = config.bellhopMemoryMib * 1024ull * 1024ull;
   // init.maxMemory = 4ull * 1024ull * 1024ull * 1024ull;
-  init.numThreads = -1;
+  init.numThreads = sim::BellhopWorkerPool::bellhopThreadsPerWorker(
+      config.bellhopThreads, config.workerThreads);
 
   auto envConfig = config::EnvironmentConfig(config.envConfigFile);
   auto importedBathGrid = envConfig.readBathymetry();
   auto importedSSPGrid = envConfig.readSSP();
   auto importedCurrentGrid = envConfig.readCurrent();
 
-  auto context = acoustics::BhContext<true, true>(init);
-  // Full RunType: [0]=Arrivals [1]=Geometric [2-3]=unused [4]=Irregular grid
-  // [5]=3D
-  strcpy(context.params().Beam->RunType, "AG  I3");
-  strncpy(context.params().Title, config.runName.c_str(),
-          sizeof(context.params().Title) - 1);
-
   auto bathConfig = acoustics::BathymetryConfig{
       std::move(importedBathGrid), acoustics::BathyInterpolationType::kLinear,
       false};
@@ -101,9 +129,44 @@ int main(int argc, char *argv[]) {
   auto sspConfig = acoustics::SSPConfig{std::move(importedSSPGrid), false};
 
   acoustics::AgentsConfig agents{{0, 0, 10}, {0, 0, 1}};
+  const int numBearingBeams =
+      config.numBearingBeams > 0 ? config.numBearingBeams : config.numBeams;
+  acoustics::BeamFanConfig beams{
+      {config.numBeams, numBearingBeams},
+      {config.maxBeams, config.maxBearingBeams > 0
+                            ? config.maxBearingBeams
+                            : std::max(numBearingBeams, config.maxBeams)},
+      config.beamSpreadDeg,
+      config.bearingSpreadDeg > 0.0 ? config.bearingSpreadDeg
+                                    : config.beamSpreadDeg};
+
+  if (config.bellhopMemoryMib == 0) {
+    // Fan-out groups are capped, so their largest run is known up front
+    const acoustics::BellhopMemoryDemand demand{
+        config.fanOutPerPinger ? config.fanOutMaxTargets : 1,
+        config.bellhopArrivalsPerReceiver};
+    const auto estimate = acoustics::AcousticsBuilder::estimateMemory(
+        sspConfig, bathConfig, beams, demand);
+    init.maxMemory = estimate.totalBytes();
+    constexpr double kMiB = 1024.0 * 1024.0;
+    SPDLOG_INFO("Bellhop memory per context: {:.1f} MiB (environment {:.1f}, "
+                "beams {:.3f}, receivers {:.3f}, arrivals {:.1f} for {} "
+                "receivers x {} slots)",
+                init.maxMemory / kMiB, estimate.environmentBytes / kMiB,
+                estimate.beamBytes / kMiB, estimate.receiverBytes / kMiB,
+                estimate.arrivalBytes / kMiB, estimate.receivers,
+                estimate.arrivalsPerReceiver);
+  }
+
+  auto context = acoustics::BhContext<true, true>(init);
+  // Full RunType: [0]=Arrivals [1]=Geometric [2-3]=unused [4]=Irregular grid
+  // [5]=3D
+  strcpy(context.params().Beam->RunType, "AG  I3");
+  strncpy(context.params().Title, config.runName.c_str(),
+          sizeof(context.params().Title) - 1);
+
   auto simBuilder = acoustics::AcousticsBuilder(
-      context.params(), bathConfig, sspConfig, agents, config.numBeams,
-      config.beamSpreadDeg, config.maxBeams);
+      context.params(), bathConfig, sspConfig, agents, beams);
   simBuilder.build();
 
   // Simulation setup
@@ -144,10 +207,59 @@ int main(int argc, char *argv[]) {
                                    ? sim::GlobalTofMode::kTwoWay
                                    : sim::GlobalTofMode::kOneWay;
 
-  sim::AcousticPairwiseRangeSystem rangeSystem(
-      simBuilder, context, tofMode, config.allowMultipath, false,
-      config.debugRangeErrorPct, config.outputDir);
+  sim::RangeSystemConfig rangeConfig{};
+  rangeConfig.mode = tofMode;
+  rangeConfig.allowMultipath = config.allowMultipath;
+  rangeConfig.debugRangeErrorPct = config.debugRangeErrorPct;
+  rangeConfig.debugOutputDir = config.outputDir;
+  rangeConfig.fanOutPerPinger = config.fanOutPerPinger;
+  rangeConfig.fanOutMaxTargets = config.fanOutMaxTargets;
+  rangeConfig.tofCacheToleranceM = config.tofCacheToleranceM;
+  rangeConfig.beamWarmStart = config.beamWarmStart;
+  rangeConfig.failureBackoffMaxPings = config.failureBackoffMaxPings;
+  if (config.beamRefinement == "nested") {
+    rangeConfig.beamRefinement = sim::BeamRefinement::kNested;
+  } else if (config.beamRefinement == "zoom") {
+    rangeConfig.beamRefinement = sim::BeamRefinement::kZoom;
+  }
+  rangeConfig.zoomWindowDeg = config.zoomWindowDeg;
+  rangeConfig.maxLinkRangeM = config.maxLinkRangeM;
+  rangeConfig.linkSkinM = config.linkSkinM;
+  if (config.linkSchedule == "tdma") {
+    rangeConfig.schedule = sim::LinkSchedule::kTdma;
+  } else if (config.linkSchedule == "random_k") {
+    rangeConfig.schedule = sim::LinkSchedule::kRandomK;
+  } else if (config.linkSchedule == "nearest_k") {
+    rangeConfig.schedule = sim::LinkSchedule::kNearestK;
+  }
+  rangeConfig.scheduleK = config.linkScheduleK;
+  rangeConfig.scheduleSeed = config.rngSeed;
+  rangeConfig.asyncPipeline = config.asyncPipeline;
+  rangeConfig.landmarkAtlas = config.landmarkAtlas;
+  rangeConfig.atlas = config.atlas;
+  rangeConfig.landmarkRayBundle = config.landmarkRayBundle;
+  rangeConfig.rayBundle = config.rayBundle;
+  rangeConfig.straightRayFastPath = config.straightRayFastPath;
+  rangeConfig.straightRay = config.straightRay;
+  rangeConfig.imageSourceModel = config.imageSourceModel;
+  rangeConfig.imageSource = config.imageSource;
+  rangeConfig.nx2dSlices = config.nx2dSlices;
+  rangeConfig.nx2d = config.nx2d;
+  rangeConfig.fidelity = config.fidelity;
+  rangeConfig.keyframes = config.keyframes;
+  rangeConfig.keyframe = config.keyframe;
+  rangeConfig.budget = config.budget;
+  rangeConfig.persistentTofCacheDir = config.persistentTofCacheDir;
+  rangeConfig.persistentTofCacheSlots = config.persistentTofCacheSlots;
+  sim::BellhopWorkerPool workerPool(simBuilder, context, init,
+                                   config.workerThreads);
+  if (config.nx2dSlices) {
+    workerPool.enableSlices(init);
+  }
+  sim::AcousticPairwiseRangeSystem rangeSystem(workerPool, rangeConfig);
   rangeSystem.rebuildPairs(world);
+  rangeSystem.buildLandmarkAtlases(world);
+  rangeSystem.buildLandmarkRayBundles(world);
 
   double boundsCheckInterval = config.boundsCheckIntervalSec;
   double pingInterval = config.pingIntervalMin * 60.0;
@@ -165,13 +277,30 @@ int main(int argc, char *argv[]) {
       nextBoundsCheck += boundsCheckInterval;
     }
     if (startTime >= nextPing) {
-      rangeSystem.update(startTime, world);
+      if (config.offlinePings) {
+        rangeSystem.recordPing(startTime, world);
+      } else if (config.asyncPipeline) {
+        rangeSystem.updateAsync(startTime, world);
+      } else {
+        rangeSystem.update(startTime, world);
+      }
       nextPing += pingInterval;
     }
   }
-  SPDLOG_INFO("Pairwise acoustic links: {}, measurements logged: {}",
-              rangeSystem.getLinks().size(),
-              rangeSystem.getMeasurements().size());
+  rangeSystem.flush();
+  if (config.offlinePings) {
+    rangeSystem.solveRecorded(config.shardIndex, config.shardCount);
+  }
+  // Debug ray traces are queued during the run to keep pings fast
+  rangeSystem.writeDebugDumps();
+  SPDLOG_INFO("Pairwise acoustic links: {} ({} active), measurements logged: "
+              "{}, skipped for dead endpoints: {} pinger / {} target",
+              rangeSystem.getLinks().size(), rangeSystem.getActiveLinkCount(),
+              rangeSystem.getMeasurements().size(),
+              rangeSystem.getDeadLinkSkips().pingerDead,
+              rangeSystem.getDeadLinkSkips().targetDead);
+  rangeSystem.logCacheStats();
+  workerPool.logMemoryUsage(init.maxMemory);
 
   // Write sensor CSVs
   for (size_t i = 0; i < robotIndices.size(); ++i) {
@@ -179,8 +308,12 @@ int main(int argc, char *argv[]) {
     rb::outputRobotSensorToCsv(csvBase.c_str(), *world.robots[robotIndices[i]]);
   }
 
-  // Write PFG factor graph file
-  auto pfgPath = (outDir / "output.pfg").string();
+  // Write PFG factor graph file; shards are combined later with pfg_merge
+  auto pfgPath =
+      (outDir / (config.shardCount > 1 ? pyfg::shardFileName(config.shardIndex,
+                                                             config.shardCount)
+                                       : "output.pfg"))
+          .string();
   pyfg::writePfg(pfgPath, world, rangeSystem.getMeasurements(), config.pfg);
 
   auto bellhopBase = (outDir / config.runName).string();
@@ -0,0 +1,30 @@
+// Combines the partial PFG files of a sharded run (mantaray_core --shard K/N)
+// into one factor graph.
+//
+// Usage: pfg_merge <output.pfg> <shard.pfg> [<shard.pfg> ...]
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "mantaray/utils/PfgMerge.h"
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <output.pfg> <shard.pfg> [<shard.pfg> ...]\n";
+    return 1;
+  }
+  const std::string outPath = argv[1];
+  const std::vector<std::string> shards(argv + 2, argv + argc);
+  try {
+    const size_t numRanges = pyfg::mergePfgShards(shards, outPath);
+    std::cout << "Merged " << shards.size() << " shards into " << outPath
+              << " (" << numRanges << " range edges)\n";
+  } catch (const std::exception &e) {
+    std::cerr << "pfg_merge: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
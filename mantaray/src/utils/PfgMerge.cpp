@@ -0,0 +1,93 @@
+//
+// PfgMerge.cpp
+//
+
+#include "mantaray/utils/PfgMerge.h"
+#include "mantaray/utils/PfgFormat.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+struct ShardLines {
+  std::vector<std::string> shared{};
+  std::vector<std::string> ranges{};
+};
+
+ShardLines readShard(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot open PFG shard: {}", path));
+  }
+  // Full token plus separator, so no longer token sharing the prefix matches
+  const std::string rangePrefix = std::string(pyfg::kEdgeRange) + ' ';
+  ShardLines lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    const bool isRange = line.rfind(rangePrefix, 0) == 0;
+    (isRange ? lines.ranges : lines.shared).push_back(std::move(line));
+  }
+  return lines;
+}
+
+// EDGE_RANGE <timestamp> ...
+double rangeTimestamp(const std::string &line) {
+  const size_t start = line.find(' ') + 1;
+  return std::stod(line.substr(start, line.find(' ', start) - start));
+}
+
+} // namespace
+
+namespace pyfg {
+
+std::string shardFileName(size_t index, size_t count) {
+  return fmt::format("output_shard_{}_of_{}.pfg", index, count);
+}
+
+size_t mergePfgShards(const std::vector<std::string> &shardPaths,
+                      const std::string &outPath) {
+  if (shardPaths.empty()) {
+    throw std::runtime_error("No PFG shards to merge");
+  }
+
+  const auto first = readShard(shardPaths.front());
+  std::vector<std::pair<double, std::string>> ranges;
+  for (size_t s = 0; s < shardPaths.size(); ++s) {
+    auto shard = s == 0 ? first : readShard(shardPaths[s]);
+    if (shard.shared != first.shared) {
+      throw std::runtime_error(
+          fmt::format("PFG shard {} does not match {} outside range edges; "
+                      "were both run from the same config?",
+                      shardPaths[s], shardPaths.front()));
+    }
+    for (auto &line : shard.ranges) {
+      const double t = rangeTimestamp(line);
+      ranges.emplace_back(t, std::move(line));
+    }
+  }
+  std::stable_sort(
+      ranges.begin(), ranges.end(),
+      [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  std::ofstream out(outPath);
+  if (!out) {
+    throw std::runtime_error(fmt::format("Cannot write PFG: {}", outPath));
+  }
+  for (const auto &line : first.shared) {
+    out << line << '\n';
+  }
+  for (const auto &[t, line] : ranges) {
+    out << line << '\n';
+  }
+  return ranges.size();
+}
+
+} // namespace pyfg
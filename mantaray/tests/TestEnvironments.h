@@ -0,0 +1,36 @@
+/** @file TestEnvironments.h
+ *  @brief Small analytic environments shared by the unit tests
+ */
+#pragma once
+#include "acoustics/SimulationConfig.h"
+
+#include <vector>
+
+namespace test_env {
+
+/// Sound speed at the surface of linearSsp() (m/s)
+constexpr double kSurfaceSoundSpeed = 1500.0;
+
+/// 2 km square, 200 m deep, c = kSurfaceSoundSpeed + gradient * z
+inline acoustics::SSPConfig linearSsp(double gradient) {
+  std::vector<double> xy{-1000.0, 0.0, 1000.0};
+  std::vector<double> z{0.0, 100.0, 200.0};
+  acoustics::Grid3D grid(xy, xy, z, kSurfaceSoundSpeed);
+  for (size_t ix = 0; ix < grid.nx(); ++ix) {
+    for (size_t iy = 0; iy < grid.ny(); ++iy) {
+      for (size_t iz = 0; iz < grid.nz(); ++iz) {
+        grid(ix, iy, iz) = kSurfaceSoundSpeed + gradient * z[iz];
+      }
+    }
+  }
+  return acoustics::SSPConfig{std::move(grid), false};
+}
+
+/// Flat seafloor at the given depth under the same 2 km square
+inline acoustics::BathymetryConfig flatBottom(double depth) {
+  return acoustics::BathymetryConfig{
+      acoustics::Grid2D({-1000.0, 1000.0}, {-1000.0, 1000.0}, depth),
+      acoustics::BathyInterpolationType::kLinear, false};
+}
+
+} // namespace test_env
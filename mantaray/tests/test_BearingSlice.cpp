@@ -0,0 +1,154 @@
+//
+// test_BearingSlice.cpp
+//
+
+#include "acoustics/BellhopContext.h"
+#include "acoustics/SliceBuilder.h"
+#include "mantaray/sim/MetricEnvironment.h"
+
+#include "TestEnvironments.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+using test_env::flatBottom;
+using test_env::linearSsp;
+
+// Same 2 km square, c = c0 + gradient * y at every depth
+acoustics::SSPConfig northwardSsp(double gradient) {
+  std::vector<double> xy{-1000.0, 0.0, 1000.0};
+  std::vector<double> z{0.0, 100.0, 200.0};
+  acoustics::Grid3D grid(xy, xy, z, test_env::kSurfaceSoundSpeed);
+  for (size_t ix = 0; ix < grid.nx(); ++ix) {
+    for (size_t iy = 0; iy < grid.ny(); ++iy) {
+      for (size_t iz = 0; iz < grid.nz(); ++iz) {
+        grid(ix, iy, iz) = test_env::kSurfaceSoundSpeed + gradient * xy[iy];
+      }
+    }
+  }
+  return acoustics::SSPConfig{std::move(grid), false};
+}
+
+void quietBellhop(const char * /*message*/) {}
+} // namespace
+
+TEST_CASE("MetricEnvironment samples a slice along the bearing",
+          "[bearingslice]") {
+  constexpr double kGradient = 0.1;
+  sim::MetricEnvironment env(linearSsp(kGradient), flatBottom(190.0));
+  const Eigen::Vector3d source{-500.0, 0.0, 20.0};
+  const Eigen::Vector3d receiver{300.0, 0.0, 100.0};
+
+  auto slice = env.bearingSlice(source, receiver, 100.0, 1200.0);
+  REQUIRE(slice);
+  REQUIRE(slice->rangesM.size() == 13);
+  CHECK(slice->rangesM.front() == 0.0);
+  CHECK(slice->rangesM.back() == Catch::Approx(1200.0));
+  CHECK(slice->depthsM == std::vector<double>{0.0, 100.0, 200.0});
+  REQUIRE(slice->speeds.size() == 3 * 13);
+  REQUIRE(slice->bottomDepthsM.size() == 13);
+  const size_t nr = slice->rangesM.size();
+  for (size_t iz = 0; iz < slice->depthsM.size(); ++iz) {
+    for (size_t ir = 0; ir < nr; ++ir) {
+      CHECK(slice->speeds[iz * nr + ir] ==
+            Catch::Approx(test_env::kSurfaceSoundSpeed +
+                          kGradient * slice->depthsM[iz]));
+    }
+  }
+  for (double depth : slice->bottomDepthsM) {
+    CHECK(depth == Catch::Approx(190.0));
+  }
+
+  // Clipped where the grids end, as long as the receiver is still covered
+  auto clipped = env.bearingSlice({0.0, 0.0, 20.0}, {900.0, 0.0, 50.0}, 100.0,
+                                  1500.0);
+  REQUIRE(clipped);
+  CHECK(clipped->rangesM.back() == Catch::Approx(900.0));
+  CHECK_FALSE(env.bearingSlice({0.0, 0.0, 20.0}, {1200.0, 0.0, 50.0}, 100.0,
+                               1500.0));
+
+  // Diagonal bearings step along the track, not along x
+  auto diagonal =
+      env.bearingSlice({0.0, 0.0, 20.0}, {300.0, 400.0, 50.0}, 100.0, 500.0);
+  REQUIRE(diagonal);
+  CHECK(diagonal->rangesM.back() == Catch::Approx(600.0));
+}
+
+TEST_CASE("MetricEnvironment measures the gradient across the bearing",
+          "[bearingslice]") {
+  constexpr double kGradient = 0.002;
+  sim::MetricEnvironment env(northwardSsp(kGradient), flatBottom(190.0));
+
+  // Depth-only profiles never vary across a bearing
+  sim::MetricEnvironment layered(linearSsp(0.1), flatBottom(190.0));
+  CHECK(layered.crossBearingGradient({-500.0, 0.0, 20.0}, {500.0, 0.0, 20.0},
+                                     50.0) == Catch::Approx(0.0));
+
+  // East-west tracks cross the northward gradient, north-south ones follow it
+  CHECK(env.crossBearingGradient({-500.0, 0.0, 20.0}, {500.0, 0.0, 20.0},
+                                 50.0) == Catch::Approx(kGradient));
+  CHECK(env.crossBearingGradient({0.0, -500.0, 20.0}, {0.0, 500.0, 20.0},
+                                 50.0) ==
+        Catch::Approx(0.0).margin(1.0e-12));
+  CHECK(env.crossBearingGradient({-300.0, -300.0, 20.0}, {300.0, 300.0, 20.0},
+                                 50.0) ==
+        Catch::Approx(kGradient * std::sqrt(0.5)));
+
+  // A vertical link has no bearing to be across
+  CHECK(env.crossBearingGradient({0.0, 0.0, 20.0}, {0.0, 0.0, 150.0}, 50.0) ==
+        0.0);
+}
+
+TEST_CASE("SliceBuilder loads a slice into a 2D context", "[bearingslice]") {
+  auto init = bhc::bhcInit();
+  init.FileRoot = nullptr;
+  init.prtCallback = quietBellhop;
+  init.outputCallback = quietBellhop;
+  init.maxMemory = size_t{16} << 20;
+  init.numThreads = 1;
+  acoustics::BhContext<false, false> context(init);
+  auto &params = context.params();
+  std::strcpy(params.Beam->RunType, "AG  I2");
+
+  sim::MetricEnvironment env(linearSsp(0.1), flatBottom(190.0));
+  const Eigen::Vector3d source{-500.0, 0.0, 40.0};
+  const Eigen::Vector3d receiver{300.0, 0.0, 40.0};
+  auto slice = env.bearingSlice(source, receiver, 100.0, 1200.0);
+  REQUIRE(slice);
+
+  constexpr int kBeams = 21;
+  constexpr double kSpreadRad = 0.2;
+  acoustics::SliceBuilder builder(params, kBeams, kSpreadRad);
+  builder.update(*slice, source.z(), 800.0, receiver.z());
+
+  const auto nr = static_cast<int32_t>(slice->rangesM.size());
+  const auto nz = static_cast<int32_t>(slice->depthsM.size());
+  CHECK(params.ssp->Nr == nr);
+  CHECK(params.ssp->NPts == nz);
+  for (int32_t i = 0; i < nr * nz; ++i) {
+    CHECK(params.ssp->cMat[i] == Catch::Approx(slice->speeds[i]));
+  }
+  CHECK(params.bdinfo->bot.NPts == nr);
+  CHECK(params.bdinfo->bot.bd[nr - 1].x.x == Catch::Approx(1200.0));
+  CHECK(params.bdinfo->bot.bd[0].x.y == Catch::Approx(190.0));
+
+  CHECK(params.Pos->Sz[0] == Catch::Approx(40.0));
+  CHECK(params.Pos->Rr[0] == Catch::Approx(800.0));
+  CHECK(params.Pos->Rz[0] == Catch::Approx(40.0));
+
+  // Level link: the fan is centred on the horizontal
+  REQUIRE(params.Angles->alpha.n == kBeams);
+  CHECK(params.Angles->alpha.angles[0] == Catch::Approx(-kSpreadRad));
+  CHECK(params.Angles->alpha.angles[kBeams - 1] == Catch::Approx(kSpreadRad));
+  CHECK(params.Beam->Box.x == Catch::Approx(1200.0));
+
+  // Same-sized slices reuse the context's arrays
+  const auto *speeds = params.ssp->cMat;
+  builder.update(*slice, 60.0, 700.0, 80.0);
+  CHECK(params.ssp->cMat == speeds);
+  CHECK(params.Pos->Rr[0] == Catch::Approx(700.0));
+}
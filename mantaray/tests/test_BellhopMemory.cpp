@@ -0,0 +1,56 @@
+//
+// test_BellhopMemory.cpp
+//
+
+#include "acoustics/AcousticsBuilder.h"
+#include "acoustics/BellhopMemory.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+acoustics::SSPConfig sspConfig() {
+  return {acoustics::Grid3D({0.0, 1000.0}, {0.0, 1000.0}, {0.0, 50.0, 100.0},
+                            1500.0),
+          false};
+}
+
+acoustics::BathymetryConfig bathymetryConfig() {
+  return {acoustics::Grid2D({0.0, 500.0, 1000.0}, {0.0, 500.0, 1000.0},
+                            100.0),
+          acoustics::BathyInterpolationType::kLinear, false};
+}
+} // namespace
+
+TEST_CASE("Bellhop memory scales with receivers, not rays",
+          "[bellhopmemory]") {
+  using acoustics::AcousticsBuilder;
+  const auto ssp = sspConfig();
+  const auto bathymetry = bathymetryConfig();
+  const auto fan = acoustics::BeamFanConfig::isotropic(80, 20.0, 180);
+
+  const auto single =
+      AcousticsBuilder::estimateMemory(ssp, bathymetry, fan, {});
+  CHECK(single.receivers == 1);
+  CHECK(single.arrivalsPerReceiver == acoustics::kDefaultArrivalsPerReceiver);
+  CHECK(single.arrivalBytes >=
+        acoustics::kDefaultArrivalsPerReceiver * sizeof(bhc::Arrival));
+  CHECK(single.totalBytes() > single.arrivalBytes +
+                                  acoustics::kBellhopOverheadBytes);
+
+  // A denser fan only needs longer launch angle arrays
+  const auto dense = AcousticsBuilder::estimateMemory(
+      ssp, bathymetry, acoustics::BeamFanConfig::isotropic(80, 20.0, 1000), {});
+  CHECK(dense.arrivalBytes == single.arrivalBytes);
+  CHECK(dense.beamBytes > single.beamBytes);
+
+  // A fan-out over four targets lays out up to 4^3 receivers
+  const auto fanOut =
+      AcousticsBuilder::estimateMemory(ssp, bathymetry, fan, {4, 50});
+  CHECK(fanOut.receivers == 64);
+  CHECK(fanOut.arrivalsPerReceiver == 50);
+  CHECK(fanOut.arrivalBytes >= 64 * 50 * sizeof(bhc::Arrival));
+  CHECK(fanOut.environmentBytes == single.environmentBytes);
+
+  // The budget for the worst case stays modest
+  CHECK(fanOut.totalBytes() < size_t{64} << 20);
+}
@@ -0,0 +1,78 @@
+//
+// test_FidelityScheduler.cpp
+//
+
+#include "mantaray/sim/FidelityScheduler.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("FidelityScheduler accepts engines within the budget",
+          "[fidelity]") {
+  sim::FidelityConfig config{};
+  CHECK_FALSE(sim::FidelityScheduler(config).enabled());
+
+  config.rangeErrorBudgetM = 0.5;
+  sim::FidelityScheduler scheduler(config);
+  REQUIRE(scheduler.enabled());
+  CHECK(scheduler.accepts(sim::TofEngine::kStraightRay, 0.4));
+  CHECK_FALSE(scheduler.accepts(sim::TofEngine::kStraightRay, 0.6));
+  CHECK(scheduler.accepts(sim::TofEngine::kBellhop3D, 100.0));
+
+  // 1e-3 1/s across 2 km at 1500 m/s bends the chord by ~0.15 mm
+  CHECK(sim::FidelityScheduler::sliceHeuristicM(1.0e-3, 1500.0, 2000.0) ==
+        Catch::Approx(8.0e9 / (1500.0 * 1500.0 * 1.0e6 * 24.0)));
+  CHECK(sim::FidelityScheduler::imageSourceHeuristicM(2.0, 1.0) ==
+        Catch::Approx(1.0));
+}
+
+TEST_CASE("FidelityScheduler calibrates from spot checks", "[fidelity]") {
+  sim::FidelityConfig config{};
+  config.rangeErrorBudgetM = 0.5;
+  config.spotCheckInterval = 4;
+  config.calibrationWeight = 0.5;
+  sim::FidelityScheduler scheduler(config);
+
+  // Links rotate through the interval
+  CHECK(scheduler.spotCheckDue(0, 0));
+  CHECK(scheduler.spotCheckDue(1, 3));
+  CHECK_FALSE(scheduler.spotCheckDue(1, 0));
+
+  // The heuristic said 0.3 m but 3D disagreed by 0.9 m: scale moves to 2
+  CHECK(scheduler.accepts(sim::TofEngine::kSlice, 0.3));
+  scheduler.calibrate(sim::TofEngine::kSlice, 0.3, 0.9);
+  CHECK(scheduler.scale(sim::TofEngine::kSlice) == Catch::Approx(2.0));
+  CHECK(scheduler.spotChecks(sim::TofEngine::kSlice) == 1);
+  CHECK(scheduler.predictedErrorM(sim::TofEngine::kSlice, 0.3) ==
+        Catch::Approx(0.6));
+  CHECK_FALSE(scheduler.accepts(sim::TofEngine::kSlice, 0.3));
+  // Other engines keep their own scale
+  CHECK(scheduler.scale(sim::TofEngine::kStraightRay) == Catch::Approx(1.0));
+
+  // Without a heuristic the floor stands in
+  scheduler.calibrate(sim::TofEngine::kLookup, 0.0, 0.0);
+  CHECK(scheduler.scale(sim::TofEngine::kLookup) == Catch::Approx(0.5));
+}
+
+TEST_CASE("FidelityScheduler rotates spot checks through rejected engines",
+          "[fidelity]") {
+  sim::FidelityConfig config{};
+  config.rangeErrorBudgetM = 0.5;
+  config.spotCheckInterval = 4;
+  config.calibrationWeight = 0.5;
+  sim::FidelityScheduler scheduler(config);
+
+  // Link 1 is due on pings 3, 7, 11, ... and visits each cheap engine once
+  CHECK(scheduler.rejectedSpotEngine(3, 1) == sim::TofEngine::kStraightRay);
+  CHECK(scheduler.rejectedSpotEngine(7, 1) == sim::TofEngine::kImageSource);
+  CHECK(scheduler.rejectedSpotEngine(11, 1) == sim::TofEngine::kSlice);
+  CHECK(scheduler.rejectedSpotEngine(15, 1) == sim::TofEngine::kLookup);
+
+  // One outlier locks the slice out; sampling it anyway lets it recover
+  scheduler.calibrate(sim::TofEngine::kSlice, 0.1, 1.0);
+  CHECK_FALSE(scheduler.accepts(sim::TofEngine::kSlice, 0.1));
+  for (int i = 0; i < 4; ++i) {
+    scheduler.calibrate(sim::TofEngine::kSlice, 0.1, 0.1);
+  }
+  CHECK(scheduler.accepts(sim::TofEngine::kSlice, 0.1));
+}
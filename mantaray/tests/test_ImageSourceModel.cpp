@@ -0,0 +1,72 @@
+//
+// test_ImageSourceModel.cpp
+//
+
+#include "mantaray/sim/ImageSourceModel.h"
+
+#include "TestEnvironments.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+namespace {
+constexpr double kSoundSpeed = test_env::kSurfaceSoundSpeed;
+using test_env::linearSsp;
+
+// 100 m deep, with a ridge rising to 20 m around x = 150
+acoustics::BathymetryConfig ridgeBottom() {
+  std::vector<double> x{-1000.0, 100.0, 150.0, 200.0, 1000.0};
+  std::vector<double> y{-1000.0, 1000.0};
+  std::vector<double> depths{100.0, 100.0, 100.0, 100.0, 20.0,
+                             20.0,  100.0, 100.0, 100.0, 100.0};
+  return acoustics::BathymetryConfig{
+      acoustics::Grid2D(std::move(x), std::move(y), std::move(depths)),
+      acoustics::BathyInterpolationType::kLinear, false};
+}
+} // namespace
+
+TEST_CASE("ImageSourceModel gives direct and bounced arrivals",
+          "[imagesource]") {
+  sim::ImageSourceModel model(linearSsp(0.0), ridgeBottom(),
+                              sim::ImageSourceConfig{});
+
+  // Clear of the ridge: the direct path is the fastest arrival
+  const Eigen::Vector3d source{-600.0, 0.0, 30.0};
+  const Eigen::Vector3d receiver{-100.0, 0.0, 70.0};
+  auto open = model.arrivals(source, receiver);
+  REQUIRE(open);
+  const double direct = (receiver - source).norm() / kSoundSpeed;
+  CHECK(open->directPath == Catch::Approx(direct));
+  CHECK(open->anyPath == Catch::Approx(direct));
+
+  // The ridge blocks the straight path; the surface bounce remains
+  const Eigen::Vector3d blockedSource{-400.0, 0.0, 50.0};
+  const Eigen::Vector3d blockedReceiver{300.0, 0.0, 50.0};
+  auto blocked = model.arrivals(blockedSource, blockedReceiver);
+  REQUIRE(blocked);
+  CHECK(blocked->directPath == acoustics::kNoArrival);
+  CHECK(blocked->anyPath ==
+        Catch::Approx(std::hypot(700.0, 100.0) / kSoundSpeed));
+
+  // Below the seafloor
+  CHECK_FALSE(model.arrivals(source, {-100.0, 0.0, 150.0}));
+}
+
+TEST_CASE("ImageSourceModel declines refracting water columns",
+          "[imagesource]") {
+  // 0.05 1/s over 100 m is a 5 m/s spread, above the 2 m/s default
+  sim::ImageSourceModel model(linearSsp(0.05), ridgeBottom(),
+                              sim::ImageSourceConfig{});
+  CHECK_FALSE(model.arrivals({-600.0, 0.0, 30.0}, {-100.0, 0.0, 70.0}));
+
+  sim::ImageSourceConfig loose{};
+  loose.maxSpeedSpreadMps = 10.0;
+  sim::ImageSourceModel tolerant(linearSsp(0.05), ridgeBottom(), loose);
+  auto pair = tolerant.arrivals({-600.0, 0.0, 30.0}, {-100.0, 0.0, 70.0});
+  REQUIRE(pair);
+  // Mean speed over the 100 m column is 1502.5 m/s
+  CHECK(pair->directPath ==
+        Catch::Approx(std::hypot(500.0, 40.0) / 1502.5));
+}
@@ -0,0 +1,62 @@
+//
+// test_KeyframeTrack.cpp
+//
+
+#include "mantaray/sim/KeyframeTrack.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+constexpr double kSoundSpeed = 1500.0;
+
+sim::KeyframeTrack::Keyframe uniform(double timeSec, double rangeM) {
+  return {timeSec, rangeM, static_cast<float>(rangeM / kSoundSpeed), false};
+}
+} // namespace
+
+TEST_CASE("KeyframeTrack predicts between keyframes", "[keyframes]") {
+  const sim::KeyframeConfig config{};
+  sim::KeyframeTrack track;
+  CHECK_FALSE(track.predict(0.0, 1000.0, config));
+
+  track.add(uniform(0.0, 1000.0));
+  CHECK_FALSE(track.predict(10.0, 1000.0, config));
+  track.add(uniform(60.0, 1200.0));
+  REQUIRE(track.size() == 2);
+  // Uniform water: TOF is exactly range over speed, inside and outside
+  for (double rangeM : {1100.0, 1300.0, 900.0}) {
+    auto prediction = track.predict(120.0, rangeM, config);
+    REQUIRE(prediction);
+    CHECK(prediction->tofRawSec == Catch::Approx(rangeM / kSoundSpeed));
+    CHECK(prediction->residualM == Catch::Approx(0.0).margin(1e-3));
+  }
+
+  // The newest keyframe is too old
+  CHECK_FALSE(track.predict(60.0 + config.maxIntervalSec + 1.0, 1100.0,
+                            config));
+}
+
+TEST_CASE("KeyframeTrack forces keyframes on residuals", "[keyframes]") {
+  const sim::KeyframeConfig config{};
+  sim::KeyframeTrack track;
+  track.add(uniform(0.0, 1000.0));
+  track.add(uniform(60.0, 1200.0));
+
+  // A solve 6 m of path long, measured at its own mean speed
+  const float slowTof = static_cast<float>(1206.0 / kSoundSpeed);
+  track.add({120.0, 1200.0, slowTof, false});
+  REQUIRE(track.lastResidualM());
+  CHECK(*track.lastResidualM() == Catch::Approx(6.0 * 1200.0 / 1206.0));
+  CHECK_FALSE(track.predict(130.0, 1200.0, config));
+
+  // Path type changed between keyframes
+  sim::KeyframeTrack switched;
+  switched.add(uniform(0.0, 1000.0));
+  switched.add({60.0, 1000.0, static_cast<float>(1000.0 / kSoundSpeed), true});
+  CHECK_FALSE(switched.predict(90.0, 1000.0, config));
+
+  track.reset();
+  CHECK(track.size() == 0);
+  CHECK_FALSE(track.lastResidualM());
+}
@@ -0,0 +1,119 @@
+//
+// test_LinkSchedule.cpp
+//
+
+#include "mantaray/sim/LinkSchedule.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+using sim::LinkSchedule;
+using sim::ScheduleCandidate;
+
+// Three pingers, each linked to the two others: link 2p + j
+std::vector<ScheduleCandidate> fullMesh() {
+  std::vector<ScheduleCandidate> candidates;
+  for (size_t pinger = 0; pinger < 3; ++pinger) {
+    for (size_t j = 0; j < 2; ++j) {
+      const double rangeM = 100.0 * static_cast<double>(2 - j);
+      candidates.push_back(ScheduleCandidate{2 * pinger + j, pinger, rangeM});
+    }
+  }
+  return candidates;
+}
+
+std::vector<size_t> firing(const std::vector<bool> &scheduled) {
+  std::vector<size_t> links;
+  for (size_t i = 0; i < scheduled.size(); ++i) {
+    if (scheduled[i]) {
+      links.push_back(i);
+    }
+  }
+  return links;
+}
+
+size_t firingOf(const std::vector<bool> &scheduled, size_t pinger) {
+  return static_cast<size_t>(std::count(scheduled.begin() + 2 * pinger,
+                                        scheduled.begin() + 2 * pinger + 2,
+                                        true));
+}
+} // namespace
+
+TEST_CASE("TDMA slots stay with their pinger", "[linkschedule]") {
+  std::mt19937_64 rng(0);
+  const auto all = fullMesh();
+  for (size_t ping = 0; ping < 6; ++ping) {
+    const auto scheduled = sim::selectScheduledLinks(LinkSchedule::kTdma, all,
+                                                     6, 3, ping, 1, rng);
+    const size_t slot = ping % 3;
+    CHECK(firing(scheduled) == std::vector<size_t>{2 * slot, 2 * slot + 1});
+  }
+
+  // Pinger 1 died: its slot idles and pinger 2 keeps slot 2
+  std::vector<ScheduleCandidate> survivors;
+  std::copy_if(all.begin(), all.end(), std::back_inserter(survivors),
+               [](const auto &c) { return c.pingerSlot != 1; });
+  CHECK(firing(sim::selectScheduledLinks(LinkSchedule::kTdma, survivors, 6, 3,
+                                         1, 1, rng))
+            .empty());
+  CHECK(firing(sim::selectScheduledLinks(LinkSchedule::kTdma, survivors, 6, 3,
+                                         2, 1, rng)) ==
+        std::vector<size_t>{4, 5});
+  CHECK(firing(sim::selectScheduledLinks(LinkSchedule::kTdma, survivors, 6, 3,
+                                         3, 1, rng)) ==
+        std::vector<size_t>{0, 1});
+}
+
+TEST_CASE("k schedules cap the links per pinger", "[linkschedule]") {
+  std::mt19937_64 rng(7);
+  const auto all = fullMesh();
+
+  const auto nearest = sim::selectScheduledLinks(LinkSchedule::kNearestK, all,
+                                                 6, 3, 0, 1, rng);
+  // The second target of each pinger is the nearer one
+  CHECK(firing(nearest) == std::vector<size_t>{1, 3, 5});
+
+  const auto random = sim::selectScheduledLinks(LinkSchedule::kRandomK, all, 6,
+                                                3, 0, 1, rng);
+  for (size_t pinger = 0; pinger < 3; ++pinger) {
+    CHECK(firingOf(random, pinger) == 1);
+  }
+
+  // A k above the pinger's candidates fires them all
+  const auto wide = sim::selectScheduledLinks(LinkSchedule::kRandomK, all, 6,
+                                              3, 0, 10, rng);
+  CHECK(firing(wide).size() == 6);
+
+  // Only candidates fire, even for all_pairs
+  const std::vector<ScheduleCandidate> one{all[3]};
+  CHECK(firing(sim::selectScheduledLinks(LinkSchedule::kAllPairs, one, 6, 3, 0,
+                                         1, rng)) == std::vector<size_t>{3});
+}
+
+TEST_CASE("random_k replays from its seed", "[linkschedule]") {
+  std::vector<ScheduleCandidate> candidates;
+  for (size_t i = 0; i < 40; ++i) {
+    candidates.push_back(ScheduleCandidate{i, i / 10, 0.0});
+  }
+  const auto draw = [&](uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::vector<bool>> pings;
+    for (size_t ping = 0; ping < 5; ++ping) {
+      pings.push_back(sim::selectScheduledLinks(
+          LinkSchedule::kRandomK, candidates, 40, 4, ping, 3, rng));
+    }
+    return pings;
+  };
+
+  const auto first = draw(42);
+  CHECK(draw(42) == first);
+  CHECK(draw(43) != first);
+  // Draws continue from the RNG, so pings differ from each other
+  CHECK(first[0] != first[1]);
+  for (const auto &scheduled : first) {
+    CHECK(firing(scheduled).size() == 12);
+  }
+}
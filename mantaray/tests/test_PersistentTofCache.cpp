@@ -0,0 +1,76 @@
+//
+// test_PersistentTofCache.cpp
+//
+
+#include "mantaray/sim/PersistentTofCache.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+
+namespace {
+const sim::TofBeamSettings kBeam{80, 180, 20.0, false};
+constexpr float kTof = 1.0f;
+constexpr double kTolerance = 10.0;
+constexpr uint64_t kEnvironment = 0x1234;
+
+std::filesystem::path freshDirectory() {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "mantaray_tofcache_test";
+  std::filesystem::remove_all(dir);
+  return dir;
+}
+} // namespace
+
+TEST_CASE("PersistentTofCache keeps solves across instances",
+          "[persistenttofcache]") {
+  const auto dir = freshDirectory();
+  const Eigen::Vector3d a{1.0, 1.0, 11.0};
+  const Eigen::Vector3d b{1501.0, 1.0, 11.0};
+  {
+    sim::PersistentTofCache cache(dir, kEnvironment, kTolerance, 64);
+    CHECK_FALSE(cache.lookup(a, b, kBeam));
+    cache.insert(a, b, kBeam, {kTof, true});
+    cache.insert(a, b, kBeam, {-1.0f, false});
+    CHECK(cache.size() == 1);
+    CHECK(cache.stats().inserts == 1);
+    CHECK(cache.stats().misses == 1);
+  }
+
+  // A later run, asking for a different capacity, reopens the same file
+  sim::PersistentTofCache reopened(dir, kEnvironment, kTolerance, 128);
+  CHECK(reopened.capacity() == 64);
+  CHECK(reopened.size() == 1);
+  // Reversed endpoints with the target 3 m further out
+  auto hit = reopened.lookup({1504.0, 1.0, 11.0}, a, kBeam);
+  REQUIRE(hit);
+  CHECK(hit->multipathUsed);
+  CHECK(hit->tofRawSec == Catch::Approx(kTof * 1503.0 / 1500.0));
+  CHECK(reopened.stats().hits == 1);
+
+  // Other beam settings never match
+  sim::TofBeamSettings denser = kBeam;
+  denser.maxBeams = 360;
+  CHECK_FALSE(reopened.lookup(a, b, denser));
+
+  // Another environment gets its own file
+  sim::PersistentTofCache other(dir, kEnvironment + 1, kTolerance, 64);
+  CHECK(other.path() != reopened.path());
+  CHECK(other.size() == 0);
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("PersistentTofCache drops inserts past the probe window",
+          "[persistenttofcache]") {
+  const auto dir = freshDirectory();
+  sim::PersistentTofCache cache(dir, kEnvironment, kTolerance, 4);
+  for (int i = 0; i < 6; ++i) {
+    const Eigen::Vector3d target{100.0 * (i + 1), 0.0, 5.0};
+    cache.insert({0.0, 0.0, 5.0}, target, kBeam, {kTof, false});
+  }
+  CHECK(cache.size() == 4);
+  CHECK(cache.stats().inserts == 4);
+  CHECK(cache.stats().dropped == 2);
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,76 @@
+//
+// test_PfgMerge.cpp
+//
+
+#include "mantaray/utils/PfgFormat.h"
+#include "mantaray/utils/PfgMerge.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+void writeLines(const std::string &path,
+                const std::vector<std::string> &lines) {
+  std::ofstream f(path);
+  for (const auto &l : lines) {
+    f << l << '\n';
+  }
+}
+
+std::vector<std::string> readLines(const std::string &path) {
+  std::ifstream f(path);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(f, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+const std::vector<std::string> kShared{
+    "VERTEX_SE3:QUAT 0.000000000 A0 0 0 0 0 0 0 1",
+    "VERTEX_XYZ L0 100 0 0",
+};
+} // namespace
+
+TEST_CASE("PFG shards merge into chronological range edges", "[pfgmerge]") {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto shard0 = (dir / pyfg::shardFileName(0, 2)).string();
+  const auto shard1 = (dir / pyfg::shardFileName(1, 2)).string();
+  const auto merged = (dir / "merged_test.pfg").string();
+  CHECK(pyfg::shardFileName(3, 8) == "output_shard_3_of_8.pfg");
+
+  // Round-robin epochs: shard 0 has t=1800 and t=5400, shard 1 has t=3600
+  auto lines0 = kShared;
+  lines0.push_back("EDGE_RANGE 1800.000000000 A1 L0 10.0 1.0");
+  lines0.push_back("EDGE_RANGE 1800.000000000 A1 B1 20.0 1.0");
+  lines0.push_back("EDGE_RANGE 5400.000000000 A3 L0 30.0 1.0");
+  auto lines1 = kShared;
+  lines1.push_back("EDGE_RANGE 3600.000000000 A2 L0 40.0 1.0");
+  writeLines(shard0, lines0);
+  writeLines(shard1, lines1);
+
+  // Argument order does not matter
+  CHECK(pyfg::mergePfgShards({shard1, shard0}, merged) == 4);
+  std::vector<std::string> expected = kShared;
+  expected.push_back("EDGE_RANGE 1800.000000000 A1 L0 10.0 1.0");
+  expected.push_back("EDGE_RANGE 1800.000000000 A1 B1 20.0 1.0");
+  expected.push_back("EDGE_RANGE 3600.000000000 A2 L0 40.0 1.0");
+  expected.push_back("EDGE_RANGE 5400.000000000 A3 L0 30.0 1.0");
+  CHECK(readLines(merged) == expected);
+
+  // Shards from different runs are rejected
+  lines1[1] = "VERTEX_XYZ L0 101 0 0";
+  writeLines(shard1, lines1);
+  CHECK_THROWS_AS(pyfg::mergePfgShards({shard0, shard1}, merged),
+                  std::runtime_error);
+  CHECK_THROWS_AS(pyfg::mergePfgShards({}, merged), std::runtime_error);
+
+  std::filesystem::remove(shard0);
+  std::filesystem::remove(shard1);
+  std::filesystem::remove(merged);
+}
@@ -0,0 +1,99 @@
+//
+// test_PingBudget.cpp
+//
+
+#include "mantaray/sim/PingBudget.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+using Clock = sim::PingBudget::Clock;
+} // namespace
+
+TEST_CASE("PingBudget without limits never runs out", "[pingbudget]") {
+  const sim::BudgetConfig config{};
+  CHECK_FALSE(config.enabled());
+  const auto start = Clock::now();
+  sim::PingBudget budget(config, start);
+  auto link = budget.startLink(start);
+  link.charge(1000000);
+  CHECK(budget.rays() == 1000000);
+  CHECK_FALSE(link.exhausted(start + std::chrono::hours(24)));
+}
+
+TEST_CASE("PingBudget stops links on their own and the ping's limits",
+          "[pingbudget]") {
+  sim::BudgetConfig config{};
+  config.pingSeconds = 10.0;
+  config.linkRays = 500;
+  REQUIRE(config.enabled());
+  const auto start = Clock::now();
+  sim::PingBudget budget(config, start);
+
+  auto first = budget.startLink(start);
+  first.charge(400);
+  CHECK_FALSE(first.exhausted(start));
+  first.charge(100);
+  CHECK(first.exhausted(start));
+  CHECK_FALSE(budget.exhausted(start));
+
+  // A fresh link has its own rays, but shares the ping's deadline
+  auto second = budget.startLink(start + std::chrono::seconds(5));
+  CHECK_FALSE(second.exhausted(start + std::chrono::seconds(9)));
+  CHECK(second.exhausted(start + std::chrono::seconds(10)));
+  CHECK(budget.exhausted(start + std::chrono::seconds(10)));
+  CHECK(budget.rays() == 500);
+}
+
+TEST_CASE("PingBudget counts rays across links", "[pingbudget]") {
+  sim::BudgetConfig config{};
+  config.pingRays = 1000;
+  config.linkSeconds = 2.0;
+  const auto start = Clock::now();
+  sim::PingBudget budget(config, start);
+
+  auto first = budget.startLink(start);
+  first.charge(600);
+  CHECK(first.exhausted(start + std::chrono::seconds(2)));
+  auto second = budget.startLink(start + std::chrono::seconds(2));
+  CHECK_FALSE(second.exhausted(start + std::chrono::seconds(3)));
+  second.charge(400);
+  CHECK(budget.exhausted(start));
+  CHECK(second.exhausted(start + std::chrono::seconds(3)));
+}
+
+TEST_CASE("PingBudget reservations fix each link's share up front",
+          "[pingbudget]") {
+  sim::BudgetConfig config{};
+  config.pingRays = 1000;
+  const auto start = Clock::now();
+  sim::PingBudget budget(config, start);
+
+  CHECK(budget.reserve(400));
+  CHECK(budget.reserve(400));
+  CHECK_FALSE(budget.reserve(400));
+  CHECK(budget.reserveUpTo(400) == 200);
+  CHECK(budget.reserveUpTo(400) == 0);
+
+  // An allowance replaces the ping's shared count: whichever link charges
+  // first, each stops at its own share
+  auto first = budget.startLink(600, start);
+  auto second = budget.startLink(400, start);
+  second.charge(300);
+  first.charge(700);
+  CHECK(budget.exhausted(start));
+  CHECK_FALSE(second.exhausted(start));
+  CHECK(first.exhausted(start));
+  second.charge(100);
+  CHECK(second.exhausted(start));
+
+  // Settled charges still count against later reservations
+  budget.settle();
+  CHECK_FALSE(budget.reserve(1));
+  CHECK(budget.reserveUpTo(10) == 0);
+
+  // Without a ray limit everything fits
+  sim::PingBudget unlimited(sim::BudgetConfig{}, start);
+  CHECK(unlimited.reserve(1000000));
+  CHECK(unlimited.reserveUpTo(1000000) == 1000000);
+}
@@ -0,0 +1,77 @@
+//
+// test_RayBundle.cpp
+//
+
+#include "mantaray/sim/RayBundle.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+namespace {
+constexpr double kSoundSpeed = 1500.0;
+const Eigen::Vector3d kSource{0.0, 0.0, 50.0};
+
+// Straight ray in uniform water, sampled every 5 m out to 2 km
+std::vector<sim::RayBundle::RayPoint> straightRay(double bearing,
+                                                  double elevation) {
+  const Eigen::Vector3d dir{std::cos(elevation) * std::cos(bearing),
+                            std::cos(elevation) * std::sin(bearing),
+                            std::sin(elevation)};
+  std::vector<sim::RayBundle::RayPoint> ray;
+  for (double s = 0.0; s <= 2000.0; s += 5.0) {
+    ray.push_back({kSource + s * dir, s / kSoundSpeed, 0});
+  }
+  return ray;
+}
+} // namespace
+
+TEST_CASE("RayBundle compresses rays and interpolates eigenrays",
+          "[raybundle]") {
+  sim::RayBundle bundle(sim::RayBundleConfig{2000.0, 25.0, 60.0});
+  // 1 deg apart on both axes: ~35 m between rays at 2 km
+  for (int b = -5; b <= 5; ++b) {
+    for (int e = -5; e <= 5; ++e) {
+      bundle.addRay(straightRay(b * M_PI / 180.0, e * M_PI / 180.0));
+    }
+  }
+  CHECK(bundle.numRays() == 121);
+  // 401 raw samples per ray compress to one point per 25-30 m
+  CHECK(bundle.numPoints() <= 121 * 81);
+  CHECK(bundle.numPoints() >= 121 * 67);
+
+  for (const Eigen::Vector3d &offset :
+       {Eigen::Vector3d{1500.0, 13.0, -7.0}, Eigen::Vector3d{800.0, -9.0, 4.0},
+        Eigen::Vector3d{1999.0, 20.0, 17.0}}) {
+    const Eigen::Vector3d receiver = kSource + offset;
+    auto pair = bundle.lookup(receiver);
+    const double expected = offset.norm() / kSoundSpeed;
+    // Well under a millisecond (1.5 m of range)
+    CHECK(pair.directPath == Catch::Approx(expected).margin(2e-4));
+    CHECK(pair.anyPath == Catch::Approx(expected).margin(2e-4));
+  }
+
+  // Outside the fan nothing brackets the receiver
+  auto miss = bundle.lookup(kSource + Eigen::Vector3d{0.0, 1000.0, 0.0});
+  CHECK(miss.directPath == acoustics::kNoArrival);
+  CHECK(miss.anyPath == acoustics::kNoArrival);
+}
+
+TEST_CASE("RayBundle keeps bounced segments out of the direct path",
+          "[raybundle]") {
+  sim::RayBundle bundle(sim::RayBundleConfig{1000.0, 25.0, 30.0});
+  // Horizontal ray that reflects (in name only) after 500 m
+  std::vector<sim::RayBundle::RayPoint> ray;
+  for (double s = 0.0; s <= 1000.0; s += 10.0) {
+    ray.push_back({kSource + Eigen::Vector3d{s, 0.0, 0.0}, s / kSoundSpeed,
+                   s > 500.0 ? 1 : 0});
+  }
+  bundle.addRay(ray);
+
+  auto before = bundle.lookup(kSource + Eigen::Vector3d{300.0, 5.0, 0.0});
+  CHECK(before.directPath == Catch::Approx(300.0 / kSoundSpeed));
+  auto after = bundle.lookup(kSource + Eigen::Vector3d{800.0, 5.0, 0.0});
+  CHECK(after.directPath == acoustics::kNoArrival);
+  CHECK(after.anyPath == Catch::Approx(800.0 / kSoundSpeed));
+}
@@ -0,0 +1,57 @@
+//
+// test_SpatialHash.cpp
+//
+
+#include "mantaray/sim/SpatialHash.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+#include <random>
+
+TEST_CASE("SpatialHash finds points within radius", "[spatialhash]") {
+  sim::SpatialHash hash(100.0);
+  hash.insert(0, Eigen::Vector3d{0.0, 0.0, 10.0});
+  hash.insert(1, Eigen::Vector3d{99.0, 0.0, 10.0});
+  hash.insert(2, Eigen::Vector3d{101.0, 0.0, 10.0});
+  hash.insert(3, Eigen::Vector3d{-60.0, -60.0, 10.0});
+  CHECK(hash.size() == 4);
+
+  auto ids = hash.query(Eigen::Vector3d{0.0, 0.0, 10.0}, 100.0);
+  std::vector<size_t> expected{0, 1, 3};
+  CHECK_THAT(ids, Catch::Matchers::Equals(expected));
+
+  // Radius is inclusive
+  ids = hash.query(Eigen::Vector3d{1.0, 0.0, 10.0}, 100.0);
+  expected = {0, 1, 2, 3};
+  CHECK_THAT(ids, Catch::Matchers::Equals(expected));
+
+  hash.clear();
+  CHECK(hash.size() == 0);
+  CHECK(hash.query(Eigen::Vector3d::Zero(), 1000.0).empty());
+}
+
+TEST_CASE("SpatialHash matches brute force for any radius", "[spatialhash]") {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> coord(-2000.0, 2000.0);
+  std::vector<Eigen::Vector3d> points;
+  sim::SpatialHash hash(250.0);
+  for (size_t i = 0; i < 200; ++i) {
+    points.emplace_back(coord(rng), coord(rng), coord(rng) * 0.05);
+    hash.insert(i, points.back());
+  }
+
+  // Radii below, at, and above the cell size
+  for (double radius : {100.0, 250.0, 700.0}) {
+    for (const auto &center : points) {
+      std::vector<size_t> expected;
+      for (size_t i = 0; i < points.size(); ++i) {
+        if ((points[i] - center).norm() <= radius) {
+          expected.push_back(i);
+        }
+      }
+      CHECK_THAT(hash.query(center, radius),
+                 Catch::Matchers::Equals(expected));
+    }
+  }
+}
@@ -0,0 +1,69 @@
+//
+// test_StraightRayEstimator.cpp
+//
+
+#include "mantaray/sim/StraightRayEstimator.h"
+
+#include "TestEnvironments.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+namespace {
+constexpr double kSurfaceSpeed = test_env::kSurfaceSoundSpeed;
+using test_env::flatBottom;
+using test_env::linearSsp;
+} // namespace
+
+TEST_CASE("StraightRayEstimator is exact in uniform water",
+          "[straightray]") {
+  sim::StraightRayEstimator estimator(linearSsp(0.0), flatBottom(190.0),
+                                      sim::StraightRayConfig{});
+  const Eigen::Vector3d source{-300.0, 100.0, 20.0};
+  const Eigen::Vector3d receiver{250.0, -150.0, 170.0};
+  auto estimate = estimator.estimate(source, receiver);
+  REQUIRE(estimate);
+  CHECK(estimate->tofSec ==
+        Catch::Approx((receiver - source).norm() / kSurfaceSpeed));
+  CHECK(estimate->errorSec < 1.0e-9);
+
+  // Through the seafloor, or out of the SSP grid
+  CHECK_FALSE(estimator.estimate(source, {250.0, -150.0, 195.0}));
+  CHECK_FALSE(estimator.estimate(source, {1200.0, 0.0, 50.0}));
+}
+
+TEST_CASE("StraightRayEstimator corrects for refraction in a gradient",
+          "[straightray]") {
+  // Strong gradient so the bend is well above the quadrature error
+  constexpr double kGradient = 0.5;
+  constexpr double kDepth = 100.0;
+  constexpr double kRange = 1500.0;
+  const double c1 = kSurfaceSpeed + kGradient * kDepth;
+  // Same-depth circular arc in a linear profile
+  const double exactSec =
+      2.0 / kGradient * std::asinh(kGradient * kRange / (2.0 * c1));
+  const Eigen::Vector3d source{-750.0, 0.0, kDepth};
+  const Eigen::Vector3d receiver{750.0, 0.0, kDepth};
+
+  sim::StraightRayConfig config{};
+  config.refractionCorrection = false;
+  sim::StraightRayEstimator straight(linearSsp(kGradient), flatBottom(300.0),
+                                     config);
+  auto plain = straight.estimate(source, receiver);
+  REQUIRE(plain);
+  // Fermat: the straight path is never faster than the ray
+  CHECK(plain->tofSec > exactSec);
+  CHECK(std::abs(plain->tofSec - exactSec) <= plain->errorSec);
+
+  config.refractionCorrection = true;
+  sim::StraightRayEstimator corrected(linearSsp(kGradient), flatBottom(300.0),
+                                      config);
+  auto bent = corrected.estimate(source, receiver);
+  REQUIRE(bent);
+  CHECK(std::abs(bent->tofSec - exactSec) <
+        0.1 * std::abs(plain->tofSec - exactSec));
+  CHECK(std::abs(bent->tofSec - exactSec) <= bent->errorSec);
+  CHECK(bent->errorSec < plain->errorSec);
+}
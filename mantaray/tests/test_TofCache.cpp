@@ -0,0 +1,73 @@
+//
+// test_TofCache.cpp
+//
+
+#include "mantaray/sim/TofCache.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+const sim::TofBeamSettings kBeam{80, 180, 20.0, false};
+constexpr float kTof = 1.0f;
+} // namespace
+
+TEST_CASE("TofCache disabled with non-positive tolerance", "[tofcache]") {
+  sim::TofCache cache(0.0);
+  CHECK_FALSE(cache.enabled());
+  Eigen::Vector3d a{0.0, 0.0, 10.0};
+  Eigen::Vector3d b{1500.0, 0.0, 10.0};
+  cache.insert(a, b, kBeam, {kTof, false});
+  CHECK(cache.size() == 0);
+  CHECK_FALSE(cache.lookup(a, b, kBeam).has_value());
+}
+
+TEST_CASE("TofCache hit applies geometric correction", "[tofcache]") {
+  sim::TofCache cache(10.0);
+  Eigen::Vector3d a{1.0, 1.0, 11.0};
+  Eigen::Vector3d b{1501.0, 1.0, 11.0};
+  cache.insert(a, b, kBeam, {kTof, true});
+
+  // Target drifts 3 m further along the line of sight, same cell
+  Eigen::Vector3d bMoved{1504.0, 1.0, 11.0};
+  auto hit = cache.lookup(a, bMoved, kBeam);
+  REQUIRE(hit.has_value());
+  CHECK(hit->multipathUsed);
+  CHECK(hit->tofRawSec == Catch::Approx(kTof * 1503.0 / 1500.0));
+}
+
+TEST_CASE("TofCache misses outside tolerance or cell", "[tofcache]") {
+  sim::TofCache cache(10.0);
+  Eigen::Vector3d a{1.0, 1.0, 11.0};
+  Eigen::Vector3d b{1501.0, 1.0, 11.0};
+  cache.insert(a, b, kBeam, {kTof, false});
+
+  // Different cell
+  CHECK_FALSE(cache.lookup(a, Eigen::Vector3d{1512.0, 1.0, 11.0}, kBeam));
+  // Different beam settings
+  auto otherBeam = kBeam;
+  otherBeam.numBeams = 100;
+  CHECK_FALSE(cache.lookup(a, b, otherBeam));
+  // Bearing axis settings count too
+  otherBeam = kBeam;
+  otherBeam.bearingSpreadDeg = 5.0;
+  CHECK_FALSE(cache.lookup(a, b, otherBeam));
+}
+
+TEST_CASE("TofCache serves the reciprocal direction", "[tofcache]") {
+  sim::TofCache cache(10.0);
+  Eigen::Vector3d a{1.0, 1.0, 11.0};
+  Eigen::Vector3d b{1501.0, 1.0, 11.0};
+  cache.insert(a, b, kBeam, {kTof, false});
+  auto hit = cache.lookup(b, a, kBeam);
+  REQUIRE(hit.has_value());
+  CHECK(hit->tofRawSec == Catch::Approx(kTof));
+}
+
+TEST_CASE("TofCache ignores failed solves", "[tofcache]") {
+  sim::TofCache cache(10.0);
+  Eigen::Vector3d a{1.0, 1.0, 11.0};
+  Eigen::Vector3d b{1501.0, 1.0, 11.0};
+  cache.insert(a, b, kBeam, {-1.0f, false});
+  CHECK(cache.size() == 0);
+}
@@ -0,0 +1,68 @@
+//
+// test_TofLadder.cpp
+//
+
+#include "mantaray/sim/TofLadder.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+acoustics::ArrivalPair bounced(float anyPath) {
+  acoustics::ArrivalPair arrivals;
+  arrivals.anyPath = anyPath;
+  return arrivals;
+}
+} // namespace
+
+TEST_CASE("Direct paths are accepted from any level", "[tofladder]") {
+  acoustics::ArrivalPair arrivals;
+  arrivals.directPath = 0.5f;
+  arrivals.anyPath = 0.5f;
+
+  sim::TofLadder zoomed(false);
+  const auto verdict = zoomed.addLevel(arrivals, false);
+  CHECK(verdict.accepted);
+  CHECK_FALSE(verdict.multipathUsed);
+  CHECK(verdict.tofRawSec == 0.5f);
+}
+
+TEST_CASE("Multipath needs two agreeing full-fan levels", "[tofladder]") {
+  sim::TofLadder ladder(true);
+  CHECK_FALSE(ladder.addLevel(bounced(0.7f), true).accepted);
+  CHECK(ladder.sawMultipath());
+
+  const auto verdict = ladder.addLevel(bounced(0.7f), true);
+  CHECK(verdict.accepted);
+  CHECK(verdict.multipathUsed);
+  CHECK(verdict.tofRawSec == 0.7f);
+
+  sim::TofLadder disallowed(false);
+  disallowed.addLevel(bounced(0.7f), true);
+  CHECK_FALSE(disallowed.addLevel(bounced(0.7f), true).accepted);
+}
+
+TEST_CASE("Zoomed levels never accept multipath", "[tofladder]") {
+  sim::TofLadder ladder(true);
+  CHECK_FALSE(ladder.addLevel(bounced(0.7f), true).accepted);
+
+  // The zoomed fans see the same bounce, or none at all
+  for (int zoom = 0; zoom < 3; ++zoom) {
+    const auto verdict = ladder.addLevel(bounced(0.7f), false);
+    CHECK_FALSE(verdict.accepted);
+    CHECK_FALSE(verdict.compared);
+  }
+  CHECK_FALSE(ladder.addLevel(acoustics::ArrivalPair{}, false).accepted);
+
+  // A faster zoomed bounce does not replace the full fan's value
+  ladder.addLevel(bounced(0.6f), false);
+  const auto verdict = ladder.addLevel(bounced(0.7f), true);
+  CHECK(verdict.accepted);
+  CHECK(verdict.tofRawSec == 0.7f);
+
+  // Zoom mode on its own never gets a second full-fan level
+  sim::TofLadder zoomOnly(true);
+  for (int zoom = 0; zoom < 3; ++zoom) {
+    CHECK_FALSE(zoomOnly.addLevel(bounced(0.7f), false).accepted);
+  }
+  CHECK_FALSE(zoomOnly.sawMultipath());
+}
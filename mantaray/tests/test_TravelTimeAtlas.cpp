@@ -0,0 +1,77 @@
+//
+// test_TravelTimeAtlas.cpp
+//
+
+#include "mantaray/sim/TravelTimeAtlas.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+namespace {
+constexpr double kSoundSpeed = 1500.0;
+const Eigen::Vector3d kSource{100.0, -50.0, 20.0};
+
+// Linear in range and depth, so trilinear lookups are exact
+float linearTof(double range, double depth) {
+  return static_cast<float>((range + 0.5 * depth) / kSoundSpeed);
+}
+} // namespace
+
+TEST_CASE("TravelTimeAtlas axes include both endpoints", "[atlas]") {
+  sim::AtlasGridConfig config{1000.0, 300.0, 10.0, 90.0};
+  auto axes = sim::TravelTimeAtlas::makeAxes(config, 5.0, 25.0);
+  CHECK(axes.bearingsDeg == std::vector<double>{-180.0, -90.0, 0.0, 90.0,
+                                                180.0});
+  // 1000 / 300 rounds up to 4 steps of 250 m
+  CHECK(axes.rangesM == std::vector<double>{0.0, 250.0, 500.0, 750.0, 1000.0});
+  CHECK(axes.depthsM == std::vector<double>{5.0, 15.0, 25.0});
+}
+
+TEST_CASE("TravelTimeAtlas interpolates and falls back", "[atlas]") {
+  sim::AtlasGridConfig config{1000.0, 100.0, 10.0, 30.0};
+  auto axes = sim::TravelTimeAtlas::makeAxes(config, 0.0, 50.0);
+  std::vector<acoustics::ArrivalPair> arrivals;
+  for (size_t ib = 0; ib < axes.bearingsDeg.size(); ++ib) {
+    for (double depth : axes.depthsM) {
+      for (double range : axes.rangesM) {
+        acoustics::ArrivalPair pair;
+        pair.anyPath = linearTof(range, depth);
+        // A shadow zone beyond 800 m has only multipath
+        pair.directPath = range > 800.0 ? acoustics::kNoArrival
+                                        : linearTof(range, depth);
+        arrivals.push_back(pair);
+      }
+    }
+  }
+  sim::TravelTimeAtlas atlas(kSource, axes, arrivals);
+  CHECK(atlas.size() == arrivals.size());
+  CHECK(atlas.directCells() ==
+        axes.bearingsDeg.size() * axes.depthsM.size() * 9);
+
+  // Off-grid in every direction, including across the +-180 deg seam
+  for (double angle : {0.3, 2.0, M_PI - 0.01, -M_PI + 0.01}) {
+    const double range = 437.0;
+    Eigen::Vector3d receiver =
+        kSource + Eigen::Vector3d{range * std::cos(angle),
+                                  range * std::sin(angle), 0.0};
+    receiver.z() = 33.0;
+    auto pair = atlas.lookup(receiver);
+    CHECK(pair.directPath == Catch::Approx(linearTof(range, 33.0)));
+    CHECK(pair.anyPath == Catch::Approx(linearTof(range, 33.0)));
+  }
+
+  // Cells bordering the shadow zone have no direct path to interpolate
+  Eigen::Vector3d shadow = kSource + Eigen::Vector3d{850.0, 0.0, 0.0};
+  shadow.z() = 20.0;
+  auto pair = atlas.lookup(shadow);
+  CHECK(pair.directPath == acoustics::kNoArrival);
+  CHECK(pair.anyPath == Catch::Approx(linearTof(850.0, 20.0)));
+
+  // Beyond the grid both paths fall back
+  Eigen::Vector3d far = kSource + Eigen::Vector3d{1200.0, 0.0, 0.0};
+  CHECK(atlas.lookup(far).anyPath == acoustics::kNoArrival);
+  Eigen::Vector3d deep = kSource + Eigen::Vector3d{100.0, 0.0, 60.0};
+  CHECK(atlas.lookup(deep).directPath == acoustics::kNoArrival);
+}
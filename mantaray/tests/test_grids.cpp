@@ -46,6 +46,22 @@ TEST_CASE_METHOD(GridTestsFixture, "Grid's within each other", "[grid]") {
   REQUIRE(isInsideResult == true);
 }
 
+TEST_CASE_METHOD(GridTestsFixture, "Grid clone is a deep copy", "[grid]") {
+  auto grid2D = get2DGrid();
+  auto clone2D = grid2D.clone();
+  clone2D.data[0] = 1.0;
+  clone2D.xCoords[1] = 5.0;
+  CHECK(grid2D.data[0] == 1500.0);
+  CHECK(grid2D.xCoords[1] == 1.0);
+  CHECK(clone2D.size() == grid2D.size());
+
+  auto grid3D = get3DGrid();
+  auto clone3D = grid3D.clone();
+  clone3D.data[0] = 1.0;
+  CHECK(grid3D.data[0] == 1500.0);
+  CHECK(clone3D.zCoords == grid3D.zCoords);
+}
+
 TEST_CASE_METHOD(GridTestsFixture, "Grid's not within each other", "[grid]") {
   // x plus case
   GridTestsFixture test = GridTestsFixture();
@@ -26,6 +26,40 @@ TEST_CASE("Linspace generates correct number of points", "[linspace]") {
   REQUIRE_THAT(result, Catch::Matchers::Equals(expected));
 }
 
+TEST_CASE("Strided linspace nests coarser levels exactly", "[linspace]") {
+  constexpr int kCoarse = 80;
+  constexpr int kFine = 2 * kCoarse - 1;
+  const double low = -0.35;
+  const double high = 0.35;
+  std::vector<double> coarse(kCoarse);
+  std::vector<double> fine(kFine);
+  acoustics::utils::unsafeSetupVector(coarse.data(), low, high, kCoarse);
+  acoustics::utils::unsafeSetupVector(fine.data(), low, high, kFine);
+
+  std::vector<double> even(kFine);
+  std::vector<double> odd(kFine);
+  int nEven = acoustics::utils::unsafeSetupStridedVector(even.data(), low,
+                                                         high, kFine, 0, 2);
+  int nOdd = acoustics::utils::unsafeSetupStridedVector(odd.data(), low, high,
+                                                        kFine, 1, 2);
+  REQUIRE(nEven == kCoarse);
+  REQUIRE(nOdd == kCoarse - 1);
+  for (int i = 0; i < kCoarse; ++i) {
+    // Bit-identical, so old rays are never retraced at a shifted angle
+    REQUIRE(even[i] == coarse[i]);
+    REQUIRE(even[i] == fine[2 * i]);
+  }
+  for (int i = 0; i < nOdd; ++i) {
+    REQUIRE(odd[i] == fine[2 * i + 1]);
+  }
+
+  std::vector<double> all(kFine);
+  int nAll = acoustics::utils::unsafeSetupStridedVector(all.data(), low, high,
+                                                        kFine, 0, 1);
+  REQUIRE(nAll == kFine);
+  REQUIRE_THAT(all, Catch::Matchers::Equals(fine));
+}
+
 TEST_CASE("Bounds checking on position", "[position]") {
   Eigen::Vector3d minBounds(0.0, 0.0, 0.0);
   Eigen::Vector3d maxBounds(100.0, 100.0, 100.0);